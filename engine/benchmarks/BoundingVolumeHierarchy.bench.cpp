@@ -0,0 +1,127 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+// Compares queries on a BoundingVolumeHierarchy of level walls to checking every wall, for the area, point and line of
+// sight queries a room makes each tick. Run on a Release build.
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "BoundingVolumeHierarchy.h"
+
+namespace {
+    constexpr size_t queryCount = 1024;
+    constexpr int repetitions = 20;
+
+    // Stops the compiler removing work whose results are never read
+    volatile size_t sink;
+
+    template<typename Function>
+    double measureNanosecondsPerQuery(Function&& function) {
+        function();
+        const auto start = std::chrono::steady_clock::now();
+        for (int repetition = 0; repetition < repetitions; repetition++) {
+            function();
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / (static_cast<double>(repetitions) * queryCount);
+    }
+
+    void report(const char* name, const double linear, const double hierarchy) {
+        std::printf("%-16s %10.1f ns %10.1f ns %8.2fx\n", name, linear, hierarchy, linear / hierarchy);
+    }
+}
+
+int main() {
+    std::mt19937 random(1);
+    std::uniform_real_distribution position(0.f, 4000.f);
+    std::uniform_real_distribution wallLength(20.f, 200.f);
+    std::uniform_real_distribution areaSize(10.f, 40.f);
+    std::uniform_real_distribution offset(-600.f, 600.f);
+
+    std::vector<Rectangle2F> areas(queryCount);
+    std::vector<Vector2F> points(queryCount);
+    std::vector<Line2f> lines(queryCount);
+    for (size_t index = 0; index < queryCount; index++) {
+        areas[index] = {position(random), position(random), areaSize(random), areaSize(random)};
+        points[index] = {position(random), position(random)};
+        // Lines of sight from each of a few players to the others around them, a screen or so away
+        const Vector2F start = index % 64 == 0 ? Vector2F(position(random), position(random)) : lines[index - 1].start;
+        lines[index] = {start, {start.x + offset(random), start.y + offset(random)}};
+    }
+
+    std::printf("%-16s %16s %16s %10s\n", "", "Linear scan", "Hierarchy", "Speedup");
+    for (const size_t wallCount: {64, 512, 4096}) {
+        // Thin horizontal and vertical walls, as level geometry is mostly made of
+        std::vector<Rectangle2F> walls(wallCount);
+        for (size_t index = 0; index < wallCount; index++) {
+            const bool horizontal = index % 2 == 0;
+            walls[index] = {position(random), position(random), horizontal ? wallLength(random) : 10.f,
+                            horizontal ? 10.f : wallLength(random)};
+        }
+
+        const auto buildStart = std::chrono::steady_clock::now();
+        const BoundingVolumeHierarchy hierarchy(walls);
+        const std::chrono::duration<double, std::micro> buildTime = std::chrono::steady_clock::now() - buildStart;
+        std::printf("%zu walls, built in %.1f us\n", wallCount, buildTime.count());
+
+        report("Area", measureNanosecondsPerQuery([&] {
+            size_t found = 0;
+            for (const Rectangle2F& area: areas) {
+                for (const Rectangle2F& wall: walls) found += wall.intersects(area);
+            }
+            sink = found;
+        }), measureNanosecondsPerQuery([&] {
+            size_t found = 0;
+            for (const Rectangle2F& area: areas) {
+                hierarchy.query(area, [&](uint32_t) { found++; });
+            }
+            sink = found;
+        }));
+
+        report("Point", measureNanosecondsPerQuery([&] {
+            size_t found = 0;
+            for (const Vector2F& point: points) {
+                for (const Rectangle2F& wall: walls) found += wall.contains(point);
+            }
+            sink = found;
+        }), measureNanosecondsPerQuery([&] {
+            size_t found = 0;
+            for (const Vector2F& point: points) {
+                hierarchy.queryPoint(point, [&](uint32_t) { found++; });
+            }
+            sink = found;
+        }));
+
+        const double linearSight = measureNanosecondsPerQuery([&] {
+            size_t blocked = 0;
+            for (const Line2f& line: lines) {
+                for (const Rectangle2F& wall: walls) {
+                    if (wall.intersects(line)) {
+                        blocked++;
+                        break;
+                    }
+                }
+            }
+            sink = blocked;
+        });
+        report("Line of sight", linearSight, measureNanosecondsPerQuery([&] {
+            size_t blocked = 0;
+            for (const Line2f& line: lines) blocked += hierarchy.intersectsAny(line);
+            sink = blocked;
+        }));
+
+        std::vector<uint64_t> mask((queryCount + 63) / 64);
+        report("Batched sight", linearSight, measureNanosecondsPerQuery([&] {
+            hierarchy.getLineIntersectionMask(lines, mask);
+            sink = static_cast<size_t>(mask[0]);
+        }));
+    }
+    return 0;
+}
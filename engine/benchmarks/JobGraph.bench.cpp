@@ -0,0 +1,63 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+// Measures how a JobGraph's parallel for over a CPU bound update scales with the number of threads working on it, from
+// the calling thread alone up to every hardware thread. Run on a Release build on an otherwise idle machine.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "JobGraph.h"
+
+namespace {
+    constexpr int runs = 5;
+
+    // Gets the time of the fastest of several runs of the graph, as the slower ones were held up by something else
+    double measureSeconds(JobGraph& graph) {
+        auto best = std::chrono::steady_clock::duration::max();
+        for (int run = 0; run < runs; run++) {
+            const auto start = std::chrono::steady_clock::now();
+            graph.run();
+            best = std::min(best, std::chrono::steady_clock::now() - start);
+        }
+        return std::chrono::duration<double>(best).count();
+    }
+}
+
+int main() {
+    std::vector<double> results(1 << 12);
+    const auto update = [&](const size_t begin, const size_t end) {
+        for (size_t index = begin; index < end; index++) {
+            double value = static_cast<double>(index);
+            for (int step = 0; step < 2000; step++) value = std::sqrt(value + step);
+            results[index] = value;
+        }
+    };
+
+    std::printf("%8s %12s %8s %11s\n", "Threads", "Time", "Speedup", "Efficiency");
+    const size_t maxThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    double singleThreadSeconds = 0.;
+    for (size_t threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2) {
+        // The thread calling run() works too, so a pool of N - 1 workers runs on N threads
+        WorkStealingPool pool(threadCount - 1);
+        JobGraph graph(&pool);
+        graph.addParallelFor(results.size(), 64, update);
+
+        const double seconds = measureSeconds(graph);
+        if (threadCount == 1) {
+            singleThreadSeconds = seconds;
+        }
+        const double speedup = singleThreadSeconds / seconds;
+        std::printf("%8zu %9.2f ms %7.2fx %10.0f%%\n", threadCount, seconds * 1000., speedup,
+                    100. * speedup / static_cast<double>(threadCount));
+    }
+    return 0;
+}
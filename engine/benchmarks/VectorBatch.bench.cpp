@@ -0,0 +1,116 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+// Compares the batch kernels in VectorBatch.h to the same work done one object at a time with the Vector2F and
+// Rectangle2F operators, over arrays the size of a busy room. Run on a Release build.
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "utils/VectorBatch.h"
+
+namespace {
+    constexpr size_t objectCount = 4096;
+    constexpr int repetitions = 2000;
+
+    // Stops the compiler removing work whose results are never read
+    volatile float sink;
+
+    template<typename Function>
+    double measureNanosecondsPerObject(Function&& function) {
+        function();
+        const auto start = std::chrono::steady_clock::now();
+        for (int repetition = 0; repetition < repetitions; repetition++) {
+            function();
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / (static_cast<double>(repetitions) * objectCount);
+    }
+
+    void report(const char* name, const double scalar, const double batch) {
+        std::printf("%-20s %8.3f ns %8.3f ns %6.2fx\n", name, scalar, batch, scalar / batch);
+    }
+}
+
+int main() {
+    std::mt19937 random(1);
+    std::uniform_real_distribution position(0.f, 1000.f);
+    std::uniform_real_distribution velocity(-10.f, 10.f);
+    std::uniform_real_distribution size(1.f, 20.f);
+
+    std::vector<Vector2F> positions(objectCount), velocities(objectCount);
+    std::vector<Rectangle2F> boxes(objectCount);
+    std::vector<float> positionsX(objectCount), positionsY(objectCount), velocitiesX(objectCount),
+        velocitiesY(objectCount), minX(objectCount), minY(objectCount), maxX(objectCount), maxY(objectCount),
+        distancesSquared(objectCount);
+    std::vector<uint64_t> mask((objectCount + 63) / 64);
+    std::vector<bool> overlaps(objectCount);
+    for (size_t index = 0; index < objectCount; index++) {
+        positions[index] = {position(random), position(random)};
+        velocities[index] = {velocity(random), velocity(random)};
+        boxes[index] = {position(random), position(random), size(random), size(random)};
+        positionsX[index] = positions[index].x;
+        positionsY[index] = positions[index].y;
+        velocitiesX[index] = velocities[index].x;
+        velocitiesY[index] = velocities[index].y;
+        minX[index] = boxes[index].x;
+        minY[index] = boxes[index].y;
+        maxX[index] = boxes[index].x + boxes[index].w;
+        maxY[index] = boxes[index].y + boxes[index].h;
+    }
+    const Vector2F point(500.f, 500.f);
+    const Rectangle2F area(400.f, 400.f, 200.f, 150.f);
+    constexpr float deltaTime = 1.f / 60.f;
+
+    std::printf("Batch kernels built for %s, %zu objects\n", getVectorBatchInstructionSet(), objectCount);
+    std::printf("%-20s %11s %11s %7s\n", "", "Operators", "Batch", "Speedup");
+
+    report("Integrate", measureNanosecondsPerObject([&] {
+        for (size_t index = 0; index < objectCount; index++) {
+            positions[index] += velocities[index] * deltaTime;
+        }
+        sink = positions[0].x;
+    }), measureNanosecondsPerObject([&] {
+        integratePositions(positionsX, positionsY, velocitiesX, velocitiesY, deltaTime);
+        sink = positionsX[0];
+    }));
+
+    report("Scale", measureNanosecondsPerObject([&] {
+        for (Vector2F& value: velocities) {
+            value *= 0.999f;
+        }
+        sink = velocities[0].x;
+    }), measureNanosecondsPerObject([&] {
+        scaleValues(velocitiesX, 0.999f);
+        scaleValues(velocitiesY, 0.999f);
+        sink = velocitiesX[0];
+    }));
+
+    report("Distance squared", measureNanosecondsPerObject([&] {
+        for (size_t index = 0; index < objectCount; index++) {
+            const Vector2F delta = positions[index] - point;
+            distancesSquared[index] = delta.dot(delta);
+        }
+        sink = distancesSquared[0];
+    }), measureNanosecondsPerObject([&] {
+        getDistancesSquared(positionsX, positionsY, point, distancesSquared);
+        sink = distancesSquared[0];
+    }));
+
+    report("Overlap mask", measureNanosecondsPerObject([&] {
+        for (size_t index = 0; index < objectCount; index++) {
+            overlaps[index] = boxes[index].intersects(area);
+        }
+        sink = overlaps[0] ? 1.f : 0.f;
+    }), measureNanosecondsPerObject([&] {
+        getOverlapMask(minX, minY, maxX, maxY, area, mask);
+        sink = static_cast<float>(mask[0]);
+    }));
+    return 0;
+}
@@ -15,6 +15,7 @@
 #define ABSTRACT_SERVER_H
 
 #include "XCube2d.h"
+#include "JobGraph.h"
 
 #include <cstdio>
 
@@ -28,12 +29,28 @@ protected:
     bool running;
     bool paused;
     double serverTime;
+    TickStats lastTickStats;
 
     virtual void update(float deltaTime) = 0;
 
+    /**
+     * @return The pool update() runs on, for splitting the work of an update into a JobGraph, or nullptr if there are
+     *         no worker threads
+     */
+    [[nodiscard]] WorkStealingPool* getWorkerPool() const { return roomManager->getWorkerPool(); }
+
 public:
     int runMainLoop();
 
+    [[nodiscard]] const TickStats& getLastTickStats() const { return lastTickStats; }
+
+    /**
+     * @return The number of the default room's current tick, the tick update() is running in, or 0 before the first
+     *         tick
+     * @see Room::getCurrentTick()
+     */
+    [[nodiscard]] uint64_t getCurrentTick() const;
+
 #ifdef __DEBUG
 private:
     void handleMouseEvents();
@@ -41,6 +58,8 @@ private:
 
 protected:
     /* Engine systems */
+    std::shared_ptr<RoomManager> roomManager;
+    // The network engine of the default room, whose game state is updated by update()
     std::shared_ptr<NetworkEngine> networkEngine;
 #ifdef __DEBUG
     std::shared_ptr<GraphicsEngine> graphicsEngine;
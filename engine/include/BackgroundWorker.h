@@ -0,0 +1,86 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef BACKGROUNDWORKER_H
+#define BACKGROUNDWORKER_H
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * Thread running the same job each time it is started, so the thread starting it can carry on with other work until it
+ * needs the job's results.
+ *
+ * The job is given once on construction, so starting it does not allocate. Only one run of the job is in flight at a
+ * time, and start() and wait() must be called from the same thread.
+ *
+ * Example usage:
+ * @code
+ * BackgroundWorker replication([this] { sendSnapshots(); });
+ * while (running) {
+ *     replication.wait();
+ *     simulate();
+ *     captureState();
+ *     replication.start();
+ * }
+ * @endcode
+ */
+class BackgroundWorker {
+public:
+    using Job = std::function<void()>;
+
+    /**
+     * Starts the thread, which waits until the job is started.
+     * @param job The job to run each time the worker is started
+     */
+    explicit BackgroundWorker(Job job);
+
+    /**
+     * Waits for the job to finish, discarding any exception it throws, and stops the thread.
+     */
+    ~BackgroundWorker();
+
+    BackgroundWorker(const BackgroundWorker&) = delete;
+    BackgroundWorker& operator=(const BackgroundWorker&) = delete;
+
+    /**
+     * Runs the job on the worker's thread.
+     * @throws std::runtime_error if the job is already running
+     */
+    void start();
+
+    /**
+     * Waits until the job has finished, does nothing if it is not running.
+     * @throws The exception thrown by the job, if any
+     */
+    void wait();
+
+    /**
+     * @return true if the job has been started and not yet waited for
+     */
+    [[nodiscard]] bool isRunning() const { return running_; }
+
+private:
+    Job job_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool started_{false};
+    bool finished_{false};
+    bool stopping_{false};
+    std::exception_ptr exception_{};
+    // Only accessed by the thread starting the job
+    bool running_{false};
+    // Declared last so that the thread starts after every other member is initialized
+    std::thread thread_;
+
+    void run();
+};
+
+#endif //BACKGROUNDWORKER_H
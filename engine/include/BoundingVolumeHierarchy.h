@@ -0,0 +1,191 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef BOUNDINGVOLUMEHIERARCHY_H
+#define BOUNDINGVOLUMEHIERARCHY_H
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "utils/GameMath.h"
+
+/**
+ * Bounding volume hierarchy over a fixed set of rectangles, for finding the rectangles touching an area, point or line
+ * without checking every one. Suited to static level geometry such as walls, which is built once when a level is
+ * loaded and queried every tick for collisions and line of sight.
+ *
+ * The tree is stored flat in one array in depth first order, so the first child of each node directly follows it and
+ * a query walks forwards through memory, and the rectangles are copied into the order of the leaves holding them.
+ * Rectangles are identified by their index in the set the hierarchy was built from.
+ *
+ * Every query gives the same results as checking each rectangle with Rectangle2F::contains() or
+ * Rectangle2F::intersects(), in an unspecified order.
+ *
+ * Example usage:
+ * @code
+ * const BoundingVolumeHierarchy walls(level.getWalls());
+ * if (!walls.intersectsAny(Line2f(shooter, target))) {
+ *     // The target is in sight
+ * }
+ * walls.query(player.getBounds(), [&](const uint32_t wall) { resolveCollision(player, level.getWalls()[wall]); });
+ * @endcode
+ */
+class BoundingVolumeHierarchy {
+public:
+    BoundingVolumeHierarchy() = default;
+
+    /**
+     * Builds the hierarchy, splitting each node at the median of its rectangles' centres along its longest axis.
+     * @param rectangles The rectangles to store
+     * @throws std::invalid_argument if there are more rectangles than can be indexed by a uint32_t
+     */
+    explicit BoundingVolumeHierarchy(std::span<const Rectangle2F> rectangles);
+
+    [[nodiscard]] size_t size() const { return indices_.size(); }
+
+    [[nodiscard]] bool empty() const { return indices_.empty(); }
+
+    /**
+     * Calls a function with the index of every rectangle intersecting an area, as Rectangle2F::intersects() decides.
+     * @param area The area to find the rectangles in
+     * @param visitor Function called with each rectangle's index
+     */
+    template<typename Visitor>
+    void query(const Rectangle2F& area, Visitor&& visitor) const {
+        const float areaMaxX = area.x + area.w;
+        const float areaMaxY = area.y + area.h;
+        traverse(
+            [&](const Node& node) {
+                return (node.minX < areaMaxX) & (area.x < node.maxX) & (node.minY < areaMaxY) & (area.y < node.maxY);
+            },
+            [&](const uint32_t item) {
+                if (rectangles_[item].intersects(area)) visitor(indices_[item]);
+                return false;
+            });
+    }
+
+    /**
+     * Calls a function with the index of every rectangle containing a point, including its edges.
+     * @param point The point to find the rectangles at
+     * @param visitor Function called with each rectangle's index
+     */
+    template<typename Visitor>
+    void queryPoint(const Vector2F& point, Visitor&& visitor) const {
+        traverse(
+            [&](const Node& node) {
+                return (node.minX <= point.x) & (point.x <= node.maxX)
+                    & (node.minY <= point.y) & (point.y <= node.maxY);
+            },
+            [&](const uint32_t item) {
+                if (rectangles_[item].contains(point)) visitor(indices_[item]);
+                return false;
+            });
+    }
+
+    /**
+     * Calls a function with the index of every rectangle a line segment touches, as Rectangle2F::intersects() decides.
+     * @param line The segment to find the rectangles on
+     * @param visitor Function called with each rectangle's index
+     */
+    template<typename Visitor>
+    void queryLine(const Line2f& line, Visitor&& visitor) const {
+        const Segment segment(line);
+        traverse(
+            [&](const Node& node) { return segment.overlaps(node); },
+            [&](const uint32_t item) {
+                if (rectangles_[item].intersects(line)) visitor(indices_[item]);
+                return false;
+            });
+    }
+
+    /**
+     * Checks whether a line segment touches any of the rectangles, stopping at the first one found, for line of sight
+     * checks.
+     * @param line The segment to check
+     * @return true if the segment touches a rectangle
+     */
+    [[nodiscard]] bool intersectsAny(const Line2f& line) const;
+
+    /**
+     * Checks many line segments against the rectangles, as intersectsAny() would check each one, such as the lines of
+     * sight from one player to every other.
+     *
+     * @param lines The segments to check
+     * @param mask Receives one bit per segment, set if it touches a rectangle, laid out as by getOverlapMask()
+     * @throws std::invalid_argument if mask holds fewer than (lines + 63) / 64 words
+     */
+    void getLineIntersectionMask(std::span<const Line2f> lines, std::span<uint64_t> mask) const;
+
+private:
+    /**
+     * A node of the tree and the bounds of every rectangle below it. A leaf holds the count rectangles from first,
+     * any other node has a count of 0, its first child directly after it and its second child at first.
+     */
+    struct Node {
+        float minX, minY, maxX, maxY;
+        uint32_t first;
+        uint32_t count;
+    };
+
+    /**
+     * A line segment prepared for testing against many nodes, using the same arithmetic as
+     * Rectangle2F::intersects(const Line2f&) so that a node is never missed when a rectangle below it is touched.
+     */
+    struct Segment {
+        Vector2F start;
+        Vector2F scale;
+        bool parallelX;
+        bool parallelY;
+
+        explicit Segment(const Line2f& line);
+
+        [[nodiscard]] bool overlaps(const Node& node) const;
+    };
+
+    // Deeper than any tree built by median splits of up to 2^32 rectangles
+    static constexpr size_t maxDepth = 64;
+
+    std::vector<Node> nodes_{};
+    std::vector<Rectangle2F> rectangles_{};
+    std::vector<uint32_t> indices_{};
+
+    /**
+     * Walks the tree depth first, calling leafVisitor with the position of each rectangle in every leaf accepted by
+     * nodeTest, and stopping early if it returns true.
+     * @return true if leafVisitor stopped the walk
+     */
+    template<typename NodeTest, typename LeafVisitor>
+    bool traverse(NodeTest&& nodeTest, LeafVisitor&& leafVisitor) const {
+        if (nodes_.empty()) {
+            return false;
+        }
+        std::array<uint32_t, maxDepth> stack;
+        size_t stackSize = 0;
+        uint32_t current = 0;
+        while (true) {
+            const Node& node = nodes_[current];
+            if (nodeTest(node)) {
+                if (node.count == 0) {
+                    stack[stackSize++] = node.first;
+                    current++;
+                    continue;
+                }
+                for (uint32_t item = node.first; item < node.first + node.count; item++) {
+                    if (leafVisitor(item)) return true;
+                }
+            }
+            if (stackSize == 0) {
+                return false;
+            }
+            current = stack[--stackSize];
+        }
+    }
+};
+
+#endif //BOUNDINGVOLUMEHIERARCHY_H
@@ -0,0 +1,160 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef CLIENTCOMMAND_H
+#define CLIENTCOMMAND_H
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <msgpack.hpp>
+
+#include "NetworkProtocol.h"
+#include "Replicatable.h"
+
+/**
+ * Type alias for the sequence number of a client command.
+ * Sequence numbers must increase for each command of the same type sent by a client, gaps are allowed.
+ */
+using CommandSequence = uint32_t;
+
+/**
+ * Interface for a queue of decoded client commands of a single type.
+ *
+ * Each connected client has its own fixed-capacity queue of preallocated commands which incoming commands are unpacked
+ * into, so decoding a command does not allocate once the client's queue exists.
+ *
+ * @see ClientCommandChannel, NetworkEngine::registerClientCommand
+ */
+class IClientCommandChannel {
+public:
+    virtual ~IClientCommandChannel() = default;
+
+    /**
+     * Creates the command queue for a client.
+     * @param clientId The client to create the queue for
+     */
+    virtual void addClient(ClientId clientId) = 0;
+
+    /**
+     * Destroys the command queue for a client, discarding any commands not yet applied.
+     * @param clientId The client to destroy the queue for
+     */
+    virtual void removeClient(ClientId clientId) = 0;
+
+    /**
+     * Unpacks a command into the next free slot of the client's queue.
+     *
+     * Commands with a sequence number not greater than the last command accepted from the client are stale or
+     * duplicated and are discarded, as are commands from clients without a queue or whose queue is full.
+     *
+     * @param clientId The client the command was received from
+     * @param sequence The sequence number of the command
+     * @param payload The msgpack object containing the serialized command
+     * @return true if the command was queued, false if it was discarded
+     * @throws msgpack::type_error if the payload does not match the command
+     */
+    virtual bool enqueue(ClientId clientId, CommandSequence sequence, const msgpack::object& payload) = 0;
+
+    /**
+     * Applies the oldest queued command from a client and removes it from the queue.
+     *
+     * The engine calls this once for each command enqueue() accepted, interleaved with the other channels in the order
+     * the commands were received.
+     *
+     * @param clientId The client to apply the command for
+     */
+    virtual void applyNext(ClientId clientId) = 0;
+};
+
+/**
+ * Queue of decoded client commands of type Command, applied through a handler at the start of each tick.
+ *
+ * Requirements for Command:
+ * 1. Must define a public static constexpr typeId member with a unique string identifier, as for Replicated classes:
+ *    @code
+ *    static constexpr TypeId typeId{"UniqueCommand"};
+ *    @endcode
+ *
+ * 2. Must be default constructible and implement msgpack deserialization using the MSGPACK_DEFINE macro. Commands are
+ *    unpacked in place into reused instances, so members keep any storage they allocated for earlier commands.
+ *
+ * @tparam Command The type of command held by this channel
+ */
+template<typename Command>
+class ClientCommandChannel final : public IClientCommandChannel {
+public:
+    using Handler = std::function<void(ClientId, const Command&)>;
+
+    /**
+     * @param handler Function called with each command when it is applied
+     * @param capacity The maximum number of commands queued per client between ticks
+     */
+    ClientCommandChannel(Handler handler, const size_t capacity)
+        : handler_(std::move(handler))
+        , capacity_(capacity) {
+        if (capacity_ == 0) {
+            throw std::invalid_argument("Client command queue capacity must be greater than 0");
+        }
+    }
+
+    void addClient(const ClientId clientId) override {
+        queues_.try_emplace(clientId, capacity_);
+    }
+
+    void removeClient(const ClientId clientId) override {
+        queues_.erase(clientId);
+    }
+
+    bool enqueue(const ClientId clientId, const CommandSequence sequence, const msgpack::object& payload) override {
+        const auto queue = queues_.find(clientId);
+        if (queue == queues_.end()) {
+            return false;
+        }
+        auto& [commands, head, count, lastSequence, hasSequence] = queue->second;
+        if ((hasSequence && sequence <= lastSequence) || count == commands.size()) {
+            return false;
+        }
+
+        payload.convert(commands[(head + count) % commands.size()]);
+        count++;
+        lastSequence = sequence;
+        hasSequence = true;
+        return true;
+    }
+
+    void applyNext(const ClientId clientId) override {
+        const auto queue = queues_.find(clientId);
+        if (queue == queues_.end() || queue->second.count == 0) {
+            return;
+        }
+        auto& [commands, head, count, lastSequence, hasSequence] = queue->second;
+        const Command& command = commands[head];
+        head = (head + 1) % commands.size();
+        count--;
+        handler_(clientId, command);
+    }
+
+private:
+    // Ring buffer of preallocated commands
+    struct CommandQueue {
+        explicit CommandQueue(const size_t capacity) : commands(capacity) {}
+
+        std::vector<Command> commands;
+        size_t head{0};
+        size_t count{0};
+        CommandSequence lastSequence{0};
+        bool hasSequence{false};
+    };
+
+    Handler handler_;
+    size_t capacity_;
+    std::unordered_map<ClientId, CommandQueue> queues_;
+};
+
+#endif //CLIENTCOMMAND_H
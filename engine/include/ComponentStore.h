@@ -0,0 +1,187 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef COMPONENTSTORE_H
+#define COMPONENTSTORE_H
+
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "NetworkEngine.h"
+
+/**
+ * Structure-of-arrays store of replicated entities, keeping each component in its own dense array.
+ *
+ * Entities are stored densely, with each component of an entity at the same index in its component's array, so game
+ * updates and serialization stream through contiguous memory rather than following a pointer per object. Destroying
+ * an entity moves the last entity into its place, so the order of entities is not stable.
+ *
+ * The store registers itself with a NetworkEngine on construction and each entity is given an instance ID by it, unique
+ * among every object and entity the engine replicates. Entities are serialized as an array of their components in
+ * order, the same as a Replicated class with MSGPACK_DEFINE(component1, component2...), so every component type must
+ * be serializable by msgpack.
+ *
+ * Example usage:
+ * @code
+ * enum AsteroidComponent { Position, Velocity, Health };
+ * ComponentStore<Vector2F, Vector2F, float> asteroids(networkEngine, "Asteroid");
+ * asteroids.create({0.f, 0.f}, {1.f, 0.f}, 100.f);
+ *
+ * auto positions = asteroids.getComponents<Position>();
+ * auto velocities = asteroids.getComponents<Velocity>();
+ * for (size_t i = 0; i < asteroids.size(); i++) {
+ *     positions[i] += velocities[i] * deltaTime;
+ * }
+ * @endcode
+ *
+ * @tparam Components The type of each component of the entities
+ */
+template<typename... Components>
+class ComponentStore final : public IReplicatedStore {
+    static_assert((!std::is_same_v<Components, bool> && ...),
+        "std::vector<bool> is not contiguous, store bool components as uint8_t instead");
+public:
+    using EntityId = InstanceId;
+
+    template<size_t Index>
+    using Component = std::tuple_element_t<Index, std::tuple<Components...>>;
+
+    /**
+     * Constructs an empty store and registers it with the provided network engine.
+     * @param networkEngine Reference to the network engine that will replicate the entities
+     * @param typeId The unique type identifier the entities are serialized under
+     * @throws std::runtime_error if typeId is already used by other replicated objects
+     */
+    ComponentStore(NetworkEngine& networkEngine, const TypeId typeId)
+        : networkEngine_(networkEngine)
+        , typeId_(typeId) {
+        networkEngine_.registerReplicatedStore(this);
+    }
+
+    /**
+     * Destructor that automatically unregisters the store from the network engine, releasing the entities' instance IDs.
+     */
+    ~ComponentStore() override {
+        networkEngine_.unregisterReplicatedStore(this);
+        for (const EntityId entity: entities_) {
+            networkEngine_.releaseInstanceId(entity);
+        }
+    }
+
+    ComponentStore(const ComponentStore&) = delete;
+    ComponentStore& operator=(const ComponentStore&) = delete;
+
+    /**
+     * Creates an entity.
+     * @param components The initial value of each of the entity's components
+     * @return The instance ID of the entity
+     */
+    EntityId create(Components... components) {
+        const EntityId entity = networkEngine_.allocateInstanceId();
+        indices_.emplace(entity, entities_.size());
+        entities_.push_back(entity);
+        [&]<size_t... Indices>(std::index_sequence<Indices...>) {
+            (std::get<Indices>(components_).push_back(std::move(components)), ...);
+        }(std::index_sequence_for<Components...>{});
+        return entity;
+    }
+
+    /**
+     * Destroys an entity, moving the last entity into its place and releasing its instance ID to be reused. Does
+     * nothing if the entity is not in the store.
+     * @param entity The entity to destroy
+     */
+    void destroy(const EntityId entity) {
+        const auto index = indices_.find(entity);
+        if (index == indices_.end()) {
+            return;
+        }
+
+        const size_t removed = index->second;
+        indices_.erase(index);
+        networkEngine_.releaseInstanceId(entity);
+        if (removed != entities_.size() - 1) {
+            entities_[removed] = entities_.back();
+            indices_[entities_[removed]] = removed;
+        }
+        entities_.pop_back();
+        std::apply([removed](auto&... components) {
+            ((components[removed] = std::move(components.back()), components.pop_back()), ...);
+        }, components_);
+    }
+
+    [[nodiscard]] bool contains(const EntityId entity) const { return indices_.contains(entity); }
+
+    [[nodiscard]] size_t size() const override { return entities_.size(); }
+
+    [[nodiscard]] TypeId getTypeId() const override { return typeId_; }
+
+    /**
+     * Reserves space for a number of entities, so creating that many does not reallocate.
+     * @param capacity The number of entities to reserve space for
+     */
+    void reserve(const size_t capacity) {
+        entities_.reserve(capacity);
+        indices_.reserve(capacity);
+        std::apply([capacity](auto&... components) { (components.reserve(capacity), ...); }, components_);
+    }
+
+    /**
+     * Gets a component of an entity.
+     * @tparam Index The index of the component in Components
+     * @param entity The entity to get the component of
+     * @return Reference to the component, valid until an entity is created or destroyed
+     * @throws std::invalid_argument if the entity is not in the store
+     */
+    template<size_t Index>
+    [[nodiscard]] Component<Index>& get(const EntityId entity) {
+        const auto index = indices_.find(entity);
+        if (index == indices_.end()) {
+            throw std::invalid_argument("Entity is not in the component store");
+        }
+        return std::get<Index>(components_)[index->second];
+    }
+
+    /**
+     * Gets the dense array of a component of every entity, in the same order as getEntities().
+     * @tparam Index The index of the component in Components
+     * @return The components, valid until an entity is created or destroyed
+     */
+    template<size_t Index>
+    [[nodiscard]] std::span<Component<Index>> getComponents() { return std::get<Index>(components_); }
+
+    template<size_t Index>
+    [[nodiscard]] std::span<const Component<Index>> getComponents() const { return std::get<Index>(components_); }
+
+    [[nodiscard]] std::span<const EntityId> getEntities() const { return entities_; }
+
+    void pack(msgpack::packer<msgpack::sbuffer>& packer) const override {
+        packer.pack_map(static_cast<uint32_t>(entities_.size()));
+        for (size_t index = 0; index < entities_.size(); index++) {
+            packer.pack(entities_[index]);
+            packer.pack_array(static_cast<uint32_t>(sizeof...(Components)));
+            std::apply([&packer, index](const auto&... components) {
+                (packer.pack(components[index]), ...);
+            }, components_);
+        }
+    }
+
+private:
+    NetworkEngine& networkEngine_;
+    TypeId typeId_;
+
+    std::vector<EntityId> entities_{};
+    std::tuple<std::vector<Components>...> components_{};
+    std::unordered_map<EntityId, size_t> indices_{};
+};
+
+#endif //COMPONENTSTORE_H
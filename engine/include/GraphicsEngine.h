@@ -70,6 +70,15 @@ inline SDL_Color toSDLColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
     return color;
 }
 
+// GameMath does not depend on SDL so the server can use it without SDL, the conversions to SDL's types live here
+inline SDL_Rect toSDLRect(const Rectangle2I& rect) {
+    return { rect.x, rect.y, rect.w, rect.h };
+}
+
+inline SDL_FRect toSDLFRect(const Rectangle2F& rect) {
+    return { rect.x, rect.y, rect.w, rect.h };
+}
+
 class GraphicsEngine
 {
     friend class XCube2Engine;
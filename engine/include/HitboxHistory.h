@@ -0,0 +1,140 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef HITBOXHISTORY_H
+#define HITBOXHISTORY_H
+
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "InstanceId.h"
+#include "utils/GameMath.h"
+
+/**
+ * The hitboxes of every entity over the last few ticks, for lag compensation: evaluating a client's shot against the
+ * entities where that client saw them, rather than where they are when the shot reaches the server.
+ *
+ * The history is a ring of frames, one per tick, each holding the hitbox of every entity at that tick in one array
+ * indexed by a slot per entity, so checking a shot reads one contiguous array. Frames are reused once they are older
+ * than the history's length, so recording does not allocate once every entity has a slot.
+ *
+ * Example usage:
+ * @code
+ * // In the update handler, after moving the entities
+ * const uint64_t tick = room.getCurrentTick();
+ * for (const auto& [entity, player]: players) history.record(tick, entity, player.getHitbox());
+ *
+ * // For a shot from a client who saw the world as it was at shotTick
+ * history.queryLine(shotTick, shot, [&](const InstanceId entity, const Rectangle2F&) { applyDamage(entity); });
+ * @endcode
+ *
+ * @see Room::getCurrentTick() for the tick number of the room's current tick
+ */
+class HitboxHistory {
+public:
+    /**
+     * @param tickCount The number of ticks to keep hitboxes for, rounded up to a power of two, long enough to cover the
+     *                  highest latency that shots are compensated for
+     */
+    explicit HitboxHistory(size_t tickCount);
+
+    /**
+     * Records the hitbox of an entity at a tick, replacing any hitbox already recorded for it at that tick.
+     *
+     * Recording a tick newer than every tick recorded so far starts a new frame, and discards the oldest frame if the
+     * history is full.
+     *
+     * @param tick The tick the entity had the hitbox at
+     * @param entity The entity
+     * @param hitbox The entity's hitbox
+     * @throws std::invalid_argument if the tick is older than the oldest tick the history keeps
+     */
+    void record(uint64_t tick, InstanceId entity, const Rectangle2F& hitbox);
+
+    /**
+     * Removes every hitbox of an entity, such as when it is destroyed, so that its slot can be reused. Does nothing if
+     * the entity has no hitboxes.
+     * @param entity The entity to remove
+     */
+    void remove(InstanceId entity);
+
+    /**
+     * @param tick The tick to check
+     * @return true if the tick has been recorded and not yet discarded
+     */
+    [[nodiscard]] bool contains(uint64_t tick) const;
+
+    /**
+     * @return The most recently recorded tick, or std::nullopt if nothing has been recorded
+     */
+    [[nodiscard]] std::optional<uint64_t> getLatestTick() const { return latestTick_; }
+
+    /**
+     * @return The oldest tick that can still be recorded or queried, or std::nullopt if nothing has been recorded
+     */
+    [[nodiscard]] std::optional<uint64_t> getOldestTick() const;
+
+    /**
+     * @param tick The tick to look up
+     * @param entity The entity to look up
+     * @return The hitbox of the entity at the tick, or std::nullopt if none was recorded or it has been discarded
+     */
+    [[nodiscard]] std::optional<Rectangle2F> getHitbox(uint64_t tick, InstanceId entity) const;
+
+    /**
+     * Finds the entities whose hitboxes a line segment touched at a tick, as Rectangle2F::intersects() decides.
+     * @param tick The tick to rewind to
+     * @param line The segment, such as the path of a shot
+     * @param visitor Function called with each entity hit and its hitbox at the tick
+     * @return false if the tick is not in the history, such as a shot from a client whose latency is too high to
+     *         compensate for, in which case the visitor is not called
+     */
+    template<typename Visitor>
+    bool queryLine(const uint64_t tick, const Line2f& line, Visitor&& visitor) const {
+        const Frame* frame = findFrame(tick);
+        if (!frame) {
+            return false;
+        }
+        for (size_t word = 0; word < frame->present.size(); word++) {
+            for (uint64_t bits = frame->present[word]; bits != 0; bits &= bits - 1) {
+                const size_t slot = word * 64 + static_cast<size_t>(std::countr_zero(bits));
+                const Rectangle2F& hitbox = frame->hitboxes[slot];
+                if (hitbox.intersects(line)) {
+                    visitor(slotEntities_[slot], hitbox);
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    /**
+     * The hitboxes recorded at one tick, indexed by entity slot, with bit (slot % 64) of present[slot / 64] set for
+     * each slot recorded. Frames only grow to the highest slot recorded in them.
+     */
+    struct Frame {
+        std::optional<uint64_t> tick{};
+        std::vector<Rectangle2F> hitboxes{};
+        std::vector<uint64_t> present{};
+    };
+
+    std::vector<Frame> frames_;
+    std::optional<uint64_t> latestTick_{};
+    std::unordered_map<InstanceId, uint32_t> entitySlots_{};
+    std::vector<InstanceId> slotEntities_{};
+    std::vector<uint32_t> freeSlots_{};
+
+    /**
+     * @return The frame of a tick, or nullptr if the tick is not in the history
+     */
+    [[nodiscard]] const Frame* findFrame(uint64_t tick) const;
+};
+
+#endif //HITBOXHISTORY_H
@@ -0,0 +1,25 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef INSTANCEID_H
+#define INSTANCEID_H
+
+#include <cstdint>
+
+/**
+ * Type alias for instance identification.
+ * Used to uniquely identify specific instances of replicatable objects.
+ */
+using InstanceId = uint32_t;
+
+/**
+ * Special instance ID indicating an uninitialized replicatable object.
+ * Objects with this ID have not yet been registered with a NetworkEngine.
+ */
+static constexpr InstanceId uninitializedInstanceID = 0;
+
+#endif //INSTANCEID_H
@@ -0,0 +1,120 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef JOBGRAPH_H
+#define JOBGRAPH_H
+
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <vector>
+
+#include "WorkStealingPool.h"
+
+/**
+ * Graph of jobs run in parallel on a WorkStealingPool, each starting once the jobs it depends on have finished.
+ *
+ * A game's update can be split into jobs, such as one per system, with parallel for jobs splitting the work of a
+ * system over ranges of its entities. Jobs depending on others are continuations of them: they are queued by the last
+ * of their dependencies to finish, on the thread that ran it.
+ *
+ * The graph is built once and can be run any number of times, such as once per tick from AbstractServer::update(). Jobs
+ * can only depend on jobs added before them, so the graph never has cycles.
+ *
+ * Example usage:
+ * @code
+ * JobGraph graph(getWorkerPool());
+ * const auto input = graph.addJob([&] { applyInput(); });
+ * const auto movement = graph.addParallelFor(ships.size(), 256, [&](const size_t begin, const size_t end) {
+ *     for (size_t index = begin; index < end; index++) ships[index].move(deltaTime);
+ * }, {input});
+ * graph.addJob([&] { resolveCollisions(); }, {movement});
+ *
+ * graph.run();
+ * @endcode
+ */
+class JobGraph {
+public:
+    using JobId = size_t;
+    using Job = std::function<void()>;
+    using RangeJob = std::function<void(size_t begin, size_t end)>;
+
+    /**
+     * @param pool The pool to run jobs on, or nullptr to run every job on the thread calling run()
+     */
+    explicit JobGraph(WorkStealingPool* pool);
+
+    JobGraph(const JobGraph&) = delete;
+    JobGraph& operator=(const JobGraph&) = delete;
+
+    /**
+     * Adds a job to the graph.
+     * @param job The function to run
+     * @param dependencies The jobs that must finish before this one starts
+     * @return The ID of the job, for other jobs to depend on
+     * @throws std::invalid_argument if a dependency is not a job in the graph
+     * @throws std::runtime_error if the graph is running
+     */
+    JobId addJob(Job job, std::initializer_list<JobId> dependencies = {});
+
+    /**
+     * Adds a job calling a function over a range of indices split into chunks, which are run in parallel.
+     * @param count The number of indices, from 0 to count - 1
+     * @param grainSize The number of indices in each chunk, large enough that each chunk is worth queueing
+     * @param job Function called as job(begin, end) with each chunk of indices
+     * @param dependencies The jobs that must finish before any chunk starts
+     * @return The ID of the job, which finishes once every chunk has finished
+     * @throws std::invalid_argument if a dependency is not a job in the graph
+     * @throws std::runtime_error if the graph is running
+     * @see WorkStealingPool::parallelFor
+     */
+    JobId addParallelFor(size_t count, size_t grainSize, RangeJob job, std::initializer_list<JobId> dependencies = {});
+
+    /**
+     * Runs every job, returning once they have all finished.
+     *
+     * This can be called from a task on the graph's pool, such as a room's tick. Once a job throws, jobs that have not
+     * started yet are skipped.
+     *
+     * @throws The first exception thrown by a job, after every running job has finished
+     * @throws std::runtime_error if the graph is already running
+     */
+    void run();
+
+    /**
+     * Removes every job from the graph.
+     * @throws std::runtime_error if the graph is running
+     */
+    void clear();
+
+    [[nodiscard]] size_t size() const { return jobs_.size(); }
+
+private:
+    struct Node {
+        Job job;
+        std::vector<JobId> dependents;
+        size_t dependencyCount;
+        std::atomic<size_t> remainingDependencies;
+    };
+
+    WorkStealingPool* pool_;
+    // A deque so that nodes, which are not movable, are never moved as jobs are added
+    std::deque<Node> jobs_{};
+    bool running_{false};
+    std::atomic<size_t> remainingJobs_{0};
+    std::atomic<bool> failed_{false};
+    std::mutex exceptionMutex_;
+    std::exception_ptr exception_;
+
+    void submit(JobId jobId);
+    void runJob(JobId jobId);
+};
+
+#endif //JOBGRAPH_H
@@ -0,0 +1,174 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef LOOPBACKNETWORKPROTOCOL_H
+#define LOOPBACKNETWORKPROTOCOL_H
+
+#include <queue>
+#include <random>
+#include <unordered_map>
+
+#include "NetworkProtocol.h"
+#include "utils/RingBuffer.h"
+
+/**
+ * Conditions simulated on one direction of a loopback connection.
+ */
+struct LinkConditions {
+    /** Fixed one-way delay applied to every message, in seconds. */
+    double latency{0.0};
+    /** Upper bound of the random delay added on top of the latency, in seconds. */
+    double jitter{0.0};
+    /** Probability in the range [0, 1] that a message is dropped. */
+    double lossRate{0.0};
+    /** Maximum throughput of the link in bytes per second, or 0 for unlimited. */
+    uint32_t bandwidth{0};
+};
+
+/**
+ * Counters describing the traffic that has passed through one direction of a loopback connection.
+ */
+struct LinkStatistics {
+    uint64_t messagesSent{0};
+    uint64_t messagesDelivered{0};
+    uint64_t messagesDropped{0};
+    uint64_t bytesSent{0};
+    uint64_t bytesDelivered{0};
+};
+
+/**
+ * In-process network protocol connecting a server to simulated client endpoints without sockets.
+ *
+ * The server side is used through the INetworkProtocol interface exactly like TcpNetworkProtocol, while the simulated
+ * clients are driven directly through connectClient(), clientSend() and clientRecieve(). Every message travels over a
+ * link with its own LinkConditions, so latency, jitter, loss and bandwidth caps can be reproduced exactly.
+ *
+ * Time does not pass on its own: messages are only delivered when advanceTime() moves the simulated clock past their
+ * delivery time. Together with the seeded random number generator this makes every run with the same inputs
+ * deterministic, which is what makes the protocol suitable for benchmarks and tests.
+ *
+ * @note This class is not thread safe, all methods must be called from the same thread.
+ */
+class LoopbackNetworkProtocol final : public INetworkProtocol {
+public:
+    /**
+     * @param seed Seed for the random number generator used to simulate jitter and loss.
+     */
+    explicit LoopbackNetworkProtocol(uint32_t seed = 0);
+
+    std::optional<Message> recieve() override;
+    void send(Message message) override;
+    void disconnect(ClientId clientId) override;
+
+    /**
+     * Connects a new simulated client, the server is notified by a Connect event.
+     *
+     * @param upstream Conditions of the link from the client to the server.
+     * @param downstream Conditions of the link from the server to the client.
+     * @return The ClientId assigned to the new client.
+     */
+    ClientId connectClient(const LinkConditions& upstream = {}, const LinkConditions& downstream = {});
+
+    /**
+     * Disconnects a simulated client, the server is notified by a Disconnect event.
+     *
+     * Any messages still in flight to or from the client are dropped.
+     *
+     * @param clientId The client to disconnect.
+     */
+    void disconnectClient(ClientId clientId);
+
+    /**
+     * Sends a message from a simulated client to the server.
+     * @param clientId The client sending the message.
+     * @param body The message body.
+     * @throws std::invalid_argument if the client is not connected
+     */
+    void clientSend(ClientId clientId, MessageBuffer body);
+
+    /**
+     * Receives the next message delivered to a simulated client.
+     * @param clientId The client receiving the message.
+     * @return The next delivered message, or std::nullopt if there are none.
+     * @throws std::invalid_argument if the client is not connected
+     */
+    std::optional<Message> clientRecieve(ClientId clientId);
+
+    /**
+     * Advances the simulated clock, delivering every message whose delivery time has been reached.
+     *
+     * Messages sent over a link without any delay are delivered by advancing the clock by 0.
+     *
+     * @param deltaTime The time to advance by, in seconds.
+     */
+    void advanceTime(double deltaTime);
+
+    /** @return The current time of the simulated clock, in seconds. */
+    [[nodiscard]] double getTime() const { return time_; }
+
+    /** @return The number of messages currently in flight in either direction. */
+    [[nodiscard]] size_t getInFlightCount() const { return inFlight_.size(); }
+
+    /**
+     * @param clientId The client to get the statistics for.
+     * @return The statistics of the link from the client to the server.
+     * @throws std::invalid_argument if the client is not connected
+     */
+    [[nodiscard]] const LinkStatistics& getUpstreamStatistics(ClientId clientId) const;
+
+    /**
+     * @param clientId The client to get the statistics for.
+     * @return The statistics of the link from the server to the client.
+     * @throws std::invalid_argument if the client is not connected
+     */
+    [[nodiscard]] const LinkStatistics& getDownstreamStatistics(ClientId clientId) const;
+
+private:
+    struct Link {
+        LinkConditions conditions;
+        LinkStatistics statistics;
+        // Time at which the link finishes transmitting the messages already sent over it
+        double busyUntil{0.0};
+        // Delivery time of the last message sent, messages are never delivered out of order
+        double lastDeliveryTime{0.0};
+    };
+
+    struct Endpoint {
+        Link upstream;
+        Link downstream;
+        RingBuffer<Message> inbox;
+    };
+
+    struct InFlightMessage {
+        double deliveryTime;
+        // Breaks ties between messages with the same delivery time so that they are delivered in the order sent
+        uint64_t sequence;
+        bool toServer;
+        Message message;
+    };
+
+    struct DeliversLater {
+        bool operator()(const InFlightMessage& a, const InFlightMessage& b) const {
+            return a.deliveryTime != b.deliveryTime ? a.deliveryTime > b.deliveryTime : a.sequence > b.sequence;
+        }
+    };
+
+    double time_{0.0};
+    uint64_t nextSequence_{0};
+    ClientId nextClientId_{0};
+    std::mt19937 random_;
+
+    std::unordered_map<ClientId, Endpoint> endpoints_;
+    RingBuffer<Message> serverInbox_;
+    std::priority_queue<InFlightMessage, std::vector<InFlightMessage>, DeliversLater> inFlight_;
+
+    Endpoint& getEndpoint(ClientId clientId);
+    [[nodiscard]] const Endpoint& getEndpoint(ClientId clientId) const;
+    void transmit(Link& link, Message message, bool toServer);
+};
+
+#endif //LOOPBACKNETWORKPROTOCOL_H
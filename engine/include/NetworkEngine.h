@@ -8,20 +8,38 @@
 #ifndef NETWORKENGINE_H
 #define NETWORKENGINE_H
 
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
 #include <vector>
 #include <unordered_map>
 
+#include "BackgroundWorker.h"
+#include "ClientCommand.h"
 #include "Replicatable.h"
 #include "NetworkProtocol.h"
+#include "ReplicationFrame.h"
+#include "ReplicationScheduler.h"
+#include "SpatialHashGrid.h"
+#include "utils/RingBuffer.h"
+
+class WorkStealingPool;
 
 /**
  * Manages the network replication of game objects.
  *
  * NetworkEngine is responsible for:
  * - Tracking all replicatable objects in the game
- * - Assigning unique instance IDs to objects
+ * - Assigning unique instance IDs to objects, reusing the IDs of destroyed objects
  * - Serializing objects for network transmission
  * - Managing object lifecycle with respect to replication
+ * - Decoding commands received from clients and applying them at the start of each tick
+ * - Tracking the session of each connected player, removing players that disconnect or time out
+ * - Limiting the objects replicated to each player to those within their view
+ * - Scheduling the objects replicated to each player within their bandwidth
+ * - Building the snapshots of players with a view or bandwidth in parallel, from a ReplicationFrame of the objects
+ * - Optionally sending snapshots on a background thread while the next tick is simulated
  *
  * The engine maintains references but does not own the objects - objects must unregister themselves before destruction.
  *
@@ -32,32 +50,291 @@
 class NetworkEngine {
     friend class XCube2Engine;
 public:
+    using PlayerHandler = std::function<void(ClientId)>;
+    using InterestHandler = std::function<void(ClientId, InstanceId)>;
+
+    /** The default width and height of the cells of the interest grid. */
+    static constexpr float defaultInterestCellSize = 256.f;
+
+    /**
+     * The most serialization buffers kept for reuse by each player, and by the full game state shared by the rest.
+     * While a slow client still holds every kept buffer, further messages are serialized into buffers that are freed
+     * once sent rather than kept.
+     */
+    static constexpr size_t maxPooledSerializationBuffers = 4;
+
     explicit NetworkEngine(std::unique_ptr<INetworkProtocol> networkPort);
 
-    void update();
+    /**
+     * Receives all pending messages, queueing any client commands they contain, and sends the replicated state to
+     * every player.
+     *
+     * Players are added when they connect or first send a message and removed when they disconnect or have not sent a
+     * message for longer than the player timeout.
+     *
+     * @param deltaTime The time since the last update in seconds, used to time out idle players
+     */
+    void update(float deltaTime = 0.f);
+
+    /**
+     * Sets whether snapshots are built and sent on a background thread, pipelining replication with the simulation.
+     *
+     * When pipelined, update() captures the state of the objects into a ReplicationFrame and returns, leaving a
+     * background thread to build and send the snapshots from the frame while the game simulates the next tick, so a
+     * tick takes as long as the longer of the two rather than both. The next update() first waits for the snapshots
+     * to be sent. The objects themselves are never read by the background thread, so they can be changed, created and
+     * destroyed as usual.
+     *
+     * Methods changing how players are replicated to, such as setPlayerView(), wait for the snapshots to be sent
+     * first. Interest handlers are called when the snapshots have been sent, at the start of the next update() or
+     * call to finishReplication().
+     *
+     * @param pipelined Whether to pipeline replication, false by default
+     */
+    void setPipelinedReplication(bool pipelined);
+
+    /**
+     * Waits for the snapshots of the last update to be sent and calls the interest handlers, when replication is
+     * pipelined. Otherwise, does nothing.
+     * @throws The exception thrown while building or sending the snapshots, if any
+     */
+    void finishReplication();
+
+    /**
+     * Sets how long a player may go without sending a message before they are disconnected.
+     * @param timeout The timeout in seconds, or 0 to never time out players (the default)
+     */
+    void setPlayerTimeout(const float timeout) { playerTimeout_ = timeout; }
+
+    /**
+     * Sets the function called when a player is added.
+     * @param handler Function called with the ClientId of the player
+     */
+    void setPlayerConnectedHandler(PlayerHandler handler) { playerConnectedHandler_ = std::move(handler); }
+
+    /**
+     * Sets the function called when a player is removed, after which nothing more is sent to them.
+     * @param handler Function called with the ClientId of the player
+     */
+    void setPlayerDisconnectedHandler(PlayerHandler handler) { playerDisconnectedHandler_ = std::move(handler); }
+
+    /**
+     * Disconnects a player and removes them from the game.
+     * @param clientId The player to disconnect
+     */
+    void disconnectPlayer(ClientId clientId);
+
+    /**
+     * Sets the area of the world a player can see, enabling interest management for them.
+     *
+     * Players with a view are only sent the objects in the cells of the interest grid that intersect their view, along
+     * with every object without a position (see IReplicatable::getReplicationPosition). Their snapshots are a msgpack
+     * array of two elements: the objects, in the same format as getReplicatedObjectsSerialized(), and an array of the
+     * instance IDs of the objects that have left their view since their last snapshot.
+     *
+     * @param clientId The player to set the view of
+     * @param view The area of the world the player can see
+     * @throws std::invalid_argument if the player is not connected
+     */
+    void setPlayerView(ClientId clientId, const Rectangle2F& view);
+
+    /**
+     * Removes a player's view, they are sent every object again from the next update.
+     *
+     * Players without a bandwidth go back to being sent the full game state, and the interest leave handler is called
+     * at the end of the next update for each object that was in their view, as it is when an object leaves the view.
+     *
+     * @param clientId The player to remove the view of
+     */
+    void clearPlayerView(ClientId clientId);
+
+    /**
+     * Sets the bandwidth available for replicating objects to a player.
+     *
+     * Each update, players with a bandwidth are only sent as many of the objects relevant to them (those in their view,
+     * or every object if they have no view) as fit in the bytes they have been allotted since the last update. Objects
+     * are chosen by their accumulated priority (see IReplicatable::getReplicationPriority), so the objects left out
+     * are deferred to later updates rather than dropped, and objects that are not sent keep their last sent state on
+     * the client. Snapshots use the same format as for players with a view.
+     *
+     * @param clientId The player to set the bandwidth of
+     * @param bandwidth The bandwidth in bytes per second, or 0 to send every relevant object each update (the default)
+     * @throws std::invalid_argument if the player is not connected
+     * @see ReplicationScheduler
+     */
+    void setPlayerBandwidth(ClientId clientId, uint32_t bandwidth);
+
+    /**
+     * Sets the pool the snapshots of players with a view or bandwidth are built on.
+     *
+     * Each update captures the state of every object into a ReplicationFrame, then builds each player's snapshot from
+     * the frame rather than the objects, so snapshots can be built in parallel. The snapshots are still sent one at a
+     * time in the order of the players, see setPipelinedReplication() for the thread they are sent from.
+     *
+     * @param pool The pool to build snapshots on, or nullptr to build them on the thread calling update() (the
+     *             default). The pool must outlive the engine or be unset before it is destroyed.
+     * @see WorkStealingPool::parallelFor
+     */
+    void setSnapshotPool(WorkStealingPool* pool);
+
+    /**
+     * Sets the width and height of the cells of the interest grid.
+     *
+     * Cells close to the size of the players' views keep the number of cells checked per player and the number of
+     * objects outside the view that are sent anyway low.
+     *
+     * @param cellSize The width and height of each cell
+     * @throws std::invalid_argument if cellSize is not positive
+     */
+    void setInterestCellSize(float cellSize);
+
+    /**
+     * Sets the functions called when an object enters or leaves the set of objects replicated to a player with a view.
+     *
+     * The handlers are called at the end of update(), after the snapshots have been sent.
+     *
+     * @param enterHandler Function called with the player and the instance ID of the object entering their view
+     * @param leaveHandler Function called with the player and the instance ID of the object leaving their view
+     */
+    void setInterestHandlers(InterestHandler enterHandler, InterestHandler leaveHandler);
+
+    /**
+     * Registers a handler for client commands of type Command.
+     *
+     * Client commands are sent as a msgpack array of the command's typeId, its sequence number and the serialized
+     * command, any number of which may be concatenated in one message. They are decoded into per-player queues of
+     * preallocated commands as they are received, then passed to the handler by applyClientCommands() in the order
+     * they were received, interleaved with the player's commands of other types.
+     *
+     * @tparam Command The type of command, see ClientCommandChannel for its requirements
+     * @param handler Function called with the sending player and each command when it is applied
+     * @param queueCapacity The maximum number of commands of this type queued per player between ticks, further
+     *                      commands are discarded
+     * @throws std::runtime_error if a command with the same typeId is already registered
+     */
+    template<typename Command>
+    void registerClientCommand(typename ClientCommandChannel<Command>::Handler handler, size_t queueCapacity = 32) {
+        static_assert(std::is_same_v<decltype(Command::typeId), const TypeId>,
+            "Client commands must have a static constexpr typeId set to a unique string identifyer");
+        if (clientCommandChannelIndices_.contains(Command::typeId)) {
+            throw std::runtime_error("Client command already registered");
+        }
+
+        auto channel = std::make_unique<ClientCommandChannel<Command>>(std::move(handler), queueCapacity);
+        for (const auto playerClientId: players_) {
+            channel->addClient(playerClientId);
+        }
+        clientCommandChannelIndices_.emplace(Command::typeId, clientCommandChannels_.size());
+        clientCommandChannels_.push_back(std::move(channel));
+    }
+
+    /**
+     * Applies all client commands received since the last call, in the order they were received from each player
+     * whatever their type, so a player's move followed by a fire are applied in that order.
+     *
+     * This should be called at the start of each tick, before the game is updated.
+     */
+    void applyClientCommands();
 
     /**
      * Registers a replicatable object for network replication.
      *
      * Upon registration object is assigned a unique instance ID and stored for serialization if not already
-     * initialized.
+     * initialized. Objects are stored in a batch per TypeId, each serialized by a single call to the batch's
+     * PackBatchFunction.
      *
      * @param object Pointer to the object to register.
+     * @param packBatch The function serializing batches of objects of this type, which must be the same for every
+     *                  object of the type
      * @pre object != nullptr
      * @note Objects must unregister before destruction
+     * @throws std::runtime_error if the object is already registered, or another object of its type was registered
+     *         with a different packBatch
      */
-    void registerReplicatedObject(IReplicatable* object);
+    void registerReplicatedObject(IReplicatable* object, PackBatchFunction packBatch = packReplicatableBatch);
 
     /**
      * Unregisters a replicatable object.
      *
      * After unregistration, the object will no longer be included in
-     * serialization operations.
+     * serialization operations, and its instance ID is released to be reused.
      *
      * @param object Pointer to the object to unregister
      */
     void unregisterReplicatedObject(IReplicatable* object);
 
+    /**
+     * Registers a store of entities for network replication.
+     *
+     * Every entity in the store is included in every snapshot, see IReplicatedStore.
+     *
+     * @param store Pointer to the store to register
+     * @note Stores must unregister before destruction
+     * @throws std::invalid_argument if store is null
+     * @throws std::runtime_error if the store is already registered, or its TypeId is used by another store or by
+     *         registered objects
+     */
+    void registerReplicatedStore(IReplicatedStore* store);
+
+    /**
+     * Unregisters a store of entities, after which it is no longer included in snapshots.
+     * @param store Pointer to the store to unregister
+     */
+    void unregisterReplicatedStore(const IReplicatedStore* store);
+
+    /**
+     * Allocates a unique instance ID, for entities replicated through a store rather than as objects.
+     *
+     * Released IDs are reused oldest first once the reuse delay has passed (see setInstanceIdReuseDelay), so IDs stay
+     * as small as the number of objects alive at once allows, keeping them short on the wire and suitable for indexing
+     * dense tables on clients.
+     *
+     * @return The instance ID, unique among every object and entity currently replicated by this engine
+     * @throws std::runtime_error if every instance ID is in use or waiting to be reused
+     */
+    InstanceId allocateInstanceId();
+
+    /**
+     * Releases an instance ID allocated with allocateInstanceId(), once the entity it identified is destroyed.
+     *
+     * The IDs of objects are released when they are unregistered. Does nothing if the ID is not allocated.
+     *
+     * @param instanceId The instance ID to release
+     */
+    void releaseInstanceId(InstanceId instanceId);
+
+    /**
+     * Sets how many updates a released instance ID waits before it is reused.
+     *
+     * Every player is sent a snapshot without the destroyed object in the update after it is released, so by default
+     * its ID is reused from then on. Longer delays give clients more time to process the removal.
+     *
+     * @param updates The number of updates, at least 1
+     * @throws std::invalid_argument if updates is 0
+     */
+    void setInstanceIdReuseDelay(uint32_t updates);
+
+    /**
+     * Gets a handle to the object or entity currently holding an instance ID.
+     * @param instanceId The instance ID of the object or entity
+     * @return The handle, see InstanceHandle
+     * @throws std::invalid_argument if the instance ID is not allocated
+     */
+    [[nodiscard]] InstanceHandle getInstanceHandle(InstanceId instanceId) const;
+
+    /**
+     * @param handle A handle to an object or entity
+     * @return true if the object or entity the handle was created for has not been destroyed
+     */
+    [[nodiscard]] bool isInstanceLive(const InstanceHandle& handle) const;
+
+    /**
+     * Finds the registered object a handle refers to.
+     * @param handle A handle to an object
+     * @return Pointer to the object, or nullptr if it has been destroyed or the handle refers to an entity in a store
+     */
+    [[nodiscard]] IReplicatable* findReplicatedObject(const InstanceHandle& handle) const;
+
     /**
      * Gets the current map of all registered replicatable objects.
      *
@@ -66,9 +343,7 @@ public:
      * @return Constant reference to the map of registered objects
      * @note The returned pointers remain owned by their respective objects and could be deallocated at any point
      */
-    [[nodiscard]] std::unordered_map<TypeId, std::vector<IReplicatable *>> getReplicatedObjects() const {
-        return replicatedObjects_;
-    }
+    [[nodiscard]] std::unordered_map<TypeId, std::vector<IReplicatable *>> getReplicatedObjects() const;
 
     /**
      * Serializes all registered objects into a msgpack buffer.
@@ -82,14 +357,140 @@ public:
 
     [[nodiscard]] std::vector<ClientId> getPlayers() const { return players_; }
 
+    [[nodiscard]] bool hasPlayer(const ClientId clientId) const { return playerIndices_.contains(clientId); }
+
 private:
+    struct ReplicatedType {
+        TypeId typeId;
+        PackBatchFunction packBatch;
+    };
+
     // NetworkEngine tracks but does not own these objects.
     // Objects must unregister themselves before destruction.
-    std::unordered_map<TypeId, std::vector<IReplicatable*>> replicatedObjects_{};
-    InstanceId nextReplicatedObjectInstanceId_{1};
+    // Objects are stored in one contiguous batch per type, at the same index as the type in replicatedTypes_. Types
+    // are never removed, so indices stay valid, and types without objects are skipped when serializing.
+    std::vector<ReplicatedType> replicatedTypes_{};
+    std::vector<std::vector<IReplicatable*>> replicatedObjects_{};
+    std::unordered_map<TypeId, size_t> replicatedTypeIndices_{};
+    std::vector<IReplicatedStore*> replicatedStores_{};
+
+    struct InstanceSlot {
+        uint32_t generation{0};
+        bool allocated{false};
+        // Null for entities in stores
+        IReplicatable* object{nullptr};
+    };
+
+    struct ReleasedInstanceId {
+        InstanceId instanceId;
+        uint64_t releaseUpdate;
+    };
+
+    // Indexed by instance ID, slot 0 is uninitializedInstanceID and never allocated. Released IDs are reused in the
+    // order they were released, so the ID given to a new object is the one that has gone unused the longest.
+    std::vector<InstanceSlot> instanceSlots_{1};
+    RingBuffer<ReleasedInstanceId> releasedInstanceIds_{};
+    uint32_t instanceIdReuseDelay_{1};
 
     std::unique_ptr<INetworkProtocol> networkPort_;
+
+    // Players are stored densely for broadcasting, with the time each player was last heard from and the channel index
+    // of each command queued from them, in the order they were received, stored at the same index. Removing a player
+    // swaps the last player into its place so that it is O(1).
     std::vector<ClientId> players_{};
+    std::vector<double> playerLastHeardTimes_{};
+    std::vector<std::vector<size_t>> playerCommandOrders_{};
+    std::unordered_map<ClientId, size_t> playerIndices_{};
+    double time_{0.0};
+    float playerTimeout_{0.f};
+    PlayerHandler playerConnectedHandler_{};
+    PlayerHandler playerDisconnectedHandler_{};
+
+    // Channels are applied in registration order, the map is only used to look them up by typeId when decoding
+    std::vector<std::unique_ptr<IClientCommandChannel>> clientCommandChannels_{};
+    std::unordered_map<TypeId, size_t> clientCommandChannelIndices_{};
+    // Reused for every decoded command, strings and binary data reference the message body rather than being copied
+    msgpack::zone clientCommandZone_{};
+
+    struct InterestEvent {
+        ClientId clientId;
+        InstanceId instanceId;
+        bool entered;
+    };
+
+    // Everything a player's snapshot is built from other than the frame, so the snapshots of different players can be
+    // built on different threads
+    struct PlayerReplication {
+        std::optional<Rectangle2F> view;
+        // Instance IDs of the objects relevant to the player at their last snapshot, sorted
+        std::vector<InstanceId> visibleObjects;
+        ReplicationScheduler scheduler;
+        std::optional<MessageBuffer> snapshot;
+        std::vector<InterestEvent> interestEvents;
+
+        // Reused between snapshots to avoid reallocating
+        std::vector<uint32_t> candidates;
+        std::vector<float> candidatesX;
+        std::vector<float> candidatesY;
+        std::vector<float> candidateDistancesSquared;
+        std::vector<ReplicationScheduler::Candidate> scheduleCandidates;
+        std::vector<size_t> scheduledCandidates;
+        std::vector<uint32_t> snapshotObjects;
+        std::vector<InstanceId> nextVisibleObjects;
+        std::vector<InstanceId> leftObjects;
+        std::vector<std::shared_ptr<msgpack::sbuffer>> serializationBuffers;
+    };
+
+    // Players without a view or bandwidth have no entry and share the full game state
+    std::unordered_map<ClientId, PlayerReplication> playerReplications_{};
+    // Objects with a position are kept in the grid by instance ID, objects without one are sent to every player with a
+    // view and are listed by their index in the frame
+    SpatialHashGrid<InstanceId> interestGrid_{defaultInterestCellSize};
+    std::vector<uint32_t> unpositionedObjects_{};
+    InterestHandler interestEnterHandler_{};
+    InterestHandler interestLeaveHandler_{};
+    // Gathered from every player before any handler is called, as handlers may remove players
+    std::vector<InterestEvent> pendingInterestEvents_{};
+
+    // The state of every object at the end of the current update, which every snapshot is built from. When pipelined
+    // it is the only state the replication thread reads besides the players' replications, while the game changes the
+    // objects themselves.
+    ReplicationFrame frame_{};
+    uint64_t updateCount_{0};
+    float frameDeltaTime_{0.f};
+    WorkStealingPool* snapshotPool_{nullptr};
+    // Objects unregistered while the replication thread may be reading the interest grid, removed from it once it
+    // has finished
+    std::vector<InstanceId> pendingGridRemovals_{};
+    // Players with a view or bandwidth in the order of players_, reused between updates
+    std::vector<std::pair<ClientId, PlayerReplication*>> replicatedPlayers_{};
+
+    // Buffers the full game state is serialized into and sent from, each is reused once the protocol has released
+    // every message sharing it, so steady state updates do not allocate. At most maxPooledSerializationBuffers are kept.
+    std::vector<std::shared_ptr<msgpack::sbuffer>> serializationBuffers_{};
+
+    // Declared last so that it is stopped before any state its job uses is destroyed
+    std::unique_ptr<BackgroundWorker> replicationWorker_{};
+
+    void addPlayer(ClientId clientId);
+    void removePlayer(ClientId clientId);
+    // Queues a leave event for each object the player was sent before switching them to the full game state
+    void erasePlayerReplication(std::unordered_map<ClientId, PlayerReplication>::iterator replication);
+    void timeOutIdlePlayers();
+    void decodeClientCommands(const Message& message);
+    void captureFrame();
+    // Builds every player's snapshot from the frame and sends it
+    void replicateFrame();
+    void updateInterestGrid();
+    // Only reads the frame and interest grid, so it can be called for different players at once
+    void buildPlayerSnapshot(ClientId clientId, PlayerReplication& replication, float deltaTime) const;
+    void dispatchInterestEvents();
+    [[nodiscard]] const InstanceSlot* findInstanceSlot(InstanceId instanceId) const;
+    [[nodiscard]] static std::shared_ptr<msgpack::sbuffer> acquireSerializationBuffer(
+        std::vector<std::shared_ptr<msgpack::sbuffer>>& buffers);
+    [[nodiscard]] static MessageBuffer toMessageBuffer(std::shared_ptr<msgpack::sbuffer> buffer);
+    void packReplicatedObjects(msgpack::sbuffer& buffer,
+                               const std::vector<std::vector<IReplicatable*>>& objectsByType) const;
 
 };
 
@@ -8,24 +8,137 @@
 #ifndef NETWORKPROTOCOL_H
 #define NETWORKPROTOCOL_H
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
 #include <optional>
+#include <span>
 #include <vector>
 
+#include "utils/BufferPool.h"
+
 using ClientId = uint32_t;
 
+/**
+ * The kind of event a Message represents.
+ */
+enum class MessageType : uint8_t {
+    /** Data received from or sent to a client. */
+    Data,
+    /** A client connected, the message has no body. */
+    Connect,
+    /** A client disconnected, the message has no body. */
+    Disconnect
+};
+
+/**
+ * Immutable, shared bytes of a message body.
+ *
+ * Copies share the same bytes, so one body can be sent to many clients and queued by a protocol without being copied.
+ * The bytes can be owned by any object kept alive by a shared_ptr, letting NetworkEngine send its reused serialization
+ * buffers directly. Bodies received by a protocol's I/O thread and released by the game thread should be created with
+ * copy(), which draws them from the BufferPool rather than the general purpose heap.
+ */
+class MessageBuffer {
+public:
+    MessageBuffer() = default;
+
+    /**
+     * Takes ownership of the bytes in a vector.
+     * @param bytes The bytes of the body
+     */
+    // ReSharper disable once CppNonExplicitConvertingConstructor - bodies are commonly built as vectors
+    MessageBuffer(std::vector<uint8_t> bytes) {
+        const auto owner = std::make_shared<const std::vector<uint8_t>>(std::move(bytes));
+        data_ = std::shared_ptr<const uint8_t>(owner, owner->data());
+        size_ = owner->size();
+    }
+
+    // ReSharper disable once CppNonExplicitConvertingConstructor
+    MessageBuffer(const std::initializer_list<uint8_t> bytes) : MessageBuffer(std::vector<uint8_t>(bytes)) {}
+
+    /**
+     * Copies bytes into a block from the BufferPool, along with the buffer's reference count.
+     * @param bytes The bytes of the body
+     * @return The buffer holding the copy
+     * @throws std::bad_alloc if the pool cannot allocate a block
+     */
+    [[nodiscard]] static MessageBuffer copy(const std::span<const uint8_t> bytes) {
+        if (bytes.empty()) {
+            return {};
+        }
+        const size_t size = bytes.size();
+        auto* block = static_cast<uint8_t*>(BufferPool::allocate(size));
+        std::memcpy(block, bytes.data(), size);
+
+        MessageBuffer buffer;
+        buffer.data_ = std::shared_ptr<const uint8_t>(block, [size](const uint8_t* pooledBlock) {
+            BufferPool::deallocate(const_cast<uint8_t*>(pooledBlock), size);
+        }, PoolAllocator<uint8_t>());
+        buffer.size_ = size;
+        return buffer;
+    }
+
+    /**
+     * Shares bytes owned by another object, without copying them.
+     * @param owner The object owning the bytes, kept alive until every copy of this buffer is destroyed
+     * @param data Pointer to the bytes, which must not be modified while the buffer exists
+     * @param size The number of bytes
+     */
+    MessageBuffer(std::shared_ptr<const void> owner, const uint8_t* data, const size_t size)
+        : data_(std::move(owner), data)
+        , size_(size) {}
+
+    [[nodiscard]] const uint8_t* data() const { return data_.get(); }
+    [[nodiscard]] size_t size() const { return size_; }
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+
+    [[nodiscard]] const uint8_t* begin() const { return data(); }
+    [[nodiscard]] const uint8_t* end() const { return data() + size_; }
+
+    const uint8_t& operator[](const size_t index) const { return data_.get()[index]; }
+
+    bool operator==(const MessageBuffer& other) const { return std::ranges::equal(*this, other); }
+
+private:
+    std::shared_ptr<const uint8_t> data_{};
+    size_t size_{0};
+};
+
 struct Message {
     ClientId clientId;
-    std::vector<uint8_t> body;
+    MessageBuffer body;
+    MessageType type{MessageType::Data};
 };
 
 class INetworkProtocol {
 public:
     virtual ~INetworkProtocol() = default;
 
+    /**
+     * Receives the next message or connection event.
+     *
+     * Connect and Disconnect events are delivered in order with the data messages from the same client, so no data is
+     * received from a client before its Connect event or after its Disconnect event.
+     *
+     * @return The next message, or std::nullopt if there are none.
+     */
     virtual std::optional<Message> recieve() = 0;
 
     virtual void send(Message message) = 0;
+
+    /**
+     * Closes the connection to a client, any messages still queued for it are discarded.
+     *
+     * No Disconnect event is delivered for connections closed by the server, and any messages received from the client
+     * but not yet returned by recieve() are discarded, so a disconnected client is never seen again.
+     *
+     * @param clientId The client to disconnect.
+     */
+    virtual void disconnect(ClientId clientId) = 0;
 };
 
 #endif //NETWORKPROTOCOL_H
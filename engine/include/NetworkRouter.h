@@ -0,0 +1,112 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef NETWORKROUTER_H
+#define NETWORKROUTER_H
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "NetworkProtocol.h"
+
+using RoomId = uint32_t;
+
+/**
+ * Shares one network protocol between many rooms, routing each client's messages to the room it is assigned to.
+ *
+ * Each room is given an endpoint by createEndpoint(), an INetworkProtocol that its NetworkEngine uses exactly like a
+ * protocol of its own: it receives the messages of the clients assigned to the room, along with Connect and
+ * Disconnect events as clients join and leave the room, and can only send to and disconnect those clients.
+ *
+ * Clients are assigned to the default room when they connect, if there is one, and can be moved between rooms with
+ * assignClient(). Messages from clients that are not in any room are discarded, as are those from clients a room has
+ * disconnected, so they do not rejoin.
+ *
+ * The router is thread safe, so rooms using different endpoints can be ticked on different threads. Calls to the
+ * transport are serialized by the router, so the transport need not be thread safe itself.
+ *
+ * @see RoomManager
+ */
+class NetworkRouter {
+public:
+    /**
+     * @param transport The protocol shared by every room
+     */
+    explicit NetworkRouter(std::unique_ptr<INetworkProtocol> transport);
+    ~NetworkRouter();
+
+    NetworkRouter(const NetworkRouter&) = delete;
+    NetworkRouter& operator=(const NetworkRouter&) = delete;
+
+    /**
+     * Creates the endpoint a room communicates with its clients through.
+     *
+     * When the endpoint is destroyed its clients are moved to the default room, or disconnected if there is no other
+     * default room. The endpoint must be destroyed before the router.
+     *
+     * @param roomId The room the endpoint is for
+     * @return The endpoint
+     * @throws std::runtime_error if the room already has an endpoint
+     */
+    [[nodiscard]] std::unique_ptr<INetworkProtocol> createEndpoint(RoomId roomId);
+
+    /**
+     * Sets the room clients are assigned to when they connect.
+     * @param roomId The room, or std::nullopt to leave new clients unassigned
+     * @throws std::invalid_argument if the room has no endpoint
+     */
+    void setDefaultRoom(std::optional<RoomId> roomId);
+
+    [[nodiscard]] std::optional<RoomId> getDefaultRoom() const;
+
+    /**
+     * Moves a client to a room. The room it leaves receives a Disconnect event and the room it joins a Connect event.
+     * @param clientId The client to move
+     * @param roomId The room to move the client to
+     * @throws std::invalid_argument if the client is not connected or the room has no endpoint
+     */
+    void assignClient(ClientId clientId, RoomId roomId);
+
+    /**
+     * @param clientId The client to find the room of
+     * @return The room the client is assigned to, or std::nullopt if it is not connected or not in a room
+     */
+    [[nodiscard]] std::optional<RoomId> getClientRoom(ClientId clientId) const;
+
+    /**
+     * Receives every pending message from the transport and queues it for the endpoint of the client's room.
+     *
+     * This should be called once per tick, before the rooms' NetworkEngines are updated.
+     */
+    void route();
+
+private:
+    class Endpoint;
+
+    // Guards every member below and every call to the transport
+    mutable std::mutex mutex_;
+    std::unique_ptr<INetworkProtocol> transport_;
+    std::unordered_map<RoomId, Endpoint*> endpoints_{};
+    // Connected clients, mapped to their room or std::nullopt if they are not in one
+    std::unordered_map<ClientId, std::optional<RoomId>> clientRooms_{};
+    std::optional<RoomId> defaultRoom_{};
+    // Clients disconnected by the server since the transport was last emptied, whose messages still queued in it are
+    // discarded rather than treated as them connecting again
+    std::unordered_set<ClientId> disconnectedClients_{};
+
+    // Private members are called with the mutex held
+    [[nodiscard]] std::optional<RoomId> findClientRoom(ClientId clientId) const;
+    void deliver(RoomId roomId, Message message);
+    void send(RoomId roomId, Message message);
+    void disconnect(RoomId roomId, ClientId clientId);
+    void removeEndpoint(RoomId roomId);
+};
+
+#endif //NETWORKROUTER_H
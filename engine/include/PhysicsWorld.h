@@ -0,0 +1,256 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef PHYSICSWORLD_H
+#define PHYSICSWORLD_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "utils/GameMath.h"
+
+/** The shape of a physics body. */
+enum class BodyShape : uint8_t {
+    /** An axis aligned box, see BodyDefinition::halfExtents. */
+    Box,
+    /** A circle, see BodyDefinition::radius. */
+    Circle
+};
+
+/**
+ * The initial properties of a physics body.
+ */
+struct BodyDefinition {
+    BodyShape shape{BodyShape::Box};
+    /** The centre of the body. */
+    Vector2F position{};
+    Vector2F velocity{};
+    /** Half the width and height of a box. */
+    Vector2F halfExtents{0.5f, 0.5f};
+    /** The radius of a circle. */
+    float radius{0.5f};
+    /**
+     * The mass of the body, or 0 for a static body that never moves, whatever its velocity.
+     */
+    float mass{1.f};
+    /** How much gravity accelerates the body, ignored for static bodies. */
+    float gravityScale{1.f};
+    /** How much of the body's speed along the contact normal is kept when it collides, from 0 to 1. */
+    float restitution{0.f};
+    /** The collision layers the body is in. */
+    uint32_t layers{1};
+    /** The layers the body collides with, bodies only collide if each is in a layer the other collides with. */
+    uint32_t collidesWith{~0u};
+};
+
+/**
+ * Reference to a physics body that can tell when it has been destroyed, as the slots of destroyed bodies are reused.
+ */
+struct BodyHandle {
+    uint32_t slot{0};
+    uint32_t generation{0};
+
+    bool operator==(const BodyHandle& other) const = default;
+};
+
+/**
+ * A collision between two bodies found by the last step.
+ */
+struct Contact {
+    BodyHandle first;
+    BodyHandle second;
+    /** The direction from the first body to the second. */
+    Vector2F normal;
+    /** How far the bodies overlapped along the normal before they were separated. */
+    float penetration;
+};
+
+/**
+ * Server-authoritative 2D physics for boxes and circles, built for thousands of bodies per room each tick.
+ *
+ * Each step integrates the velocities and positions of the bodies, finds the pairs of bodies whose bounds overlap with
+ * a sweep and prune broadphase, tests each pair's shapes, then resolves each collision with an impulse and a
+ * positional correction.
+ *
+ * Bodies are stored as a structure of arrays, with each property in its own dense array, so each stage of a step
+ * streams through contiguous memory and is processed in batches by the kernels in VectorBatch.h. Destroying a body
+ * moves the last body into its place. The broadphase keeps the bodies sorted by the left edge of their bounds between
+ * steps, so re-sorting them after they move is close to linear, and only pairs overlapping along the x-axis are
+ * compared. Bodies created since the last step are sorted on their own and merged in.
+ *
+ * Example usage:
+ * @code
+ * PhysicsWorld world;
+ * world.setGravity({0.f, 981.f});
+ * world.createBody({.position = {400.f, 600.f}, .halfExtents = {400.f, 10.f}, .mass = 0.f});
+ * const BodyHandle ball = world.createBody({.shape = BodyShape::Circle, .position = {400.f, 0.f}, .radius = 8.f});
+ *
+ * world.step(deltaTime);
+ * for (const Contact& contact: world.getContacts()) {
+ *     onCollision(contact.first, contact.second);
+ * }
+ * @endcode
+ */
+class PhysicsWorld {
+public:
+    /**
+     * Adds a body to the world.
+     * @param definition The properties of the body
+     * @return Handle to the body
+     * @throws std::invalid_argument if the body's size or mass is negative
+     */
+    BodyHandle createBody(const BodyDefinition& definition);
+
+    /**
+     * Removes a body from the world, does nothing if it has already been destroyed.
+     * @param body The body to destroy
+     */
+    void destroyBody(BodyHandle body);
+
+    /**
+     * @param body A handle to a body
+     * @return true if the body has not been destroyed
+     */
+    [[nodiscard]] bool isValid(BodyHandle body) const;
+
+    [[nodiscard]] size_t getBodyCount() const { return positionX_.size(); }
+
+    /**
+     * @throws std::invalid_argument if the body has been destroyed, as do every other method taking a body
+     */
+    [[nodiscard]] Vector2F getPosition(BodyHandle body) const;
+    void setPosition(BodyHandle body, Vector2F position);
+    [[nodiscard]] Vector2F getVelocity(BodyHandle body) const;
+    void setVelocity(BodyHandle body, Vector2F velocity);
+
+    /**
+     * Changes a body's velocity by an impulse divided by its mass, does nothing to static bodies.
+     * @param body The body to push
+     * @param impulse The impulse to apply
+     */
+    void applyImpulse(BodyHandle body, Vector2F impulse);
+
+    /**
+     * @param body The body to get the bounds of
+     * @return The smallest rectangle containing the body's shape
+     */
+    [[nodiscard]] Rectangle2F getBounds(BodyHandle body) const;
+
+    /**
+     * Sets the acceleration applied to every dynamic body each step.
+     * @param gravity The acceleration, in units per second squared
+     */
+    void setGravity(const Vector2F gravity) { gravity_ = gravity; }
+
+    /**
+     * Sets how many times each step resolves its collisions, more iterations settle stacks of bodies faster.
+     * @param iterations The number of iterations, at least 1
+     * @throws std::invalid_argument if iterations is 0
+     */
+    void setSolverIterations(uint32_t iterations);
+
+    /**
+     * Advances the simulation.
+     * @param deltaTime The time to advance by in seconds
+     */
+    void step(float deltaTime);
+
+    /**
+     * @return Every collision found by the last step
+     */
+    [[nodiscard]] std::span<const Contact> getContacts() const { return contacts_; }
+
+    /**
+     * Calls a function with every body whose bounds, as of the last step, overlap an area, as Rectangle2F::intersects()
+     * decides: bodies only touching the area's edges are not found, nor is anything in an area without size.
+     *
+     * Bodies created since the last step are not found, and bodies moved by setPosition() are found where they were.
+     *
+     * @param area The area to find the bodies in
+     * @param visitor Function called with the BodyHandle of each body
+     */
+    template<typename Visitor>
+    void queryArea(const Rectangle2F& area, Visitor&& visitor) const {
+        for (const BodyHandle& body: sortedBodies_) {
+            if (!isValid(body)) continue;
+            const uint32_t index = slots_[body.slot].index;
+            // Bodies are sorted by their left edge, so no later body can overlap the area
+            if (minX_[index] >= area.x + area.w) break;
+            if ((area.w > 0.f) & (area.h > 0.f) & (maxX_[index] > minX_[index]) & (maxY_[index] > minY_[index])
+                & (maxX_[index] > area.x) & (maxY_[index] > area.y) & (minY_[index] < area.y + area.h)) {
+                visitor(body);
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        uint32_t index{0};
+        uint32_t generation{0};
+        bool alive{false};
+    };
+
+    struct BodyPair {
+        uint32_t first;
+        uint32_t second;
+        Vector2F normal;
+        float penetration;
+    };
+
+    // Indexed by the slot of each body's handle, which gives the index of the body in the dense arrays
+    std::vector<Slot> slots_{};
+    std::vector<uint32_t> freeSlots_{};
+
+    // Indexed densely by body, destroying a body swaps the last body into its place
+    std::vector<uint32_t> bodySlots_{};
+    std::vector<BodyShape> shapes_{};
+    std::vector<float> positionX_{};
+    std::vector<float> positionY_{};
+    std::vector<float> velocityX_{};
+    std::vector<float> velocityY_{};
+    std::vector<float> halfExtentX_{};
+    std::vector<float> halfExtentY_{};
+    std::vector<float> inverseMass_{};
+    std::vector<float> gravityScale_{};
+    // 1 for bodies that move and 0 for static bodies, which stay where they are
+    std::vector<float> timeScale_{};
+    std::vector<float> restitution_{};
+    std::vector<uint32_t> layers_{};
+    std::vector<uint32_t> collidesWith_{};
+    std::vector<float> minX_{};
+    std::vector<float> minY_{};
+    std::vector<float> maxX_{};
+    std::vector<float> maxY_{};
+
+    // Bodies sorted by the left edge of their bounds as of the last step. Destroyed bodies are removed, and bodies
+    // created since are added, at the start of the next step.
+    std::vector<BodyHandle> sortedBodies_{};
+    std::vector<BodyHandle> createdBodies_{};
+    // Copies of the bounds of each body in sorted order, so the bodies each body's bounds are tested against are
+    // contiguous and can be tested in batches
+    std::vector<uint32_t> sortedIndices_{};
+    std::vector<float> sortedMinX_{};
+    std::vector<float> sortedMinY_{};
+    std::vector<float> sortedMaxX_{};
+    std::vector<float> sortedMaxY_{};
+    std::vector<uint64_t> overlapMask_{};
+    std::vector<BodyPair> pairs_{};
+    std::vector<Contact> contacts_{};
+    Vector2F gravity_{};
+    uint32_t solverIterations_{4};
+
+    [[nodiscard]] uint32_t getIndex(BodyHandle body) const;
+    void updateBounds(uint32_t index);
+    void sortBodies();
+    void findPairs();
+    [[nodiscard]] bool testPair(uint32_t first, uint32_t second, BodyPair& pair) const;
+    void resolvePair(const BodyPair& pair);
+    void correctPair(const BodyPair& pair);
+};
+
+#endif //PHYSICSWORLD_H
@@ -0,0 +1,264 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef QUANTIZATION_H
+#define QUANTIZATION_H
+
+#include <bit>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+#include <type_traits>
+
+#include "utils/BitStream.h"
+#include "utils/FixedPoint.h"
+#include "utils/GameMath.h"
+
+// Codecs storing values in fewer bits than msgpack would, for the fields of REPLICATED_FIELDS (see ReplicatedFields.h)
+// or any other state written with a BitWriter. Each codec has getBits(), the bits it stores a value in, along with
+// write(writer, value) and read(reader, value).
+
+/**
+ * Codec storing a float in a fixed range using a fixed number of bits.
+ *
+ * Values outside the range are clamped to it and NaN is stored as the minimum.
+ */
+struct QuantizedFloat {
+    float min;
+    float max;
+    uint32_t bits;
+
+    /**
+     * @param min The smallest value stored
+     * @param max The largest value stored
+     * @param bits The number of bits to store each value in, between 1 and 32
+     * @throws std::invalid_argument if min is not less than max or bits is out of range
+     */
+    constexpr QuantizedFloat(const float min, const float max, const uint32_t bits)
+        : min(min)
+        , max(max)
+        , bits(bits) {
+        if (!(min < max)) {
+            throw std::invalid_argument("Quantized float minimum must be less than maximum");
+        }
+        if (bits == 0 || bits > 32) {
+            throw std::invalid_argument("Quantized float must use between 1 and 32 bits");
+        }
+    }
+
+    /**
+     * Creates a codec using the fewest bits that store every value in a range to within a resolution.
+     * @param min The smallest value stored
+     * @param max The largest value stored
+     * @param resolution The largest allowed step between stored values, e.g. 1/64 to store positions to 1/64 unit
+     * @return The codec
+     * @throws std::invalid_argument if resolution is not positive or the range needs more than 32 bits
+     */
+    static constexpr QuantizedFloat withResolution(const float min, const float max, const float resolution) {
+        if (!(resolution > 0.f)) {
+            throw std::invalid_argument("Quantized float resolution must be positive");
+        }
+        const double range = static_cast<double>(max) - min;
+        auto steps = static_cast<uint64_t>(range / resolution);
+        if (static_cast<double>(steps) * resolution < range) {
+            steps++;
+        }
+        return {min, max, static_cast<uint32_t>(std::bit_width(steps))};
+    }
+
+    [[nodiscard]] constexpr uint32_t getBits() const { return bits; }
+
+    void write(BitWriter& writer, const float value) const {
+        double normalized = (static_cast<double>(value) - min) / (static_cast<double>(max) - min);
+        if (!(normalized > 0.0)) normalized = 0.0;
+        if (normalized > 1.0) normalized = 1.0;
+        writer.write(static_cast<uint32_t>(std::llround(normalized * getMaxStep())), bits);
+    }
+
+    void read(BitReader& reader, float& value) const {
+        value = static_cast<float>(min + reader.read(bits) * ((static_cast<double>(max) - min) / getMaxStep()));
+    }
+
+private:
+    [[nodiscard]] constexpr double getMaxStep() const { return static_cast<double>((uint64_t{1} << bits) - 1); }
+};
+
+/**
+ * Codec storing an angle in radians using a fixed number of bits.
+ *
+ * Angles are wrapped into [0, 2π) before being stored, so they are read back in that range.
+ */
+struct QuantizedAngle {
+    uint32_t bits;
+
+    /**
+     * @param bits The number of bits to store each angle in, between 1 and 32
+     * @throws std::invalid_argument if bits is out of range
+     */
+    constexpr explicit QuantizedAngle(const uint32_t bits) : bits(bits) {
+        if (bits == 0 || bits > 32) {
+            throw std::invalid_argument("Quantized angle must use between 1 and 32 bits");
+        }
+    }
+
+    [[nodiscard]] constexpr uint32_t getBits() const { return bits; }
+
+    void write(BitWriter& writer, const float value) const {
+        constexpr double fullTurn = 2.0 * std::numbers::pi;
+        double wrapped = std::fmod(static_cast<double>(value), fullTurn);
+        if (std::isnan(wrapped)) wrapped = 0.0;
+        if (wrapped < 0.0) wrapped += fullTurn;
+        // A full turn rounds up to the step count, which wraps back to 0
+        const uint64_t steps = uint64_t{1} << bits;
+        writer.write(static_cast<uint32_t>(static_cast<uint64_t>(std::llround(wrapped / fullTurn * steps)) % steps),
+                     bits);
+    }
+
+    void read(BitReader& reader, float& value) const {
+        const double step = 2.0 * std::numbers::pi / static_cast<double>(uint64_t{1} << bits);
+        value = static_cast<float>(reader.read(bits) * step);
+    }
+};
+
+/**
+ * Codec storing an integer in a fixed range using the fewest bits that hold every value in it.
+ *
+ * Values outside the range are clamped to it.
+ *
+ * @tparam Int The integer type stored
+ */
+template<typename Int>
+struct QuantizedInt {
+    static_assert(std::is_integral_v<Int>, "QuantizedInt can only store integers");
+
+    Int min;
+    Int max;
+
+    /**
+     * @param min The smallest value stored
+     * @param max The largest value stored
+     * @throws std::invalid_argument if min is greater than max or the range needs more than 32 bits
+     */
+    constexpr QuantizedInt(const Int min, const Int max)
+        : min(min)
+        , max(max) {
+        if (min > max) {
+            throw std::invalid_argument("Quantized integer minimum must not be greater than maximum");
+        }
+        if (getRange() > 0xFFFFFFFFull) {
+            throw std::invalid_argument("Quantized integer range must fit in 32 bits");
+        }
+    }
+
+    [[nodiscard]] constexpr uint32_t getBits() const { return static_cast<uint32_t>(std::bit_width(getRange())); }
+
+    void write(BitWriter& writer, const Int value) const {
+        const Int clamped = value < min ? min : value > max ? max : value;
+        writer.write(static_cast<uint32_t>(static_cast<uint64_t>(clamped) - static_cast<uint64_t>(min)), getBits());
+    }
+
+    void read(BitReader& reader, Int& value) const {
+        value = static_cast<Int>(static_cast<uint64_t>(min) + reader.read(getBits()));
+    }
+
+private:
+    [[nodiscard]] constexpr uint64_t getRange() const {
+        return static_cast<uint64_t>(max) - static_cast<uint64_t>(min);
+    }
+};
+
+/**
+ * Codec storing a bool in a single bit.
+ */
+struct QuantizedBool {
+    [[nodiscard]] constexpr uint32_t getBits() const { return 1; }
+
+    void write(BitWriter& writer, const bool value) const { writer.writeBool(value); }
+
+    void read(BitReader& reader, bool& value) const { value = reader.readBool(); }
+};
+
+/**
+ * Codec storing a Vector2F as two quantized floats.
+ */
+struct QuantizedVector2F {
+    QuantizedFloat x;
+    QuantizedFloat y;
+
+    constexpr QuantizedVector2F(const QuantizedFloat& x, const QuantizedFloat& y) : x(x), y(y) {}
+
+    /** Uses the same codec for both components. */
+    constexpr explicit QuantizedVector2F(const QuantizedFloat& component) : x(component), y(component) {}
+
+    [[nodiscard]] constexpr uint32_t getBits() const { return x.getBits() + y.getBits(); }
+
+    void write(BitWriter& writer, const Vector2F& value) const {
+        x.write(writer, value.x);
+        y.write(writer, value.y);
+    }
+
+    void read(BitReader& reader, Vector2F& value) const {
+        x.read(reader, value.x);
+        y.read(reader, value.y);
+    }
+};
+
+/**
+ * Codec storing a fixed point number in a fixed range using the fewest bits that hold every step in it.
+ *
+ * Unlike QuantizedFloat, values are read back exactly, so fixed point state stays bit-identical across the network.
+ * Values outside the range are clamped to it.
+ *
+ * @tparam FractionBits The number of fraction bits of the fixed point type
+ */
+template<int FractionBits = 16>
+struct QuantizedFixed {
+    QuantizedInt<int32_t> steps;
+
+    /**
+     * @param min The smallest value stored
+     * @param max The largest value stored
+     * @throws std::invalid_argument if min is greater than max
+     */
+    constexpr QuantizedFixed(const Fixed<FractionBits> min, const Fixed<FractionBits> max) : steps(min.raw, max.raw) {}
+
+    [[nodiscard]] constexpr uint32_t getBits() const { return steps.getBits(); }
+
+    void write(BitWriter& writer, const Fixed<FractionBits> value) const { steps.write(writer, value.raw); }
+
+    void read(BitReader& reader, Fixed<FractionBits>& value) const { steps.read(reader, value.raw); }
+};
+
+/**
+ * Codec storing a Vector2Fixed as two quantized fixed point numbers.
+ */
+template<int FractionBits = 16>
+struct QuantizedVector2Fixed {
+    QuantizedFixed<FractionBits> x;
+    QuantizedFixed<FractionBits> y;
+
+    constexpr QuantizedVector2Fixed(const QuantizedFixed<FractionBits>& x, const QuantizedFixed<FractionBits>& y)
+        : x(x), y(y) {}
+
+    /** Uses the same codec for both components. */
+    constexpr explicit QuantizedVector2Fixed(const QuantizedFixed<FractionBits>& component)
+        : x(component), y(component) {}
+
+    [[nodiscard]] constexpr uint32_t getBits() const { return x.getBits() + y.getBits(); }
+
+    void write(BitWriter& writer, const Vector2Fixed<FractionBits>& value) const {
+        x.write(writer, value.x);
+        y.write(writer, value.y);
+    }
+
+    void read(BitReader& reader, Vector2Fixed<FractionBits>& value) const {
+        x.read(reader, value.x);
+        y.read(reader, value.y);
+    }
+};
+
+#endif //QUANTIZATION_H
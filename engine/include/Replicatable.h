@@ -8,8 +8,15 @@
 #ifndef REPLICATABLE_H
 #define REPLICATABLE_H
 
+#include <optional>
+#include <span>
+#include <stdexcept>
+
 #include <msgpack.hpp>
 
+#include "InstanceId.h"
+#include "utils/GameMath.h"
+
 /**
  * Type alias for object type identification.
  * Used to uniquely identify different classes of replicatable objects.
@@ -17,16 +24,20 @@
 using TypeId = std::string_view;
 
 /**
- * Type alias for instance identification.
- * Used to uniquely identify specific instances of replicatable objects.
+ * Reference to a replicated object or entity that can tell when it has been destroyed.
+ *
+ * Instance IDs are reused once the object holding them is destroyed, so an ID alone may come to refer to a different
+ * object. The generation is incremented each time the ID is released, so a handle kept after its object is destroyed
+ * no longer matches the ID's current generation.
+ *
+ * @see NetworkEngine::getInstanceHandle, NetworkEngine::isInstanceLive
  */
-using InstanceId = uint32_t;
+struct InstanceHandle {
+    InstanceId instanceId{uninitializedInstanceID};
+    uint32_t generation{0};
 
-/**
- * Special instance ID indicating an uninitialized replicatable object.
- * Objects with this ID have not yet been registered with a NetworkEngine.
- */
-static constexpr InstanceId uninitializedInstanceID = 0;
+    bool operator==(const InstanceHandle& other) const = default;
+};
 
 /**
  * Interface base class for replicatable objects, used for network serialization.
@@ -35,6 +46,8 @@ static constexpr InstanceId uninitializedInstanceID = 0;
  * serialization. It provides:
  *  - Methods that get IDs representing the type and instance of the object
  *  - Instance ID initialization
+ *  - An optional position used for interest management
+ *  - A priority used to schedule replication within a player's bandwidth
  *  - msgpack serialization interface
  *
  *  @note objects can instead inherit from Replicatable for automatic registration, unregistration and handing of
@@ -75,6 +88,28 @@ public:
      */
     virtual bool initializeInstanceId(InstanceId instanceId) = 0;
 
+    /**
+     * Gets the position of this object in the world, used to only replicate it to players who can see it.
+     *
+     * Objects without a position are replicated to every player. Override this in objects that exist at a location in
+     * the world.
+     *
+     * @return The position of this object, or std::nullopt if it has no position
+     * @see NetworkEngine::setPlayerView
+     */
+    [[nodiscard]] virtual std::optional<Vector2F> getReplicationPosition() const { return std::nullopt; }
+
+    /**
+     * Gets how important it is to keep this object up to date for players with limited bandwidth.
+     *
+     * Objects with twice the priority are sent roughly twice as often when not every object fits in a player's
+     * bandwidth. The priority is further scaled down by the object's distance from the centre of the player's view.
+     *
+     * @return The priority of this object, 1 by default
+     * @see NetworkEngine::setPlayerBandwidth
+     */
+    [[nodiscard]] virtual float getReplicationPriority() const { return 1.f; }
+
     /**
      * Serializes this object using msgpack.
      *
@@ -107,4 +142,117 @@ public:
     virtual void msgpack_object(msgpack::object *msgpack_o, msgpack::zone &msgpack_z) const = 0;
 };
 
+/**
+ * An object serialized in a batch by a PackBatchFunction, along with what is needed to choose which players it is sent
+ * to.
+ */
+struct PackedObject {
+    InstanceId instanceId;
+    std::optional<Vector2F> position;
+    float priority;
+    // Offset in the buffer of the object's instance ID, which its state directly follows
+    size_t offset;
+};
+
+/**
+ * Function serializing a batch of replicatable objects of the same type as a msgpack map of instance ID to object.
+ *
+ * One function is registered per TypeId, so it can cast the objects to their concrete type and serialize the whole
+ * batch, recording where each object was written along with its position and priority, without a virtual call per
+ * object.
+ *
+ * @param buffer The buffer to append the batch to
+ * @param objects The objects to serialize
+ * @param packed Receives a PackedObject for each object in the same order, or nullptr if they are not needed
+ * @see packReplicatableBatch, Replicated::packBatch
+ */
+using PackBatchFunction = void (*)(msgpack::sbuffer& buffer, std::span<IReplicatable* const> objects,
+                                   PackedObject* packed);
+
+/**
+ * Serializes a batch of replicatable objects through their virtual methods, for objects of any type.
+ * @copydoc PackBatchFunction
+ * @throws std::runtime_error if any of the objects are null
+ */
+inline void packReplicatableBatch(msgpack::sbuffer& buffer, const std::span<IReplicatable* const> objects,
+                                  PackedObject* const packed) {
+    msgpack::packer packer(buffer);
+    packer.pack_map(static_cast<uint32_t>(objects.size()));
+    for (size_t index = 0; index < objects.size(); index++) {
+        const IReplicatable* object = objects[index];
+        if (object == nullptr) {
+            throw std::runtime_error("Attempting to serialize null pointer");
+        }
+        if (packed != nullptr) {
+            packed[index] = {object->getInstanceId(), object->getReplicationPosition(),
+                             object->getReplicationPriority(), buffer.size()};
+        }
+        packer.pack(object->getInstanceId());
+        object->msgpack_pack(packer);
+    }
+}
+
+/**
+ * Interface for a store replicating many entities of one type at once, instead of as individual IReplicatable objects.
+ *
+ * Stores are serialized as a whole into every snapshot, under their TypeId in the same format as a batch of objects.
+ * Players with a view or bandwidth are also sent every entity of each store in every snapshot, so clients should
+ * replace all entities of a store's type with those in each snapshot.
+ *
+ * @see ComponentStore, NetworkEngine::registerReplicatedStore
+ */
+class IReplicatedStore {
+public:
+    virtual ~IReplicatedStore() = default;
+
+    /**
+     * Gets the type identifier the entities in this store are serialized under.
+     * @return The ID representing the type of the entities in this store
+     */
+    [[nodiscard]] virtual TypeId getTypeId() const = 0;
+
+    /**
+     * Gets the number of entities in this store.
+     * @return The number of entities
+     */
+    [[nodiscard]] virtual size_t size() const = 0;
+
+    /**
+     * Serializes every entity in this store as a msgpack map of instance ID to entity.
+     * @param packer The msgpack packer to serialize the entities with
+     */
+    virtual void pack(msgpack::packer<msgpack::sbuffer>& packer) const = 0;
+};
+
+// Vector2F is serialized as an array of its components, as with MSGPACK_DEFINE(x, y)
+// ReSharper disable once CppRedundantNamespaceDefinition - msgpack-c documented syntax
+namespace msgpack {
+MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS) {
+namespace adaptor {
+template <>
+struct pack<Vector2F> {
+    template <typename Stream>
+    packer<Stream>& operator()(packer<Stream>& o, const Vector2F& v) const {
+        o.pack_array(2);
+        o.pack(v.x);
+        o.pack(v.y);
+        return o;
+    }
+};
+
+template <>
+struct convert<Vector2F> {
+    const msgpack::object& operator()(const msgpack::object& o, Vector2F& v) const {
+        if (o.type != msgpack::type::ARRAY || o.via.array.size != 2) {
+            throw msgpack::type_error();
+        }
+        o.via.array.ptr[0].convert(v.x);
+        o.via.array.ptr[1].convert(v.y);
+        return o;
+    }
+};
+} // namespace adaptor
+} // MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS)
+} // namespace msgpack
+
 #endif //REPLICATABLE_H
@@ -9,6 +9,7 @@
 #define REPLICATED_H
 
 #include "NetworkEngine.h"
+#include "ReplicatedFields.h"
 
 /**
  * CRTP base class for replicatable objects that enables automatic network serialization and replication.
@@ -27,6 +28,12 @@
  *    @code
  *    MSGPACK_DEFINE(member1, member2);  // List all members to be replicated
  *    @endcode
+ *    or by declaring each field with the REPLICATED_FIELDS macro, which also allows members to be bit-packed with
+ *    reduced precision and objects to be diffed and hashed:
+ *    @code
+ *    REPLICATED_FIELDS(field("member1", &Derived::member1),
+ *                      field("position", &Derived::position, QuantizedVector2F(QuantizedFloat(-1024.f, 1024.f, 18))));
+ *    @endcode
  *
  * Example usage:
  * @code
@@ -57,7 +64,7 @@ public:
      */
     explicit Replicated(NetworkEngine& networkEngine)
         : networkEngine_(networkEngine) {
-        networkEngine.registerReplicatedObject(static_cast<Derived*>(this));
+        networkEngine.registerReplicatedObject(static_cast<Derived*>(this), &Replicated::packBatch);
     }
 
     /**
@@ -106,6 +113,49 @@ public:
         return false;
     }
 
+    /**
+     * Serializes a batch of objects of the derived type without any virtual calls, allowing the derived class's
+     * serialization to be inlined into the loop.
+     * @copydoc PackBatchFunction
+     * @pre Every object is a Derived
+     */
+    static void packBatch(msgpack::sbuffer& buffer, const std::span<IReplicatable* const> objects,
+                          PackedObject* const packed) {
+        msgpack::packer packer(buffer);
+        packer.pack_map(static_cast<uint32_t>(objects.size()));
+        for (size_t index = 0; index < objects.size(); index++) {
+            const auto& derived = static_cast<const Derived&>(*objects[index]);
+            const InstanceId instanceId = static_cast<const Replicated&>(derived).instanceId_;
+            if (packed != nullptr) {
+                packed[index] = {instanceId, derived.Derived::getReplicationPosition(),
+                                 derived.Derived::getReplicationPriority(), buffer.size()};
+            }
+            packer.pack(instanceId);
+            derived.Derived::msgpack_pack(packer);
+        }
+    }
+
+    /**
+     * Finds the replicated fields that differ between this object and another of the same type.
+     * @param other The object to compare against, e.g. a copy of this object from when it was last replicated
+     * @return A mask with the bit at the index of each field that differs set
+     * @note Requires the derived class to declare its fields with REPLICATED_FIELDS
+     * @see FieldSerializer::diff
+     */
+    [[nodiscard]] uint64_t getChangedFields(const Derived& other) const {
+        return FieldSerializer<Derived>::diff(static_cast<const Derived&>(*this), other);
+    }
+
+    /**
+     * Hashes the replicated state of this object, for cheaply detecting whether it has changed.
+     * @return The hash of the replicated fields
+     * @note Requires the derived class to declare its fields with REPLICATED_FIELDS
+     * @see FieldSerializer::hash
+     */
+    [[nodiscard]] uint64_t getReplicationHash() const {
+        return FieldSerializer<Derived>::hash(static_cast<const Derived&>(*this));
+    }
+
     /**
      * Calls the derived class method for msgpack serialization
      * @copydoc IReplicatable::msgpack_pack
@@ -126,7 +176,7 @@ public:
      * Calls the derived class method for msgpack object conversion
      * @copydoc IReplicatable::msgpack_object
      */
-    void msgpack_object(msgpack::object *msgpack_o, msgpack::zone &msgpack_z) const override{
+    void msgpack_object(msgpack::object *msgpack_o, msgpack::zone &msgpack_z) const override {
         static_cast<const Derived*>(this)->msgpack_object(msgpack_o, msgpack_z);
     }
 
@@ -0,0 +1,355 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef REPLICATEDFIELDS_H
+#define REPLICATEDFIELDS_H
+
+#include <array>
+#include <concepts>
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <msgpack.hpp>
+
+#include "Quantization.h"
+
+/**
+ * Codec storing a field as its own msgpack value, as MSGPACK_DEFINE does.
+ */
+struct MsgpackCodec {};
+
+/**
+ * Requirements for a codec that bit-packs a member of type Member, such as QuantizedFloat or QuantizedBool.
+ */
+template<typename Codec, typename Member>
+concept BitPackedCodec = requires(const Codec codec, BitWriter& writer, BitReader& reader, const Member& value,
+                                  Member& result) {
+    { codec.getBits() } -> std::convertible_to<uint32_t>;
+    codec.write(writer, value);
+    codec.read(reader, result);
+};
+
+/**
+ * Compile-time description of a replicated member of a class.
+ * @see field, REPLICATED_FIELDS
+ */
+template<typename Class, typename Member, typename Codec>
+struct FieldDescriptor {
+    using ClassType = Class;
+    using MemberType = Member;
+    using CodecType = Codec;
+
+    static constexpr bool bitPacked = BitPackedCodec<Codec, Member>;
+
+    std::string_view name;
+    Member Class::* member;
+    Codec codec;
+};
+
+/**
+ * Describes a member replicated as its own msgpack value.
+ * @param name The name of the field
+ * @param member Pointer to the member
+ * @return The field description, for use in REPLICATED_FIELDS
+ */
+template<typename Class, typename Member>
+constexpr FieldDescriptor<Class, Member, MsgpackCodec> field(const std::string_view name, Member Class::* member) {
+    return {name, member, {}};
+}
+
+/**
+ * Describes a member replicated through a codec.
+ * @param name The name of the field
+ * @param member Pointer to the member
+ * @param codec The codec used to store the member, MsgpackCodec or a bit-packing codec such as QuantizedFloat
+ * @return The field description, for use in REPLICATED_FIELDS
+ */
+template<typename Class, typename Member, typename Codec>
+constexpr FieldDescriptor<Class, Member, Codec> field(const std::string_view name, Member Class::* member,
+                                                      const Codec& codec) {
+    static_assert(std::is_same_v<Codec, MsgpackCodec> || BitPackedCodec<Codec, Member>,
+        "Field codecs must be MsgpackCodec or bit-pack the member");
+    return {name, member, codec};
+}
+
+/**
+ * Gets the number of bits a field takes in the bin of bit-packed fields.
+ * @return The bits used by the field's codec, or 0 if it is not bit-packed
+ */
+template<typename Descriptor>
+constexpr size_t getFieldBits(const Descriptor& field) {
+    if constexpr (Descriptor::bitPacked) {
+        return field.codec.getBits();
+    } else {
+        return 0;
+    }
+}
+
+/**
+ * Serialization, diffing and hashing of a class generated at compile time from the fields declared by
+ * REPLICATED_FIELDS.
+ *
+ * Every operation is expanded over the field list at compile time, so they are fully inlined for each class with no
+ * virtual calls or runtime field lookups.
+ *
+ * Objects are serialized as a msgpack array of their msgpack fields in declaration order, followed by a single bin of
+ * every bit-packed field if there are any. A class of only msgpack fields is serialized the same as by MSGPACK_DEFINE,
+ * and a class of only bit-packed fields as the bare bin.
+ *
+ * @tparam Class The class declaring the fields
+ */
+template<typename Class>
+struct FieldSerializer {
+    static constexpr auto fields = Class::replicatedFields();
+    static constexpr size_t fieldCount = std::tuple_size_v<std::remove_const_t<decltype(fields)>>;
+    static_assert(fieldCount <= 64, "Replicated classes can have at most 64 fields");
+
+    template<size_t Index>
+    using Field = std::remove_cvref_t<decltype(std::get<Index>(fields))>;
+
+    static constexpr std::array<std::string_view, fieldCount> fieldNames = std::apply([](const auto&... field) {
+        return std::array<std::string_view, fieldCount>{field.name...};
+    }, fields);
+
+    static constexpr size_t bitPackedFieldCount = std::apply([](const auto&... field) {
+        return (static_cast<size_t>(0) + ... + (std::remove_cvref_t<decltype(field)>::bitPacked ? 1 : 0));
+    }, fields);
+    static constexpr size_t msgpackFieldCount = fieldCount - bitPackedFieldCount;
+
+    static constexpr size_t bitCount = std::apply([](const auto&... field) {
+        return (static_cast<size_t>(0) + ... + getFieldBits(field));
+    }, fields);
+    /** The number of bytes the bit-packed fields are packed into. */
+    static constexpr size_t byteCount = (bitCount + 7) / 8;
+
+    static constexpr bool packsBareBin = msgpackFieldCount == 0 && bitPackedFieldCount > 0;
+    static constexpr uint32_t arraySize = msgpackFieldCount + (bitPackedFieldCount > 0 ? 1 : 0);
+
+    /**
+     * Calls a function with the description of each field in declaration order.
+     * @param visitor Function called with each FieldDescriptor
+     */
+    template<typename Visitor>
+    static constexpr void forEachField(Visitor&& visitor) {
+        std::apply([&](const auto&... field) { (visitor(field), ...); }, fields);
+    }
+
+    template<typename Stream>
+    static void pack(msgpack::packer<Stream>& packer, const Class& object) {
+        if constexpr (!packsBareBin) {
+            packer.pack_array(arraySize);
+            forEachField([&](const auto& field) {
+                if constexpr (!std::remove_cvref_t<decltype(field)>::bitPacked) {
+                    packer.pack(object.*field.member);
+                }
+            });
+        }
+        if constexpr (bitPackedFieldCount > 0) {
+            const auto bytes = writeBits(object);
+            packer.pack_bin(static_cast<uint32_t>(byteCount));
+            packer.pack_bin_body(reinterpret_cast<const char*>(bytes.data()), static_cast<uint32_t>(byteCount));
+        }
+    }
+
+    /**
+     * @throws msgpack::type_error if the msgpack object does not match the fields
+     */
+    static void unpack(const msgpack::object& msgpackObject, Class& object) {
+        if constexpr (packsBareBin) {
+            readBits(msgpackObject, object);
+        } else {
+            if (msgpackObject.type != msgpack::type::ARRAY || msgpackObject.via.array.size != arraySize) {
+                throw msgpack::type_error();
+            }
+            const msgpack::object* element = msgpackObject.via.array.ptr;
+            forEachField([&](const auto& field) {
+                if constexpr (!std::remove_cvref_t<decltype(field)>::bitPacked) {
+                    (element++)->convert(object.*field.member);
+                }
+            });
+            if constexpr (bitPackedFieldCount > 0) {
+                readBits(*element, object);
+            }
+        }
+    }
+
+    static void toObject(msgpack::object* msgpackObject, msgpack::zone& zone, const Class& object) {
+        msgpack::object* binObject = msgpackObject;
+        if constexpr (!packsBareBin) {
+            auto element = static_cast<msgpack::object*>(
+                zone.allocate_align(sizeof(msgpack::object) * (arraySize > 0 ? arraySize : 1)));
+            msgpackObject->type = msgpack::type::ARRAY;
+            msgpackObject->via.array.size = arraySize;
+            msgpackObject->via.array.ptr = element;
+            forEachField([&](const auto& field) {
+                if constexpr (!std::remove_cvref_t<decltype(field)>::bitPacked) {
+                    new (element++) msgpack::object(object.*field.member, zone);
+                }
+            });
+            binObject = element;
+        }
+        if constexpr (bitPackedFieldCount > 0) {
+            const auto bytes = writeBits(object);
+            const auto data = static_cast<char*>(zone.allocate_align(byteCount > 0 ? byteCount : 1, 1));
+            std::memcpy(data, bytes.data(), byteCount);
+            binObject->type = msgpack::type::BIN;
+            binObject->via.bin.size = static_cast<uint32_t>(byteCount);
+            binObject->via.bin.ptr = data;
+        }
+    }
+
+    /**
+     * Finds the fields that differ between two objects.
+     *
+     * Bit-packed fields are compared by their quantized values, so changes too small to be replicated are ignored.
+     *
+     * @return A mask with the bit at the index of each field that differs set
+     */
+    static uint64_t diff(const Class& a, const Class& b) {
+        return diffFields(a, b, std::make_index_sequence<fieldCount>{});
+    }
+
+    /**
+     * Hashes the replicated state of an object, for cheaply detecting whether it has changed.
+     *
+     * Bit-packed fields are hashed by their quantized values, so objects with the same hash replicate identically.
+     *
+     * @return The 64-bit FNV-1a hash of the fields
+     */
+    static uint64_t hash(const Class& object) {
+        uint64_t result = fnvOffsetBasis;
+        forEachField([&](const auto& field) {
+            using Descriptor = std::remove_cvref_t<decltype(field)>;
+            using Member = typename Descriptor::MemberType;
+            if constexpr (Descriptor::bitPacked) {
+                return;
+            } else if constexpr (std::is_arithmetic_v<Member> || std::is_enum_v<Member>) {
+                result = hashBytes(result, &(object.*field.member), sizeof(Member));
+            } else if constexpr (requires(const Member& value) { std::hash<Member>{}(value); }) {
+                const size_t memberHash = std::hash<Member>{}(object.*field.member);
+                result = hashBytes(result, &memberHash, sizeof(memberHash));
+            } else {
+                // Reused so that hashing does not allocate once the buffer has grown
+                thread_local msgpack::sbuffer buffer;
+                buffer.clear();
+                msgpack::pack(buffer, object.*field.member);
+                result = hashBytes(result, buffer.data(), buffer.size());
+            }
+        });
+        if constexpr (bitPackedFieldCount > 0) {
+            const auto bytes = writeBits(object);
+            result = hashBytes(result, bytes.data(), bytes.size());
+        }
+        return result;
+    }
+
+private:
+    static constexpr uint64_t fnvOffsetBasis = 14695981039346656037ull;
+    static constexpr uint64_t fnvPrime = 1099511628211ull;
+
+    static std::array<uint8_t, byteCount> writeBits(const Class& object) {
+        std::array<uint8_t, byteCount> bytes{};
+        BitWriter writer(bytes);
+        forEachField([&](const auto& field) {
+            if constexpr (std::remove_cvref_t<decltype(field)>::bitPacked) {
+                field.codec.write(writer, object.*field.member);
+            }
+        });
+        return bytes;
+    }
+
+    static void readBits(const msgpack::object& msgpackObject, Class& object) {
+        if (msgpackObject.type != msgpack::type::BIN || msgpackObject.via.bin.size != byteCount) {
+            throw msgpack::type_error();
+        }
+        BitReader reader({reinterpret_cast<const uint8_t*>(msgpackObject.via.bin.ptr), byteCount});
+        forEachField([&](const auto& field) {
+            if constexpr (std::remove_cvref_t<decltype(field)>::bitPacked) {
+                field.codec.read(reader, object.*field.member);
+            }
+        });
+    }
+
+    template<size_t... Indices>
+    static uint64_t diffFields(const Class& a, const Class& b, std::index_sequence<Indices...>) {
+        return ((fieldDiffers<Indices>(a, b) ? uint64_t{1} << Indices : 0) | ... | uint64_t{0});
+    }
+
+    template<size_t Index>
+    static bool fieldDiffers(const Class& a, const Class& b) {
+        constexpr auto& field = std::get<Index>(fields);
+        if constexpr (Field<Index>::bitPacked) {
+            // Each field is packed on its own so that neighbouring fields do not affect the comparison
+            constexpr size_t fieldBytes = (field.codec.getBits() + 7) / 8;
+            std::array<uint8_t, fieldBytes> bytesA{};
+            std::array<uint8_t, fieldBytes> bytesB{};
+            BitWriter writerA(bytesA);
+            BitWriter writerB(bytesB);
+            field.codec.write(writerA, a.*field.member);
+            field.codec.write(writerB, b.*field.member);
+            return bytesA != bytesB;
+        } else {
+            static_assert(std::equality_comparable<typename Field<Index>::MemberType>,
+                "Fields replicated through msgpack must be equality comparable to be diffed");
+            return !(a.*field.member == b.*field.member);
+        }
+    }
+
+    static uint64_t hashBytes(uint64_t hash, const void* data, const size_t size) {
+        const auto bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * fnvPrime;
+        }
+        return hash;
+    }
+};
+
+/**
+ * Declares the replicated fields of a class, generating its msgpack serialization, as an alternative to
+ * MSGPACK_DEFINE.
+ *
+ * Each field is described with field(), optionally with a bit-packing codec from Quantization.h to store it with
+ * reduced precision. FieldSerializer can then be used to diff and hash objects of the class.
+ *
+ * Example usage:
+ * @code
+ * class Ship : public Replicated<Ship> {
+ * public:
+ *     static constexpr TypeId typeId{"Ship"};
+ *     REPLICATED_FIELDS(
+ *         field("name", &Ship::name_),
+ *         field("position", &Ship::position_, QuantizedVector2F(QuantizedFloat::withResolution(-1024.f, 1024.f, 1.f / 64))),
+ *         field("rotation", &Ship::rotation_, QuantizedAngle(10)),
+ *         field("thrusting", &Ship::thrusting_, QuantizedBool{}));
+ *
+ * private:
+ *     std::string name_;
+ *     Vector2F position_;
+ *     float rotation_;
+ *     bool thrusting_;
+ * };
+ * @endcode
+ */
+#define REPLICATED_FIELDS(...) \
+    static constexpr auto replicatedFields() { return std::make_tuple(__VA_ARGS__); } \
+    template<typename Packer> \
+    void msgpack_pack(Packer& msgpack_pk) const { \
+        FieldSerializer<std::remove_cvref_t<decltype(*this)>>::pack(msgpack_pk, *this); \
+    } \
+    void msgpack_unpack(const msgpack::object& msgpack_o) { \
+        FieldSerializer<std::remove_cvref_t<decltype(*this)>>::unpack(msgpack_o, *this); \
+    } \
+    template<typename MSGPACK_OBJECT> \
+    void msgpack_object(MSGPACK_OBJECT* msgpack_o, msgpack::zone& msgpack_z) const { \
+        FieldSerializer<std::remove_cvref_t<decltype(*this)>>::toObject(msgpack_o, msgpack_z, *this); \
+    }
+
+#endif //REPLICATEDFIELDS_H
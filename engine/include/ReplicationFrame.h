@@ -0,0 +1,116 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef REPLICATIONFRAME_H
+#define REPLICATIONFRAME_H
+
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <msgpack.hpp>
+
+#include "Replicatable.h"
+
+/**
+ * Immutable copy of the replicated state of every object and store at the end of a tick, which snapshots are built
+ * from instead of the live objects.
+ *
+ * Each object is serialized once when it is captured, along with the position and priority used to choose which
+ * players it is sent to. Snapshots then copy the serialized bytes of the objects they contain, so any number of
+ * snapshots can be built from the frame at once, on any thread, without touching the objects while the game goes on to
+ * change them.
+ *
+ * Example usage:
+ * @code
+ * frame.clear();
+ * frame.addObjects(Ship::typeId, &Ship::packBatch, ships);
+ * frame.addStore(projectiles);
+ *
+ * frame.pack(buffer, visibleObjectIndices);
+ * @endcode
+ */
+class ReplicationFrame {
+public:
+    /**
+     * The captured state of an object.
+     */
+    struct Object {
+        InstanceId instanceId;
+        // Index of the object's type in the frame
+        uint32_t typeIndex;
+        std::optional<Vector2F> position;
+        float priority;
+        // The object's instance ID and state as serialized by its type's PackBatchFunction
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    /**
+     * Removes every captured object and store, keeping the frame's memory to reuse for the next capture.
+     */
+    void clear();
+
+    /**
+     * Captures a batch of objects of the same type.
+     * @param typeId The type of the objects
+     * @param packBatch The function serializing objects of the type
+     * @param objects The objects to capture, does nothing if there are none
+     */
+    void addObjects(TypeId typeId, PackBatchFunction packBatch, std::span<IReplicatable* const> objects);
+
+    /**
+     * Captures every entity in a store, does nothing if it is empty.
+     * @param store The store to capture
+     */
+    void addStore(const IReplicatedStore& store);
+
+    /**
+     * @return Every captured object, grouped by type in the order their types were added
+     */
+    [[nodiscard]] std::span<const Object> getObjects() const { return objects_; }
+
+    /**
+     * @param instanceId The instance ID of an object
+     * @return The index of the object in getObjects(), or std::nullopt if it was not captured
+     */
+    [[nodiscard]] std::optional<uint32_t> findObject(InstanceId instanceId) const;
+
+    /**
+     * Serializes every captured object and store as a msgpack map of TypeId to a map of instance ID to object, the same
+     * as NetworkEngine::getReplicatedObjectsSerialized().
+     * @param buffer The buffer to append the serialized objects to
+     */
+    void pack(msgpack::sbuffer& buffer) const;
+
+    /**
+     * Serializes some of the captured objects, along with every captured store, in the same format as pack().
+     * @param buffer The buffer to append the serialized objects to
+     * @param objectIndices The indices of the objects to serialize in getObjects(), sorted
+     */
+    void pack(msgpack::sbuffer& buffer, std::span<const uint32_t> objectIndices) const;
+
+private:
+    struct Store {
+        TypeId typeId;
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    std::vector<TypeId> typeIds_{};
+    std::vector<Object> objects_{};
+    std::vector<Store> stores_{};
+    // Filled by each type's PackBatchFunction, kept to reuse its memory
+    std::vector<PackedObject> packedObjects_{};
+    // Indexed by instance ID, the index of each captured object plus one, or 0 if it was not captured
+    std::vector<uint32_t> objectIndices_{};
+    msgpack::sbuffer bytes_{};
+
+    void packStores(msgpack::sbuffer& buffer) const;
+};
+
+#endif //REPLICATIONFRAME_H
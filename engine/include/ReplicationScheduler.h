@@ -0,0 +1,78 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef REPLICATIONSCHEDULER_H
+#define REPLICATIONSCHEDULER_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Replicatable.h"
+
+/**
+ * Chooses which of the objects relevant to one player are sent to them each update, within a bandwidth budget.
+ *
+ * Every relevant object has a priority accumulator which grows by the object's priority each second. Each update the
+ * objects are sent in order of their accumulated priority until the player's byte budget is used up, and the
+ * accumulators of the objects sent are reset. Objects that do not fit are deferred, their accumulators continuing to
+ * grow until they win a place, so low priority objects are sent less often rather than never. Objects that have become
+ * relevant but have not been sent yet always come first.
+ *
+ * The budget is earned at the player's bandwidth and does not accumulate beyond a single update. If even the first
+ * object does not fit in a full update's budget it is sent anyway, leaving the budget in debt until it is paid back, so
+ * large objects are never starved but the average bandwidth is still respected.
+ */
+class ReplicationScheduler {
+public:
+    /**
+     * An object relevant to the player this update.
+     */
+    struct Candidate {
+        InstanceId instanceId;
+        /** The priority of the object this update, accumulated per second. */
+        float priority;
+        /** The number of bytes sending the object costs. */
+        uint32_t size;
+    };
+
+    /**
+     * Sets the bandwidth available for the player.
+     * @param bandwidth The bandwidth in bytes per second, or 0 to send every relevant object each update
+     */
+    void setBandwidth(uint32_t bandwidth);
+
+    [[nodiscard]] uint32_t getBandwidth() const { return bandwidth_; }
+
+    /**
+     * Chooses the objects to send this update.
+     *
+     * Objects missing from the candidates are no longer relevant and their accumulated priority is discarded.
+     *
+     * @param candidates The objects relevant to the player, sorted by instance ID
+     * @param deltaTime The time since the last update in seconds
+     * @param selected Cleared and filled with the indices of the candidates to send, in ascending order
+     */
+    void schedule(std::span<const Candidate> candidates, float deltaTime, std::vector<size_t>& selected);
+
+private:
+    struct ObjectState {
+        InstanceId instanceId;
+        float accumulatedPriority;
+        bool sent;
+    };
+
+    uint32_t bandwidth_{0};
+    double byteCredit_{0.0};
+    // Sorted by instance ID, aligned with the candidates of the last update
+    std::vector<ObjectState> objects_{};
+    // Reused between updates to avoid reallocating
+    std::vector<ObjectState> nextObjects_{};
+    std::vector<size_t> order_{};
+};
+
+#endif //REPLICATIONSCHEDULER_H
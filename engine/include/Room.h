@@ -0,0 +1,120 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef ROOM_H
+#define ROOM_H
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+
+#include "NetworkEngine.h"
+#include "NetworkRouter.h"
+#include "utils/AllocationTracker.h"
+#include "utils/Random.h"
+
+/**
+ * How long a tick took, whether it finished before its deadline, and the heap allocations made by the ticking thread
+ * in each phase of it. These include the room's own jobs the thread runs while waiting for them on the pool, but never
+ * another room's tick, see WorkStealingPool::waitFor().
+ *
+ * Allocations are only counted when AllocationTracker::isEnabled(), otherwise every count is 0.
+ */
+struct TickStats {
+    AllocationCounts clientCommands;
+    AllocationCounts gameUpdate;
+    AllocationCounts networkUpdate;
+    std::chrono::steady_clock::duration duration{};
+    bool missedDeadline{false};
+
+    [[nodiscard]] AllocationCounts getTotal() const {
+        AllocationCounts total = clientCommands;
+        total += gameUpdate;
+        total += networkUpdate;
+        return total;
+    }
+};
+
+/**
+ * An independent game instance, with its own NetworkEngine replicating its objects to the players in it.
+ *
+ * Rooms are created by a RoomManager, which shares one network protocol between all of them. Each tick applies the
+ * room's client commands, calls its update handler and then updates its NetworkEngine, the same as the main loop of
+ * a server with a single world.
+ *
+ * @see RoomManager
+ */
+class Room {
+public:
+    using UpdateHandler = std::function<void(float)>;
+
+    /**
+     * @param roomId The unique identifier of the room
+     * @param networkPort The protocol the room's NetworkEngine communicates with its players through
+     * @param randomSeed The seed of the room's random number generator
+     */
+    Room(RoomId roomId, std::unique_ptr<INetworkProtocol> networkPort, uint64_t randomSeed = 0);
+
+    Room(const Room&) = delete;
+    Room& operator=(const Room&) = delete;
+
+    [[nodiscard]] RoomId getId() const { return id_; }
+
+    [[nodiscard]] NetworkEngine& getNetworkEngine() { return networkEngine_; }
+    [[nodiscard]] const NetworkEngine& getNetworkEngine() const { return networkEngine_; }
+
+    /**
+     * Gets the room's random number generator, for the room's update handler to use so that the same seed and client
+     * commands replay the same game. It must only be used by the thread ticking the room, jobs running in parallel
+     * should each seed their own generator with Random::deriveSeed().
+     * @return The room's generator
+     */
+    [[nodiscard]] Random& getRandom() { return random_; }
+
+    /**
+     * Sets the function updating the room's game state each tick.
+     * @param handler Function called with the time since the last tick in seconds
+     */
+    void setUpdateHandler(UpdateHandler handler) { updateHandler_ = std::move(handler); }
+
+    /**
+     * Gets the number of the room's current tick, counting from 1 for its first tick. During a tick this is the number
+     * of the tick running, such as for recording state in a HitboxHistory from the update handler, and between ticks
+     * it is the number of the last tick.
+     * @return The tick number, or 0 if the room has not ticked yet
+     */
+    [[nodiscard]] uint64_t getCurrentTick() const { return currentTick_; }
+
+    /**
+     * Applies the room's client commands, updates its game state and sends its players their snapshots.
+     * @param deltaTime The time since the last tick in seconds
+     * @param deadline The time the tick should finish by, or std::nullopt if it has none
+     */
+    void tick(float deltaTime, std::optional<std::chrono::steady_clock::time_point> deadline = std::nullopt);
+
+    /**
+     * @return The duration and allocations of the last tick
+     */
+    [[nodiscard]] const TickStats& getLastTickStats() const { return lastTickStats_; }
+
+    /**
+     * @return The number of ticks that finished after their deadline
+     */
+    [[nodiscard]] uint64_t getMissedDeadlineCount() const { return missedDeadlineCount_; }
+
+private:
+    RoomId id_;
+    NetworkEngine networkEngine_;
+    Random random_;
+    UpdateHandler updateHandler_{};
+    TickStats lastTickStats_{};
+    uint64_t currentTick_{0};
+    uint64_t missedDeadlineCount_{0};
+};
+
+#endif //ROOM_H
@@ -0,0 +1,188 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef ROOMMANAGER_H
+#define ROOMMANAGER_H
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "NetworkRouter.h"
+#include "Room.h"
+#include "WorkStealingPool.h"
+
+/**
+ * Hosts many independent rooms in one process, sharing a single network protocol between them.
+ *
+ * Each room has its own NetworkEngine, so objects, players and client commands are never shared between rooms.
+ * Clients join the default room when they connect and can be moved between rooms with assignClient(), see
+ * NetworkRouter.
+ *
+ * Rooms are ticked one after another on the calling thread, or as tasks on a pool of worker threads after a call to
+ * setWorkerCount(). Each room's tick must finish before the next tick is due, rooms that take longer have their missed
+ * deadlines counted, see Room::getMissedDeadlineCount().
+ *
+ * Example usage:
+ * @code
+ * RoomManager rooms(std::make_unique<TcpNetworkProtocol>());
+ * Room& lobby = rooms.createRoom();
+ * rooms.setDefaultRoom(lobby.getId());
+ *
+ * rooms.setWorkerCount(WorkStealingPool::getDefaultWorkerCount(), true);
+ *
+ * Room& match = rooms.createRoom();
+ * match.setUpdateHandler([&](const float deltaTime) { updateMatch(match, deltaTime); });
+ * rooms.assignClient(clientId, match.getId());
+ *
+ * while (running) {
+ *     rooms.tick(deltaTime);
+ * }
+ * @endcode
+ */
+class RoomManager {
+public:
+    /**
+     * @param transport The protocol shared by every room
+     */
+    explicit RoomManager(std::unique_ptr<INetworkProtocol> transport);
+
+    RoomManager(const RoomManager&) = delete;
+    RoomManager& operator=(const RoomManager&) = delete;
+
+    /**
+     * Creates an empty room.
+     * @return The room, valid until it is destroyed
+     */
+    Room& createRoom();
+
+    /**
+     * Destroys a room, moving its clients to the default room or disconnecting them if there is no other default room.
+     *
+     * Rooms destroyed while ticking, such as by their own update handler, are destroyed at the end of the tick. Does
+     * nothing if the room does not exist.
+     *
+     * @param roomId The room to destroy
+     */
+    void destroyRoom(RoomId roomId);
+
+    /**
+     * @param roomId The room to find
+     * @return Pointer to the room, or nullptr if it does not exist
+     */
+    [[nodiscard]] Room* findRoom(RoomId roomId) const;
+
+    /**
+     * @return Pointer to the room clients join when they connect, or nullptr if there is none
+     */
+    [[nodiscard]] Room* getDefaultRoom() const;
+
+    /**
+     * Sets the room clients join when they connect.
+     * @param roomId The room
+     * @throws std::invalid_argument if the room does not exist
+     */
+    void setDefaultRoom(RoomId roomId) { router_.setDefaultRoom(roomId); }
+
+    /**
+     * Moves a client to a room, see NetworkRouter::assignClient.
+     * @param clientId The client to move
+     * @param roomId The room to move the client to
+     * @throws std::invalid_argument if the client is not connected or the room does not exist
+     */
+    void assignClient(const ClientId clientId, const RoomId roomId) { router_.assignClient(clientId, roomId); }
+
+    /**
+     * @param clientId The client to find the room of
+     * @return The room the client is in, or nullptr if it is not connected or not in a room
+     */
+    [[nodiscard]] Room* getClientRoom(ClientId clientId) const;
+
+    [[nodiscard]] size_t getRoomCount() const;
+
+    /**
+     * Sets the seed the random number generators of rooms created from now on are seeded from. Each room's generator
+     * is seeded with Random::deriveSeed(seed, roomId), so a server started with the same seed gives each room the same
+     * random numbers.
+     * @param seed The seed, 0 by default
+     * @see Room::getRandom()
+     */
+    void setRandomSeed(const uint64_t seed) {
+        std::lock_guard lock(roomsMutex_);
+        randomSeed_ = seed;
+    }
+
+    /**
+     * Sets the number of worker threads rooms are ticked on.
+     *
+     * With workers, each room's tick runs as a task on a WorkStealingPool, so rooms tick in parallel and the rooms of
+     * an idle worker are stolen by the others. Update handlers of different rooms may then run at the same time, and
+     * must not share state without synchronizing it. Creating, destroying and finding rooms, and moving clients
+     * between them, is safe from any update handler. Each room's NetworkEngine also builds its players' snapshots on
+     * the pool, see NetworkEngine::setSnapshotPool().
+     *
+     * @param workerCount The number of worker threads in addition to the thread calling tick(), or 0 to tick every
+     *                    room on the calling thread
+     * @param pinThreads Whether to pin each worker thread to its own core
+     * @note Must not be called while ticking.
+     */
+    void setWorkerCount(size_t workerCount, bool pinThreads = false);
+
+    [[nodiscard]] size_t getWorkerCount() const { return pool_ ? pool_->getWorkerCount() : 0; }
+
+    /**
+     * Gets the pool rooms are ticked on, for update handlers to split their work over with a JobGraph or
+     * WorkStealingPool::parallelFor. A room waiting for its jobs only helps with them, never with another room's tick,
+     * so its TickStats only measure its own work.
+     * @return The pool, or nullptr if there are no worker threads
+     */
+    [[nodiscard]] WorkStealingPool* getWorkerPool() const { return pool_.get(); }
+
+    /**
+     * Routes every received message to its room, then ticks every room.
+     *
+     * Without worker threads rooms tick in the order they were created. With them, rooms that took longest last tick
+     * start first, so the longest room is not left until the end of the tick. Every room's tick should finish within
+     * deltaTime seconds of the start of this call, those that do not count a missed deadline.
+     *
+     * @param deltaTime The time since the last tick in seconds
+     * @throws The first exception thrown by a room's tick, after every room has finished ticking
+     */
+    void tick(float deltaTime);
+
+private:
+    // Declared before the rooms so that it outlives their endpoints
+    NetworkRouter router_;
+    // Declared before the rooms so that it outlives any snapshots they are still building
+    std::unique_ptr<WorkStealingPool> pool_{};
+    // Guards the rooms, as update handlers running on worker threads may create, destroy and find them
+    mutable std::mutex roomsMutex_;
+    std::vector<std::unique_ptr<Room>> rooms_{};
+    std::unordered_map<RoomId, size_t> roomIndices_{};
+    RoomId nextRoomId_{0};
+    uint64_t randomSeed_{0};
+    bool ticking_{false};
+    std::vector<RoomId> pendingDestroyedRooms_{};
+
+    // Rooms being ticked, kept between ticks to reuse its allocation
+    std::vector<Room*> tickOrder_{};
+    float tickDeltaTime_{0.0f};
+    std::chrono::steady_clock::time_point tickDeadline_{};
+    // Room ticks still running on the pool, waited for on their own so the tick does not also wait for the snapshots
+    // the rooms are building in the background
+    std::atomic<size_t> remainingRoomTicks_{0};
+    std::mutex tickExceptionMutex_;
+    std::exception_ptr tickException_{};
+
+    void destroyRoomLocked(RoomId roomId);
+};
+
+#endif //ROOMMANAGER_H
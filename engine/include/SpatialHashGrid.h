@@ -0,0 +1,173 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef SPATIALHASHGRID_H
+#define SPATIALHASHGRID_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/GameMath.h"
+
+/**
+ * Uniform grid of square cells storing items by position, for finding the items within an area.
+ *
+ * Cells are stored in a hash map keyed by cell coordinate, so the grid is unbounded. Cells are created when an item
+ * first enters them and kept when they empty, so items moving back and forth between cells do not allocate once the
+ * cells they cover exist. Once the empty cells outnumber both the occupied cells and minPrunedEmptyCells they are
+ * all freed, so items roaming across the world do not grow the grid without limit.
+ *
+ * @tparam T The type of item stored, must be hashable and equality comparable (typically a pointer or an ID)
+ */
+template<typename T>
+class SpatialHashGrid {
+public:
+    /** The fewest empty cells that are freed at once. */
+    static constexpr size_t minPrunedEmptyCells = 64;
+
+    /**
+     * @param cellSize The width and height of each cell, ideally close to the size of the areas queried
+     * @throws std::invalid_argument if cellSize is not positive
+     */
+    explicit SpatialHashGrid(const float cellSize) : cellSize_(cellSize) {
+        if (!(cellSize_ > 0.f)) {
+            throw std::invalid_argument("Spatial hash grid cell size must be positive");
+        }
+    }
+
+    /**
+     * Inserts an item at a position, or moves it there if it is already in the grid.
+     * @param item The item to insert
+     * @param position The position of the item
+     */
+    void update(const T& item, const Vector2F& position) {
+        const CellKey key = getCellKey(position);
+        const auto [itemCell, inserted] = itemCells_.try_emplace(item, key);
+        if (!inserted) {
+            if (itemCell->second == key) {
+                return;
+            }
+            eraseFromCell(itemCell->second, item);
+            itemCell->second = key;
+        }
+        const auto [cell, created] = cells_.try_emplace(key);
+        if (!created && cell->second.empty()) {
+            emptyCellCount_--;
+        }
+        cell->second.push_back(item);
+    }
+
+    /**
+     * Removes an item from the grid, does nothing if the item is not in the grid.
+     * @param item The item to remove
+     */
+    void remove(const T& item) {
+        const auto itemCell = itemCells_.find(item);
+        if (itemCell == itemCells_.end()) {
+            return;
+        }
+        eraseFromCell(itemCell->second, item);
+        itemCells_.erase(itemCell);
+    }
+
+    [[nodiscard]] bool contains(const T& item) const { return itemCells_.contains(item); }
+
+    [[nodiscard]] size_t size() const { return itemCells_.size(); }
+
+    [[nodiscard]] float getCellSize() const { return cellSize_; }
+
+    /**
+     * @return The number of cells allocated, including empty cells kept for reuse
+     */
+    [[nodiscard]] size_t getCellCount() const { return cells_.size(); }
+
+    /**
+     * Calls a function with every item in the cells intersecting an area.
+     *
+     * Items in cells that only partially overlap the area are included, so callers needing exact results must check
+     * the position of each item themselves.
+     *
+     * @param area The area to find the items in
+     * @param visitor Function called with each item
+     */
+    template<typename Visitor>
+    void query(const Rectangle2F& area, Visitor&& visitor) const {
+        const int32_t minX = toCellCoordinate(area.x);
+        const int32_t minY = toCellCoordinate(area.y);
+        const int32_t maxX = toCellCoordinate(area.x + area.w);
+        const int32_t maxY = toCellCoordinate(area.y + area.h);
+
+        // Large areas are cheaper to answer by checking every occupied cell than by looking up every covered cell
+        const uint64_t coveredCells = static_cast<uint64_t>(static_cast<int64_t>(maxX) - minX + 1)
+            * static_cast<uint64_t>(static_cast<int64_t>(maxY) - minY + 1);
+        if (coveredCells > cells_.size()) {
+            for (const auto& [key, items]: cells_) {
+                const int32_t x = getCellX(key);
+                const int32_t y = getCellY(key);
+                if (x >= minX && x <= maxX && y >= minY && y <= maxY) {
+                    for (const T& item: items) visitor(item);
+                }
+            }
+            return;
+        }
+
+        for (int32_t y = minY; y <= maxY; y++) {
+            for (int32_t x = minX; x <= maxX; x++) {
+                const auto cell = cells_.find(makeCellKey(x, y));
+                if (cell == cells_.end()) continue;
+                for (const T& item: cell->second) visitor(item);
+            }
+        }
+    }
+
+private:
+    using CellKey = uint64_t;
+
+    float cellSize_;
+    std::unordered_map<CellKey, std::vector<T>> cells_{};
+    std::unordered_map<T, CellKey> itemCells_{};
+    size_t emptyCellCount_{0};
+
+    [[nodiscard]] int32_t toCellCoordinate(const float value) const {
+        const float cell = std::floor(value / cellSize_);
+        if (std::isnan(cell)) return 0;
+        return static_cast<int32_t>(std::clamp(cell, -2147483648.f, 2147483520.f));
+    }
+
+    [[nodiscard]] CellKey getCellKey(const Vector2F& position) const {
+        return makeCellKey(toCellCoordinate(position.x), toCellCoordinate(position.y));
+    }
+
+    static CellKey makeCellKey(const int32_t x, const int32_t y) {
+        return static_cast<CellKey>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(y);
+    }
+
+    static int32_t getCellX(const CellKey key) { return static_cast<int32_t>(static_cast<uint32_t>(key >> 32)); }
+    static int32_t getCellY(const CellKey key) { return static_cast<int32_t>(static_cast<uint32_t>(key)); }
+
+    void eraseFromCell(const CellKey key, const T& item) {
+        const auto cell = cells_.find(key);
+        auto& items = cell->second;
+        const auto it = std::ranges::find(items, item);
+        *it = items.back();
+        items.pop_back();
+        if (!items.empty()) {
+            return;
+        }
+        emptyCellCount_++;
+        if (emptyCellCount_ > std::max(minPrunedEmptyCells, cells_.size() - emptyCellCount_)) {
+            std::erase_if(cells_, [](const auto& emptyCell) { return emptyCell.second.empty(); });
+            emptyCellCount_ = 0;
+        }
+    }
+};
+
+#endif //SPATIALHASHGRID_H
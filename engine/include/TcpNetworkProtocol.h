@@ -10,13 +10,14 @@
 
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <SDL_net.h>
 #include <shared_mutex>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "NetworkProtocol.h"
+#include "utils/RingBuffer.h"
 
 class Socket {
 public:
@@ -37,6 +38,7 @@ public:
 
     std::optional<Message> recieve() override;
     void send(Message message) override;
+    void disconnect(ClientId clientId) override;
 
 private:
     bool running_;
@@ -45,8 +47,14 @@ private:
     std::unique_ptr<Socket> serverSocket_;
     std::unordered_map<ClientId, std::unique_ptr<Socket>> sockets_;
     ClientId nextClientId{};
-    std::queue<Message> incomingMessageQueue_;
-    std::queue<Message> outgoingMessageQueue_;
+    // Ring buffers rather than std::queue, so queueing messages does not allocate once they have grown
+    RingBuffer<Message> incomingMessageQueue_;
+    RingBuffer<Message> outgoingMessageQueue_;
+
+    // Clients whose sockets are waiting to be closed by the receive thread, the only thread that changes the socket set
+    // as SDLNet_CheckSockets() reads it without a lock, guarded by incomingMessageQueueMutex_
+    std::vector<ClientId> serverClosedClients_;
+    std::vector<ClientId> failedClients_;
 
     std::shared_mutex socketsMutex_;
     std::mutex incomingMessageQueueMutex_;
@@ -56,6 +64,9 @@ private:
     std::thread sendThread_;
 
     bool acceptSocket();
+    void closeSockets(const std::vector<ClientId>& clientIds);
+    void closeRequestedSockets();
+    [[nodiscard]] bool isServerClosed(ClientId clientId) const;
     void processReceive();
     void processSend();
 };
@@ -0,0 +1,172 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Fixed pool of worker threads running tasks, with work stealing to balance uneven tasks between them.
+ *
+ * Each worker has its own queue of tasks. Tasks submitted from outside the pool are spread across the queues in turn,
+ * and tasks submitted by a running task go to the queue of the worker running it. Workers run the newest task in
+ * their own queue first, and when it is empty steal the oldest task from another worker's queue, so a worker stuck on
+ * a long task does not hold up the tasks queued behind it.
+ *
+ * The thread calling wait() runs tasks too until every task has finished, so a pool with N workers runs tasks on N + 1
+ * threads.
+ *
+ * Example usage:
+ * @code
+ * WorkStealingPool pool(3);
+ * for (Room* room: rooms) {
+ *     pool.submit([room, deltaTime] { room->tick(deltaTime); });
+ * }
+ * pool.wait();
+ * @endcode
+ */
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * Starts the worker threads.
+     * @param workerCount The number of worker threads, in addition to the thread calling wait()
+     * @param pinThreads Whether to pin each worker to its own core, leaving the first core to the calling thread. Only
+     *                   supported on Linux and Windows, elsewhere the workers are not pinned.
+     */
+    explicit WorkStealingPool(size_t workerCount = getDefaultWorkerCount(), bool pinThreads = false);
+
+    /**
+     * Finishes every queued task and stops the worker threads.
+     */
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * Queues a task to be run by the pool.
+     * @param task The task to run
+     * @param group Identifies the tasks that a waitFor() call given the same group helps with, such as the address of
+     *              the object the tasks belong to, or nullptr if no waitFor() call waits for the task
+     */
+    void submit(Task task, const void* group = nullptr);
+
+    /**
+     * Runs queued tasks on the calling thread until every submitted task has finished.
+     * @throws The first exception thrown by a task since the last call, after every task has finished
+     * @note Must not be called from a task, as the task calling it would never finish
+     */
+    void wait();
+
+    /**
+     * Runs queued tasks of a group on the calling thread until a counter reaches 0, such as a count of the tasks making
+     * up one part of the work queued on the pool.
+     *
+     * Unlike wait(), this can be called from a task or from a thread outside the pool while the pool is running other
+     * work. Only tasks submitted with the same group are run while waiting, so a room's tick waiting for its own
+     * chunks never runs another room's tick, which would hold up the waiting task and count towards its tick's time
+     * and allocations. The calling thread yields rather than sleeps while the group's tasks are running on other
+     * threads, so the counter should reach 0 soon.
+     *
+     * @param counter The counter to wait for, decremented by the tasks being waited for
+     * @param group The group the tasks being waited for were submitted with
+     */
+    void waitFor(const std::atomic<size_t>& counter, const void* group);
+
+    /**
+     * Calls a function over a range of indices split into chunks run in parallel by the pool, returning once every
+     * chunk has finished.
+     *
+     * Unlike wait(), this can be called from a task, such as to split up the work of a room's tick, or from a thread
+     * outside the pool. The calling thread runs the first chunk and then helps with the chunks still queued until every
+     * chunk has finished, see waitFor().
+     *
+     * @tparam Body Function called as body(begin, end) with each chunk of indices
+     * @param count The number of indices, from 0 to count - 1
+     * @param grainSize The number of indices in each chunk
+     * @param body The function to call with each chunk
+     * @throws The first exception thrown by body, after every chunk has finished
+     */
+    template<typename Body>
+    void parallelFor(const size_t count, const size_t grainSize, Body&& body) {
+        using BodyType = std::remove_reference_t<Body>;
+        runParallelFor(count, grainSize, const_cast<void*>(static_cast<const void*>(std::addressof(body))),
+            [](void* context, const size_t begin, const size_t end) {
+                (*static_cast<BodyType*>(context))(begin, end);
+            });
+    }
+
+    [[nodiscard]] size_t getWorkerCount() const { return workers_.size(); }
+
+    /**
+     * @return One less than the number of hardware threads, so the pool and the thread calling wait() use every core
+     */
+    [[nodiscard]] static size_t getDefaultWorkerCount();
+
+private:
+    struct QueuedTask {
+        Task task;
+        const void* group;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<QueuedTask> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> nextQueue_{0};
+    // Tasks queued but not yet started, and tasks submitted but not yet finished
+    std::atomic<size_t> queuedCount_{0};
+    std::atomic<size_t> pendingCount_{0};
+
+    std::mutex sleepMutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable allFinished_;
+    bool stopping_{false};
+
+    std::mutex exceptionMutex_;
+    std::exception_ptr exception_;
+
+    using ChunkFunction = void (*)(void* context, size_t begin, size_t end);
+
+    // Chunks capture only a pointer to this and their index, so submitting them does not allocate
+    struct ParallelFor {
+        void* body;
+        ChunkFunction function;
+        size_t count;
+        size_t grainSize;
+        std::atomic<size_t> remainingChunks;
+        std::mutex exceptionMutex;
+        std::exception_ptr exception;
+
+        void runChunk(size_t chunk);
+    };
+
+    void runParallelFor(size_t count, size_t grainSize, void* body, ChunkFunction function);
+    void runWorker(size_t index);
+    bool tryPop(size_t index, Task& task);
+    bool trySteal(size_t thief, Task& task);
+    bool tryTakeFromGroup(const void* group, Task& task);
+    void run(Task& task);
+    static void pinToCore(std::thread& thread, size_t core);
+};
+
+#endif //WORKSTEALINGPOOL_H
@@ -22,6 +22,7 @@
 #include <memory>
 
 #include "NetworkEngine.h"
+#include "RoomManager.h"
 #ifdef __DEBUG
 #include "GraphicsEngine.h"
 #include "EventEngine.h"
@@ -35,6 +36,8 @@ private:
     static std::shared_ptr<XCube2Engine> instance;
 
     // Initialize subsystems
+    std::shared_ptr<RoomManager> roomManager;
+    // The network engine of the default room, sharing ownership of the room manager
     std::shared_ptr<NetworkEngine> networkEngine;
 #ifdef __DEBUG
     std::shared_ptr<GraphicsEngine> graphicsEngine;
@@ -50,6 +53,9 @@ public:
     static std::shared_ptr<XCube2Engine> getInstance();
     ~XCube2Engine();
 
+    /** @return The rooms hosted by the server, sharing its network protocol */
+    std::shared_ptr<RoomManager> getRoomManager() {return roomManager;}
+    /** @return The network engine of the default room, which clients join when they connect */
     std::shared_ptr<NetworkEngine> getNetworkEngine() {return networkEngine;}
 
 #ifdef __DEBUG
@@ -0,0 +1,103 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef ALLOCATIONTRACKER_H
+#define ALLOCATIONTRACKER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * A number of heap allocations and the bytes they requested.
+ */
+struct AllocationCounts {
+    uint64_t allocations{0};
+    uint64_t bytes{0};
+
+    AllocationCounts operator-(const AllocationCounts& other) const {
+        return {allocations - other.allocations, bytes - other.bytes};
+    }
+
+    AllocationCounts& operator+=(const AllocationCounts& other) {
+        allocations += other.allocations;
+        bytes += other.bytes;
+        return *this;
+    }
+
+    bool operator==(const AllocationCounts& other) const = default;
+};
+
+/**
+ * Counts the heap allocations made by each thread, for finding allocations in code that should not make any.
+ *
+ * Allocations are only counted in executables linking the EngineAllocationHook CMake target, which replaces the global
+ * operator new (see AllocationHook.cpp). The unit tests always link it, the server only does when configured with
+ * ENGINE_TRACK_ALLOCATIONS. Counting adds a thread-local increment to every allocation, so it is cheap enough to leave
+ * enabled while benchmarking.
+ *
+ * @note On platforms where replacing operator new only affects the module it is linked into (e.g. Windows DLLs),
+ * allocations made inside a shared Engine library are not counted.
+ * @see AllocationScope
+ */
+class AllocationTracker {
+public:
+    /**
+     * @return true if allocations are being counted, false if the allocation hook is not linked
+     */
+    [[nodiscard]] static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @return The allocations made by the calling thread since it started
+     */
+    [[nodiscard]] static AllocationCounts getThreadCounts() { return threadCounts_; }
+
+    /**
+     * Records an allocation made by the calling thread, called by the allocation hook.
+     * @param bytes The number of bytes requested
+     */
+    static void recordAllocation(const size_t bytes) {
+        threadCounts_.allocations++;
+        threadCounts_.bytes += bytes;
+    }
+
+    /**
+     * Marks allocations as being counted, called by the allocation hook when the program starts.
+     */
+    static void enable() { enabled_.store(true, std::memory_order_relaxed); }
+
+private:
+    // Constant initialized and trivially destructible, so it is safe to use from operator new at any point in a
+    // thread's lifetime
+    static inline thread_local AllocationCounts threadCounts_{};
+    static inline std::atomic<bool> enabled_{false};
+};
+
+/**
+ * Measures the allocations made by the calling thread from its construction.
+ *
+ * Example usage:
+ * @code
+ * const AllocationScope scope;
+ * networkEngine.update(deltaTime);
+ * const AllocationCounts counts = scope.getCounts();
+ * @endcode
+ */
+class AllocationScope {
+public:
+    AllocationScope() : start_(AllocationTracker::getThreadCounts()) {}
+
+    /**
+     * @return The allocations made by the calling thread since this scope was constructed
+     */
+    [[nodiscard]] AllocationCounts getCounts() const { return AllocationTracker::getThreadCounts() - start_; }
+
+private:
+    AllocationCounts start_;
+};
+
+#endif //ALLOCATIONTRACKER_H
@@ -0,0 +1,99 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef BITSTREAM_H
+#define BITSTREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+
+/**
+ * Writes values of any number of bits into a byte buffer, without padding between them.
+ *
+ * Bits are written least significant first, filling each byte from its least significant bit.
+ */
+class BitWriter {
+public:
+    /**
+     * @param buffer The buffer to write into, which is not cleared so must be zeroed by the caller
+     */
+    explicit BitWriter(const std::span<uint8_t> buffer) : buffer_(buffer) {}
+
+    /**
+     * Writes the lowest bits of a value.
+     * @param value The value to write, any bits above the number written are ignored
+     * @param bits The number of bits to write, at most 32
+     * @throws std::out_of_range if the buffer is too small
+     */
+    void write(const uint32_t value, const uint32_t bits) {
+        if (bitCount_ + bits > buffer_.size() * 8) {
+            throw std::out_of_range("Bit stream buffer overflow");
+        }
+        uint64_t remaining = bits < 32 ? value & ((uint64_t{1} << bits) - 1) : value;
+        size_t byte = bitCount_ / 8;
+        uint32_t offset = bitCount_ % 8;
+        for (uint32_t written = 0; written < bits; byte++, offset = 0) {
+            buffer_[byte] |= static_cast<uint8_t>(remaining << offset);
+            const uint32_t count = 8 - offset;
+            remaining >>= count;
+            written += count;
+        }
+        bitCount_ += bits;
+    }
+
+    void writeBool(const bool value) { write(value ? 1 : 0, 1); }
+
+    [[nodiscard]] size_t getBitCount() const { return bitCount_; }
+
+    /** Gets the number of bytes used so far, including the partly written last byte. */
+    [[nodiscard]] size_t getByteCount() const { return (bitCount_ + 7) / 8; }
+
+private:
+    std::span<uint8_t> buffer_;
+    size_t bitCount_{0};
+};
+
+/**
+ * Reads values written by a BitWriter from a byte buffer.
+ */
+class BitReader {
+public:
+    explicit BitReader(const std::span<const uint8_t> buffer) : buffer_(buffer) {}
+
+    /**
+     * Reads a value of a number of bits.
+     * @param bits The number of bits to read, at most 32
+     * @return The value read
+     * @throws std::out_of_range if there are not enough bits left in the buffer
+     */
+    uint32_t read(const uint32_t bits) {
+        if (bitCount_ + bits > buffer_.size() * 8) {
+            throw std::out_of_range("Bit stream read past end of buffer");
+        }
+        uint64_t value = 0;
+        size_t byte = bitCount_ / 8;
+        uint32_t offset = bitCount_ % 8;
+        for (uint32_t read = 0; read < bits; byte++, offset = 0) {
+            value |= static_cast<uint64_t>(buffer_[byte] >> offset) << read;
+            read += 8 - offset;
+        }
+        bitCount_ += bits;
+        return static_cast<uint32_t>(bits < 32 ? value & ((uint64_t{1} << bits) - 1) : value);
+    }
+
+    bool readBool() { return read(1) != 0; }
+
+    [[nodiscard]] size_t getBitCount() const { return bitCount_; }
+
+private:
+    std::span<const uint8_t> buffer_;
+    size_t bitCount_{0};
+};
+
+#endif //BITSTREAM_H
@@ -0,0 +1,89 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef BUFFERPOOL_H
+#define BUFFERPOOL_H
+
+#include <cstddef>
+
+/**
+ * Process-wide pool of byte blocks in power of two size classes, for buffers that are allocated on one thread and
+ * released on another, such as message bodies passed between the network threads and the game thread.
+ *
+ * Each thread keeps a small cache of free blocks per size class, so most allocations and releases take no lock. When a
+ * thread's cache runs empty it takes a batch of blocks from the shared free list of the size class, and when it fills
+ * it returns a batch, so blocks released on a different thread from the one that allocated them flow back to the
+ * allocating thread in batches rather than one at a time.
+ *
+ * Blocks are never returned to the system, so the pool holds as many blocks of each size class as were in use at once
+ * at its peak. Requests larger than maxBlockSize are not pooled.
+ *
+ * @see PoolAllocator, MessageBuffer::copy
+ */
+class BufferPool {
+public:
+    /** The size of the smallest size class, smaller requests are rounded up to it. */
+    static constexpr size_t minBlockSize = 64;
+    /** The number of size classes, each double the size of the previous. */
+    static constexpr size_t sizeClassCount = 11;
+    /** The size of the largest size class, larger requests are allocated directly with operator new. */
+    static constexpr size_t maxBlockSize = minBlockSize << (sizeClassCount - 1);
+
+    /**
+     * Allocates a block of at least the requested size, aligned for any fundamental type.
+     * @param size The number of bytes requested
+     * @return Pointer to the block
+     * @throws std::bad_alloc if the pool has no free block and a new one cannot be allocated
+     */
+    [[nodiscard]] static void* allocate(size_t size);
+
+    /**
+     * Returns a block to the pool, from any thread.
+     * @param block Pointer to the block, returned by allocate()
+     * @param size The size passed to allocate() for the block
+     */
+    static void deallocate(void* block, size_t size) noexcept;
+
+    /**
+     * @param size The number of bytes requested
+     * @return The size of the block allocated for the request, or size itself if it is not pooled
+     */
+    [[nodiscard]] static constexpr size_t getBlockSize(const size_t size) {
+        if (size > maxBlockSize) return size;
+        size_t blockSize = minBlockSize;
+        while (blockSize < size) blockSize <<= 1;
+        return blockSize;
+    }
+};
+
+/**
+ * Standard allocator drawing from the BufferPool, for containers and shared_ptr control blocks released on a different
+ * thread from the one that allocated them.
+ *
+ * @tparam T The type of object allocated
+ */
+template<typename T>
+struct PoolAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "BufferPool blocks are only aligned for fundamental types");
+
+    using value_type = T;
+
+    PoolAllocator() = default;
+
+    template<typename U>
+    // ReSharper disable once CppNonExplicitConvertingConstructor - required by the Allocator requirements
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    [[nodiscard]] T* allocate(const size_t count) { return static_cast<T*>(BufferPool::allocate(count * sizeof(T))); }
+
+    void deallocate(T* pointer, const size_t count) noexcept { BufferPool::deallocate(pointer, count * sizeof(T)); }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+};
+
+#endif //BUFFERPOOL_H
@@ -0,0 +1,321 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef FIXEDPOINT_H
+#define FIXEDPOINT_H
+
+#include <compare>
+#include <cstdint>
+#include <stdexcept>
+
+#include "GameMath.h"
+
+/**
+ * Signed fixed point number stored in 32 bits, with a fixed number of them after the binary point.
+ *
+ * Arithmetic only uses integer operations, so the same inputs give bit-identical results on every compiler and CPU,
+ * which floats do not guarantee. Simulations needing to be replayed or verified on another machine, such as lockstep
+ * games, can store their state in fixed point and only convert to float for presentation.
+ *
+ * Addition and subtraction wrap on overflow, and multiplication and division round towards negative infinity, so
+ * results are defined for every input.
+ *
+ * @tparam FractionBits The number of bits after the binary point, 16 stores values from -32768 to 32767 in steps
+ *                      of 1/65536
+ */
+template<int FractionBits = 16>
+struct Fixed {
+    static_assert(FractionBits > 0 && FractionBits < 31, "Fixed point numbers need between 1 and 30 fraction bits");
+
+    static constexpr int32_t one = int32_t{1} << FractionBits;
+
+    int32_t raw;
+
+    constexpr Fixed() : raw(0) {}
+    constexpr explicit Fixed(const int value)
+        : raw(static_cast<int32_t>(static_cast<uint32_t>(value) << FractionBits)) {}
+
+    /**
+     * Converts a float to the nearest fixed point value, values outside the range wrap and NaN converts to 0.
+     * @param value The value to convert
+     */
+    constexpr explicit Fixed(const float value) : raw(roundToRaw(value)) {}
+
+    /**
+     * @param raw The underlying integer, the value multiplied by 2^FractionBits
+     * @return The fixed point value
+     */
+    [[nodiscard]] static constexpr Fixed fromRaw(const int32_t raw) {
+        Fixed value;
+        value.raw = raw;
+        return value;
+    }
+
+    [[nodiscard]] constexpr float toFloat() const { return static_cast<float>(raw) / one; }
+
+    /**
+     * @return The largest integer less than or equal to this value
+     */
+    [[nodiscard]] constexpr int toInt() const { return raw >> FractionBits; }
+
+    constexpr explicit operator float() const { return toFloat(); }
+
+    /**
+     * Gets the square root of this value using only integer operations.
+     * @return The square root, rounded down, or 0 for negative values
+     */
+    [[nodiscard]] constexpr Fixed sqrt() const {
+        if (raw <= 0) {
+            return {};
+        }
+        // sqrt(raw / 2^F) * 2^F = sqrt(raw * 2^F)
+        return sqrtOfRawSquare(static_cast<uint64_t>(raw) << FractionBits);
+    }
+
+    /**
+     * Gets the square root of a sum of squared raw values, such as the length of a vector, whose square need not fit
+     * in a Fixed: the root of x.raw * x.raw + y.raw * y.raw is the raw length of (x, y).
+     * @param rawSquare The sum of squares, up to 2^64 - 1
+     * @return The square root, rounded down, wrapping if it is outside the range
+     */
+    [[nodiscard]] static constexpr Fixed sqrtOfRawSquare(const uint64_t rawSquare) {
+        // Found a bit at a time from the highest
+        uint64_t remainder = rawSquare;
+        uint64_t root = 0;
+        uint64_t bit = uint64_t{1} << 62;
+        while (bit > remainder) {
+            bit >>= 2;
+        }
+        while (bit != 0) {
+            if (remainder >= root + bit) {
+                remainder -= root + bit;
+                root = (root >> 1) + bit;
+            } else {
+                root >>= 1;
+            }
+            bit >>= 2;
+        }
+        return fromRaw(static_cast<int32_t>(static_cast<uint32_t>(root)));
+    }
+
+    constexpr auto operator<=>(const Fixed&) const = default;
+
+    constexpr Fixed operator-() const { return fromRaw(static_cast<int32_t>(0u - static_cast<uint32_t>(raw))); }
+
+    constexpr Fixed& operator+=(const Fixed& other) {
+        raw = static_cast<int32_t>(static_cast<uint32_t>(raw) + static_cast<uint32_t>(other.raw));
+        return *this;
+    }
+
+    constexpr Fixed& operator-=(const Fixed& other) {
+        raw = static_cast<int32_t>(static_cast<uint32_t>(raw) - static_cast<uint32_t>(other.raw));
+        return *this;
+    }
+
+    constexpr Fixed& operator*=(const Fixed& other) {
+        raw = static_cast<int32_t>((static_cast<int64_t>(raw) * other.raw) >> FractionBits);
+        return *this;
+    }
+
+    /**
+     * @throws std::invalid_argument if other is 0
+     */
+    constexpr Fixed& operator/=(const Fixed& other) {
+        if (other.raw == 0) {
+            throw std::invalid_argument("Fixed point division by zero");
+        }
+        const int64_t dividend = static_cast<int64_t>(raw) * one;
+        int64_t quotient = dividend / other.raw;
+        // Integer division rounds towards zero, so negative quotients that were not exact are moved down one step
+        if ((dividend % other.raw != 0) && ((dividend < 0) != (other.raw < 0))) {
+            quotient--;
+        }
+        raw = static_cast<int32_t>(quotient);
+        return *this;
+    }
+
+    constexpr Fixed operator+(const Fixed& other) const { return Fixed(*this) += other; }
+    constexpr Fixed operator-(const Fixed& other) const { return Fixed(*this) -= other; }
+    constexpr Fixed operator*(const Fixed& other) const { return Fixed(*this) *= other; }
+    constexpr Fixed operator/(const Fixed& other) const { return Fixed(*this) /= other; }
+
+private:
+    /**
+     * Rounds value * 2^FractionBits to the nearest integer, wrapped to 32 bits. Floats too large to convert to int64_t,
+     * which would be undefined, are multiples of 2^32 and so wrap to 0, as infinities and NaN are made to.
+     */
+    static constexpr int32_t roundToRaw(const float value) {
+        const double scaled = static_cast<double>(value) * one;
+        if (!(scaled > -0x1p62 && scaled < 0x1p62)) {
+            return 0;
+        }
+        return static_cast<int32_t>(static_cast<int64_t>(scaled + (scaled < 0. ? -0.5 : 0.5)));
+    }
+};
+
+/**
+ * Fixed point counterpart to Vector2F, with the same operators and the same results to within the precision of the
+ * fixed point type, computed bit-identically on every platform.
+ *
+ * @tparam FractionBits The number of bits after the binary point of each component
+ * @see Fixed
+ */
+template<int FractionBits = 16>
+struct Vector2Fixed {
+    using Scalar = Fixed<FractionBits>;
+
+    Scalar x;
+    Scalar y;
+
+    constexpr Vector2Fixed() = default;
+    constexpr Vector2Fixed(const Scalar x, const Scalar y) : x(x), y(y) {}
+    constexpr explicit Vector2Fixed(const Scalar s) : x(s), y(s) {}
+
+    /**
+     * Converts each component of a Vector2F to the nearest fixed point value.
+     */
+    constexpr explicit Vector2Fixed(const Vector2F& v) : x(v.x), y(v.y) {}
+
+    constexpr explicit operator Vector2F() const { return {x.toFloat(), y.toFloat()}; }
+
+    /**
+     * Gets the length, found from the squares of the components without rounding them to a Scalar, so it is exact for
+     * every vector whose length is in range, even though its squared length is not.
+     */
+    [[nodiscard]] constexpr Scalar getMagnitude() const {
+        const auto xSquared = static_cast<uint64_t>(static_cast<int64_t>(x.raw) * x.raw);
+        const auto ySquared = static_cast<uint64_t>(static_cast<int64_t>(y.raw) * y.raw);
+        return Scalar::sqrtOfRawSquare(xSquared + ySquared);
+    }
+
+    /**
+     * @throws std::invalid_argument if this vector has a magnitude of 0
+     */
+    [[nodiscard]] constexpr Vector2Fixed getUnitVector() const { return *this / getMagnitude(); }
+
+    /**
+     * Gets the dot product, with both products summed before rounding, wrapping if it is outside the range.
+     */
+    [[nodiscard]] constexpr Scalar dot(const Vector2Fixed& other) const {
+        return fromRawProducts(static_cast<int64_t>(x.raw) * other.x.raw, static_cast<int64_t>(y.raw) * other.y.raw);
+    }
+
+    /**
+     * Gets the z component of the cross product, rounded and wrapped as the dot product is.
+     */
+    [[nodiscard]] constexpr Scalar cross(const Vector2Fixed& other) const {
+        return fromRawProducts(static_cast<int64_t>(x.raw) * other.y.raw, -static_cast<int64_t>(other.x.raw) * y.raw);
+    }
+
+    [[nodiscard]] constexpr Scalar getDistanceTo(const Vector2Fixed& other) const {
+        return (other - *this).getMagnitude();
+    }
+
+    /**
+     * @return The squared distance, wrapping if it is outside the range, as it is for distances over 181 in Q16.16
+     */
+    [[nodiscard]] constexpr Scalar getDistanceSquaredTo(const Vector2Fixed& other) const {
+        const Vector2Fixed delta = other - *this;
+        return delta.dot(delta);
+    }
+
+    constexpr bool operator==(const Vector2Fixed& v) const = default;
+
+    constexpr Vector2Fixed operator-() const { return {-x, -y}; }
+
+    // Vector2Fixed to this
+    constexpr Vector2Fixed& operator+=(const Vector2Fixed& v) { x += v.x; y += v.y; return *this; }
+    constexpr Vector2Fixed& operator-=(const Vector2Fixed& v) { x -= v.x; y -= v.y; return *this; }
+    constexpr Vector2Fixed& operator*=(const Vector2Fixed& v) { x *= v.x; y *= v.y; return *this; }
+    constexpr Vector2Fixed& operator/=(const Vector2Fixed& v) { x /= v.x; y /= v.y; return *this; }
+
+    // Vector2Fixed to Vector2Fixed
+    constexpr Vector2Fixed operator+(const Vector2Fixed& v) const { return Vector2Fixed(*this) += v; }
+    constexpr Vector2Fixed operator-(const Vector2Fixed& v) const { return Vector2Fixed(*this) -= v; }
+    constexpr Vector2Fixed operator*(const Vector2Fixed& v) const { return Vector2Fixed(*this) *= v; }
+    constexpr Vector2Fixed operator/(const Vector2Fixed& v) const { return Vector2Fixed(*this) /= v; }
+
+    // Scalar to this
+    constexpr Vector2Fixed& operator+=(const Scalar& s) { x += s; y += s; return *this; }
+    constexpr Vector2Fixed& operator-=(const Scalar& s) { x -= s; y -= s; return *this; }
+    constexpr Vector2Fixed& operator*=(const Scalar& s) { x *= s; y *= s; return *this; }
+    constexpr Vector2Fixed& operator/=(const Scalar& s) { x /= s; y /= s; return *this; }
+
+    // Scalar to Vector2Fixed
+    constexpr Vector2Fixed operator+(const Scalar& s) const { return Vector2Fixed(*this) += s; }
+    constexpr Vector2Fixed operator-(const Scalar& s) const { return Vector2Fixed(*this) -= s; }
+    constexpr Vector2Fixed operator*(const Scalar& s) const { return Vector2Fixed(*this) *= s; }
+    constexpr Vector2Fixed operator/(const Scalar& s) const { return Vector2Fixed(*this) /= s; }
+
+private:
+    /**
+     * Sums two products of raw components and rounds the sum down to a Scalar. Each product fits in an int64_t but
+     * their sum may not, such as for the dot product of (-32768, -32768) with itself in Q16.16, so they are summed in
+     * unsigned arithmetic, which wraps. The bits kept are below bit 64 for every FractionBits, so they are unchanged.
+     */
+    [[nodiscard]] static constexpr Scalar fromRawProducts(const int64_t first, const int64_t second) {
+        const uint64_t sum = static_cast<uint64_t>(first) + static_cast<uint64_t>(second);
+        return Scalar::fromRaw(static_cast<int32_t>(static_cast<uint32_t>(sum >> FractionBits)));
+    }
+};
+
+/**
+ * Fixed point counterpart to Rectangle2F.
+ *
+ * @tparam FractionBits The number of bits after the binary point of each component
+ * @see Fixed
+ */
+template<int FractionBits = 16>
+struct Rectangle2Fixed {
+    using Scalar = Fixed<FractionBits>;
+    using Vector = Vector2Fixed<FractionBits>;
+
+    Scalar x, y, w, h;
+
+    constexpr Rectangle2Fixed() = default;
+    constexpr Rectangle2Fixed(const Scalar x, const Scalar y, const Scalar w, const Scalar h)
+        : x(x), y(y), w(w), h(h) {}
+
+    /**
+     * Converts each component of a Rectangle2F to the nearest fixed point value.
+     */
+    constexpr explicit Rectangle2Fixed(const Rectangle2F& rect) : x(rect.x), y(rect.y), w(rect.w), h(rect.h) {}
+
+    constexpr explicit operator Rectangle2F() const { return {x.toFloat(), y.toFloat(), w.toFloat(), h.toFloat()}; }
+
+    [[nodiscard]] constexpr bool contains(const Vector& p) const {
+        return p.x >= x && p.x <= x + w
+            && p.y >= y && p.y <= y + h;
+    }
+
+    /**
+     * Checks whether this rectangle and another share any area, as Rectangle2F::intersects() does.
+     */
+    [[nodiscard]] constexpr bool intersects(const Rectangle2Fixed& other) const {
+        const Scalar zero{};
+        return (w > zero) & (h > zero) & (other.w > zero) & (other.h > zero)
+            & (x < other.x + other.w) & (other.x < x + w)
+            & (y < other.y + other.h) & (other.y < y + h);
+    }
+
+    // Rectangle2Fixed += Vector2Fixed
+    constexpr Rectangle2Fixed& operator+=(const Vector& v) { x += v.x; y += v.y; return *this; }
+    // Rectangle2Fixed -= Vector2Fixed
+    constexpr Rectangle2Fixed& operator-=(const Vector& v) { x -= v.x; y -= v.y; return *this; }
+
+    // Rectangle2Fixed + Vector2Fixed
+    constexpr Rectangle2Fixed operator+(const Vector& v) const { return Rectangle2Fixed(*this) += v; }
+    // Rectangle2Fixed - Vector2Fixed
+    constexpr Rectangle2Fixed operator-(const Vector& v) const { return Rectangle2Fixed(*this) -= v; }
+};
+
+// Q16.16, the default format
+typedef Fixed<16> Fixed16;
+typedef Vector2Fixed<16> Vector2Fixed16;
+typedef Rectangle2Fixed<16> Rectangle2Fixed16;
+
+#endif //FIXEDPOINT_H
@@ -11,9 +11,9 @@
 #define GAME_MATH_H
 
 #include <cmath>
-#include <cstdlib>
-#include <SDL_rect.h>
-#include <cmath>
+#include <limits>
+
+#include "Random.h"
 
 static constexpr float PI = 3.14159265358979323846;
 
@@ -30,9 +30,9 @@ struct Vector2F {
 	float x;
 	float y;
 
-	Vector2F() : Vector2F(0.0f, 0.0f) {}
-	Vector2F(const float x, const float y) : x(x), y(y) {}
-    explicit Vector2F(const float s) : x(s), y(s) {}
+	constexpr Vector2F() : Vector2F(0.0f, 0.0f) {}
+	constexpr Vector2F(const float x, const float y) : x(x), y(y) {}
+    constexpr explicit Vector2F(const float s) : x(s), y(s) {}
 
     /**
      * Get the magnitude of this Vector2F (the scalar distance represented by the Vector2F)
@@ -146,9 +146,9 @@ struct Vector2I {
 	int x;
 	int y;
 
-	Vector2I() : Vector2I(0, 0) {}
-	Vector2I(const int x, const int y) : x(x), y(y) {}
-    explicit Vector2I(const int s) : x(s), y(s) {}
+	constexpr Vector2I() : Vector2I(0, 0) {}
+	constexpr Vector2I(const int x, const int y) : x(x), y(y) {}
+    constexpr explicit Vector2I(const int s) : x(s), y(s) {}
 
     static Vector2I zero() { return Vector2I{}; }
 
@@ -237,8 +237,8 @@ inline Vector2F::operator Vector2I() const {
 struct Line2i {
     Vector2I start, end;
 
-    Line2i() : Line2i(Vector2I(), Vector2I()) {}
-    Line2i(const Vector2I& start, const Vector2I& end) : start(start), end(end) {}
+    constexpr Line2i() : Line2i(Vector2I(), Vector2I()) {}
+    constexpr Line2i(const Vector2I& start, const Vector2I& end) : start(start), end(end) {}
 
     [[nodiscard]] Vector2I getNormal() const
     {
@@ -251,8 +251,8 @@ struct Line2i {
 struct Line2f {
 	Vector2F start, end;
 
-	Line2f() : Line2f(Vector2F(), Vector2F()) {}
-	Line2f(const Vector2F& start, const Vector2F& end) : start(start), end(end) {}
+	constexpr Line2f() : Line2f(Vector2F(), Vector2F()) {}
+	constexpr Line2f(const Vector2F& start, const Vector2F& end) : start(start), end(end) {}
 
     [[nodiscard]] Vector2F getNormal() const
     {
@@ -266,30 +266,34 @@ struct Rectangle2F;
 struct Rectangle2I {
 	int x, y, w, h;
 
-    Rectangle2I() : x(0), y(0), w(0), h(0) {}
-	Rectangle2I(const int x, const int y, const int w, const int h) : x(x), y(y), w(w), h(h) {}
-
-	[[nodiscard]] SDL_Rect getSDLRect() const {
-		return { x, y, w, h };
-	}
+    constexpr Rectangle2I() : x(0), y(0), w(0), h(0) {}
+	constexpr Rectangle2I(const int x, const int y, const int w, const int h) : x(x), y(y), w(w), h(h) {}
 
-	[[nodiscard]] bool contains(const Vector2I& p) const {
+	[[nodiscard]] constexpr bool contains(const Vector2I& p) const {
 		return p.x >= x && p.x <= x + w
 			&& p.y >= y && p.y <= y + h;
 	}
 
-	[[nodiscard]] bool intersects(const Rectangle2I& other) const {
-		const SDL_Rect rect1 = getSDLRect();
-		const SDL_Rect rect2 = other.getSDLRect();
-
-		return SDL_HasIntersection(&rect1, &rect2) == SDL_TRUE;
+    /**
+     * Checks whether this rectangle and another share any area, rectangles only touching at their edges and empty
+     * rectangles do not intersect.
+     * @param other The rectangle to check against
+     * @return true if the rectangles overlap
+     */
+	[[nodiscard]] constexpr bool intersects(const Rectangle2I& other) const {
+        // Combined with & rather than && so that every comparison is evaluated without branching
+		return (w > 0) & (h > 0) & (other.w > 0) & (other.h > 0)
+            & (x < other.x + other.w) & (other.x < x + w)
+            & (y < other.y + other.h) & (other.y < y + h);
 	}
 
-	[[nodiscard]] bool intersects(const Line2i& line) const {
-		int x1 = line.start.x, y1 = line.start.y, x2 = line.end.x, y2 = line.end.y;
-		const SDL_Rect rect = { x, y, w, h };
-		return SDL_IntersectRectAndLine(&rect, &x1, &y1, &x2, &y2) == SDL_TRUE;
-	}
+    /**
+     * Checks whether any part of a line segment is inside this rectangle, including its edges.
+     * @param line The segment to check
+     * @return true if the segment touches the rectangle
+     * @see Rectangle2F::intersects(const Line2f&)
+     */
+	[[nodiscard]] constexpr bool intersects(const Line2i& line) const;
 
     // Rectangle2I += Vector2I
     Rectangle2I& operator += (const Vector2I& v) { x += v.x; y += v.y; return *this; }
@@ -308,30 +312,45 @@ struct Rectangle2I {
 struct Rectangle2F {
 	float x, y, w, h;
 
-    Rectangle2F() : x(0.f), y(0.f), w(0.f), h(0.f) {}
-	Rectangle2F(const float x, const float y, const float w, const float h) : x(x), y(y), w(w), h(h) {}
-
-	[[nodiscard]] SDL_FRect getSDLRect() const {
-		SDL_FRect rect = { x, y, w, h };
-		return rect;
-	}
+    constexpr Rectangle2F() : x(0.f), y(0.f), w(0.f), h(0.f) {}
+	constexpr Rectangle2F(const float x, const float y, const float w, const float h) : x(x), y(y), w(w), h(h) {}
 
-	[[nodiscard]] inline bool contains(const Vector2F& p) const {
+	[[nodiscard]] constexpr bool contains(const Vector2F& p) const {
 		return p.x >= x && p.x <= x + w
 			&& p.y >= y && p.y <= y + h;
 	}
 
-	[[nodiscard]] inline bool intersects(const Rectangle2F& other) const {
-		SDL_FRect rect1 = getSDLRect();
-		SDL_FRect rect2 = other.getSDLRect();
-
-		return SDL_HasIntersectionF(&rect1, &rect2) == SDL_TRUE;
+    /**
+     * Checks whether this rectangle and another share any area, rectangles only touching at their edges and empty
+     * rectangles do not intersect.
+     * @param other The rectangle to check against
+     * @return true if the rectangles overlap
+     * @see getIntersectionMask() to check many rectangles at once
+     */
+	[[nodiscard]] constexpr bool intersects(const Rectangle2F& other) const {
+        // Combined with & rather than && so that every comparison is evaluated without branching
+		return (w > 0.f) & (h > 0.f) & (other.w > 0.f) & (other.h > 0.f)
+            & (x < other.x + other.w) & (other.x < x + w)
+            & (y < other.y + other.h) & (other.y < y + h);
 	}
 
-	[[nodiscard]] bool intersects(const Line2f& line) const {
-		float x1 = line.start.x, y1 = line.start.y, x2 = line.end.x, y2 = line.end.y;
-		const SDL_FRect rect = { x, y, w, h };
-		return SDL_IntersectFRectAndLine(&rect, &x1, &y1, &x2, &y2) == SDL_TRUE;
+    /**
+     * Checks whether any part of a line segment is inside this rectangle, including its edges.
+     *
+     * Uses the Liang-Barsky algorithm: the segment is clipped to the range of its length between each pair of edges,
+     * and touches the rectangle if the two ranges overlap.
+     *
+     * @param line The segment to check
+     * @return true if the segment touches the rectangle, false if it misses or the rectangle is empty, as in
+     *         intersects(const Rectangle2F&)
+     */
+	[[nodiscard]] constexpr bool intersects(const Line2f& line) const {
+        const Vector2F direction(line.end.x - line.start.x, line.end.y - line.start.y);
+        const Vector2F entryX = getSegmentSlab(line.start.x, direction.x, x, x + w);
+        const Vector2F entryY = getSegmentSlab(line.start.y, direction.y, y, y + h);
+        const float enter = entryX.x > entryY.x ? entryX.x : entryY.x;
+        const float exit = entryX.y < entryY.y ? entryX.y : entryY.y;
+        return (w > 0.f) & (h > 0.f) & (enter <= exit) & (enter <= 1.f) & (exit >= 0.f);
 	}
 
     // Rectangle2F += Vector2F
@@ -350,6 +369,29 @@ struct Rectangle2F {
                            static_cast<int>(w),
                            static_cast<int>(h)};
     }
+
+private:
+    /**
+     * Finds where a segment crosses a slab, the space between two parallel edges, along one axis.
+     * @param start The segment's start along the axis
+     * @param direction The segment's length along the axis
+     * @param min, max The edges of the slab
+     * @return The fractions of the segment's length at which it enters and exits the slab, as x and y. A segment
+     * parallel to the slab is inside it along its whole length or not at all.
+     */
+    [[nodiscard]] static constexpr Vector2F getSegmentSlab(const float start, const float direction, const float min,
+                                                           const float max) {
+        constexpr float infinity = std::numeric_limits<float>::infinity();
+        const bool parallel = direction == 0.f;
+        const bool inside = (start >= min) & (start <= max);
+        // Divide by 1 rather than 0 for parallel segments, their result is replaced below
+        const float scale = 1.f / (parallel ? 1.f : direction);
+        const float first = (min - start) * scale;
+        const float second = (max - start) * scale;
+        const float enter = parallel ? (inside ? -infinity : infinity) : (first < second ? first : second);
+        const float exit = parallel ? (inside ? infinity : -infinity) : (first < second ? second : first);
+        return {enter, exit};
+    }
 };
 
 inline Rectangle2I::operator Rectangle2F() const {
@@ -359,6 +401,13 @@ inline Rectangle2I::operator Rectangle2F() const {
                        static_cast<float>(h)};
 }
 
+constexpr bool Rectangle2I::intersects(const Line2i& line) const {
+    const Rectangle2F rectangle(static_cast<float>(x), static_cast<float>(y), static_cast<float>(w),
+                                static_cast<float>(h));
+    return rectangle.intersects(Line2f(Vector2F(static_cast<float>(line.start.x), static_cast<float>(line.start.y)),
+                                       Vector2F(static_cast<float>(line.end.x), static_cast<float>(line.end.y))));
+}
+
 typedef Rectangle2I Rect;
 typedef Rectangle2F RectF;
 
@@ -370,13 +419,15 @@ struct Dimension2i {
 };
 
 /**
-* Init srand() before to get different random values every time you start program
-*
-* @return
-*			a random integer value between "min" and "max", both inclusive
-*/
+ * Gets a random integer from the calling thread's generator, see getThreadRandom(). Seed it with seedThreadRandom() to
+ * get the same values every time the program runs.
+ *
+ * @return
+ *			a random integer value between "min" and "max", both inclusive
+ * @throws std::invalid_argument if min is greater than max
+ */
 inline int getRandom(const int min, const int max) {
-	return (int)(rand() % (max - min)) + min;
+	return getThreadRandom().nextInt(min, max);
 }
 
 #endif
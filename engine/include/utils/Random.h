@@ -0,0 +1,214 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <span>
+#include <stdexcept>
+
+/**
+ * Fast seedable pseudo-random number generator, using the xoshiro256** algorithm.
+ *
+ * Each generator has its own 32 bytes of state, so generators used by different threads never contend, and a
+ * generator seeded with the same value always produces the same sequence, so a room's random events can be replayed.
+ * Ranges are reduced without the bias of taking a modulo. It meets the standard UniformRandomBitGenerator
+ * requirements, so it can also be used with the distributions in <random>.
+ *
+ * Example usage:
+ * @code
+ * Random random(Random::deriveSeed(matchSeed, room.getId()));
+ * const int damage = random.nextInt(10, 20);
+ * random.fillFloats(spawnAngles, 0.f, 2.f * PI);
+ * @endcode
+ *
+ * @see getThreadRandom() for a generator per thread
+ */
+class Random {
+public:
+    using result_type = uint64_t;
+
+    /**
+     * @param seed The seed, generators with the same seed produce the same sequence
+     */
+    explicit Random(uint64_t seed) {
+        // The state is filled from the seed with SplitMix64, which never leaves it all zero
+        for (uint64_t& word: state_) {
+            word = splitMix(seed);
+        }
+    }
+
+    /**
+     * Mixes a seed with a stream number, giving independent seeds for many generators from one seed, such as one per
+     * room or per parallel job.
+     * @param seed The seed shared by the generators
+     * @param stream The number of the generator
+     * @return The generator's seed
+     */
+    [[nodiscard]] static constexpr uint64_t deriveSeed(uint64_t seed, const uint64_t stream) {
+        seed ^= stream * 0xD1B54A32D192ED03ull;
+        return splitMix(seed);
+    }
+
+    [[nodiscard]] static constexpr result_type min() { return 0; }
+    [[nodiscard]] static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    /**
+     * @return 64 random bits
+     */
+    result_type operator()() {
+        const uint64_t result = std::rotl(state_[1] * 5, 7) * 9;
+        const uint64_t shifted = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= shifted;
+        state_[3] = std::rotl(state_[3], 45);
+        return result;
+    }
+
+    /**
+     * @param min The smallest value returned
+     * @param max The largest value returned
+     * @return A random integer between min and max, both inclusive, each equally likely
+     * @throws std::invalid_argument if min is greater than max
+     */
+    int nextInt(const int min, const int max) {
+        if (min > max) {
+            throw std::invalid_argument("Random range minimum must not be greater than its maximum");
+        }
+        const uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(max) - min) + 1;
+        return static_cast<int>(static_cast<int64_t>(min) + reduce(range));
+    }
+
+    /**
+     * @param min The smallest value returned
+     * @param max The value returned values are less than
+     * @return A random float from min up to but not including max
+     */
+    float nextFloat(const float min, const float max) {
+        return toFloat(static_cast<uint32_t>((*this)() >> 32), min, max);
+    }
+
+    /**
+     * Maps random bits to a float in a range, as nextFloat() does with the bits it draws.
+     * @param bits 32 random bits, of which the top 24 are used
+     * @param min The smallest value returned
+     * @param max The value returned values are less than
+     * @return A float from min up to but not including max
+     */
+    [[nodiscard]] static float toFloat(const uint32_t bits, const float min, const float max) {
+        // The product is rounded, which can round values just under max up to it
+        return std::min(min + toUnitFloat(bits) * (max - min), std::nextafter(max, min));
+    }
+
+    /**
+     * Fills an array with random integers, as nextInt() would return each one.
+     * @param values The array to fill
+     * @param min The smallest value
+     * @param max The largest value
+     * @throws std::invalid_argument if min is greater than max
+     */
+    void fillInts(const std::span<int> values, const int min, const int max) {
+        if (min > max) {
+            throw std::invalid_argument("Random range minimum must not be greater than its maximum");
+        }
+        const uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(max) - min) + 1;
+        for (int& value: values) {
+            value = static_cast<int>(static_cast<int64_t>(min) + reduce(range));
+        }
+    }
+
+    /**
+     * Fills an array with random floats, two from each 64 random bits.
+     * @param values The array to fill
+     * @param min The smallest value
+     * @param max The value every value is less than
+     */
+    void fillFloats(const std::span<float> values, const float min, const float max) {
+        size_t index = 0;
+        for (; index + 1 < values.size(); index += 2) {
+            const uint64_t bits = (*this)();
+            values[index] = toFloat(static_cast<uint32_t>(bits >> 32), min, max);
+            values[index + 1] = toFloat(static_cast<uint32_t>(bits), min, max);
+        }
+        if (index < values.size()) {
+            values[index] = nextFloat(min, max);
+        }
+    }
+
+private:
+    std::array<uint64_t, 4> state_{};
+
+    static constexpr uint64_t splitMix(uint64_t& state) {
+        uint64_t result = state += 0x9E3779B97F4A7C15ull;
+        result = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9ull;
+        result = (result ^ (result >> 27)) * 0x94D049BB133111EBull;
+        return result ^ (result >> 31);
+    }
+
+    // Uses the top 24 bits, as many as a float can hold exactly, so the result is never rounded up to 1
+    static float toUnitFloat(const uint32_t bits) {
+        return static_cast<float>(bits >> 8) * 0x1.0p-24f;
+    }
+
+    /**
+     * Reduces 32 random bits to a range with Lemire's multiply and shift, rejecting the few values that would make
+     * some results more likely than others.
+     * @param range The number of possible results, from 1 to 2^32
+     * @return A value from 0 to range - 1
+     */
+    uint64_t reduce(const uint64_t range) {
+        if (range > std::numeric_limits<uint32_t>::max()) {
+            return (*this)() >> 32;
+        }
+        const auto range32 = static_cast<uint32_t>(range);
+        uint64_t product = ((*this)() >> 32) * range32;
+        auto low = static_cast<uint32_t>(product);
+        if (low < range32) {
+            // 2^32 % range, the number of values that would be mapped to some results once more than to others
+            const uint32_t threshold = (0u - range32) % range32;
+            while (low < threshold) {
+                product = ((*this)() >> 32) * range32;
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        return product >> 32;
+    }
+};
+
+/**
+ * Gets the calling thread's generator, seeded unpredictably the first time each thread uses it unless
+ * seedThreadRandom() is called first.
+ *
+ * Game code needing reproducible results should use a generator with a known seed instead, such as
+ * Room::getRandom().
+ *
+ * @return The thread's generator
+ */
+inline Random& getThreadRandom() {
+    thread_local Random random(std::random_device{}() ^ (static_cast<uint64_t>(std::random_device{}()) << 32));
+    return random;
+}
+
+/**
+ * Reseeds the calling thread's generator.
+ * @param seed The seed
+ */
+inline void seedThreadRandom(const uint64_t seed) {
+    getThreadRandom() = Random(seed);
+}
+
+#endif //RANDOM_H
@@ -0,0 +1,119 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <bit>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * FIFO queue stored in a circular array, a drop-in replacement for std::queue that does not allocate once it has grown
+ * to hold the most elements it is used with.
+ *
+ * std::queue's default std::deque allocates and frees a block every few hundred bytes pushed through it, even when it
+ * never holds more than a few elements. The ring buffer instead doubles its capacity when full and reuses its slots
+ * from then on.
+ *
+ * @tparam T The type of element stored, must be default constructible and move assignable
+ */
+template<typename T>
+class RingBuffer {
+public:
+    /**
+     * @param capacity The number of elements to allocate space for, rounded up to a power of two
+     */
+    explicit RingBuffer(const size_t capacity = 16) : slots_(std::bit_ceil(capacity > 0 ? capacity : 1)) {}
+
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+    [[nodiscard]] size_t size() const { return size_; }
+    [[nodiscard]] size_t capacity() const { return slots_.size(); }
+
+    /**
+     * Adds an element to the back of the queue, doubling the capacity if it is full.
+     * @param value The element to add
+     */
+    void push(T value) {
+        if (size_ == slots_.size()) {
+            grow();
+        }
+        slots_[(head_ + size_) & (slots_.size() - 1)] = std::move(value);
+        size_++;
+    }
+
+    /**
+     * @return The element at the front of the queue
+     * @pre !empty()
+     */
+    [[nodiscard]] T& front() { return slots_[head_]; }
+    [[nodiscard]] const T& front() const { return slots_[head_]; }
+
+    /**
+     * Removes the element at the front of the queue, releasing any resources it holds.
+     * @pre !empty()
+     */
+    void pop() {
+        slots_[head_] = T{};
+        head_ = (head_ + 1) & (slots_.size() - 1);
+        size_--;
+    }
+
+    /**
+     * Removes every element matching a predicate, keeping the rest in order.
+     * @param predicate Function called with each element, returning true if it should be removed
+     * @return The number of elements removed
+     */
+    template<typename Predicate>
+    size_t eraseIf(Predicate&& predicate) {
+        const size_t mask = slots_.size() - 1;
+        size_t kept = 0;
+        for (size_t index = 0; index < size_; index++) {
+            T& element = slots_[(head_ + index) & mask];
+            if (predicate(std::as_const(element))) {
+                continue;
+            }
+            if (kept != index) {
+                slots_[(head_ + kept) & mask] = std::move(element);
+            }
+            kept++;
+        }
+        for (size_t index = kept; index < size_; index++) {
+            slots_[(head_ + index) & mask] = T{};
+        }
+        const size_t removed = size_ - kept;
+        size_ = kept;
+        return removed;
+    }
+
+    /**
+     * Removes every element, keeping the capacity.
+     */
+    void clear() {
+        while (!empty()) {
+            pop();
+        }
+        head_ = 0;
+    }
+
+private:
+    std::vector<T> slots_;
+    size_t head_{0};
+    size_t size_{0};
+
+    void grow() {
+        std::vector<T> slots(slots_.size() * 2);
+        for (size_t index = 0; index < size_; index++) {
+            slots[index] = std::move(slots_[(head_ + index) & (slots_.size() - 1)]);
+        }
+        slots_ = std::move(slots);
+        head_ = 0;
+    }
+};
+
+#endif //RINGBUFFER_H
@@ -0,0 +1,89 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef VECTORBATCH_H
+#define VECTORBATCH_H
+
+#include <cstdint>
+#include <span>
+
+#include "GameMath.h"
+
+// Batch kernels over vectors stored as a structure of arrays, with the x and y components of each vector at the same
+// index of separate float arrays. Each kernel processes 8 floats at a time with AVX2 when the engine is built with
+// ENGINE_ENABLE_AVX2, 4 at a time with SSE2 on other x86-64 builds, and one at a time elsewhere, with any remainder
+// processed one at a time. The arrays given to a kernel must all be the same length.
+
+/**
+ * @return The name of the instruction set the kernels were built for: "AVX2", "SSE2" or "Scalar"
+ */
+const char* getVectorBatchInstructionSet();
+
+/**
+ * Moves each position by its velocity over a time, as positions += velocities * deltaTime.
+ * @param positionsX, positionsY The positions to move
+ * @param velocitiesX, velocitiesY The velocity of each position
+ * @param deltaTime The time to move for
+ */
+void integratePositions(std::span<float> positionsX, std::span<float> positionsY,
+                        std::span<const float> velocitiesX, std::span<const float> velocitiesY, float deltaTime);
+
+/**
+ * Moves each position by its velocity over a time scaled per position, as positions += velocities * timeScales *
+ * deltaTime, such as a scale of 0 for bodies that never move.
+ * @param positionsX, positionsY The positions to move
+ * @param velocitiesX, velocitiesY The velocity of each position
+ * @param timeScales The scale of the time each position moves for
+ * @param deltaTime The time to move for
+ */
+void integratePositions(std::span<float> positionsX, std::span<float> positionsY,
+                        std::span<const float> velocitiesX, std::span<const float> velocitiesY,
+                        std::span<const float> timeScales, float deltaTime);
+
+/**
+ * Multiplies every value by a factor.
+ * @param values The values to scale
+ * @param factor The factor to multiply by
+ */
+void scaleValues(std::span<float> values, float factor);
+
+/**
+ * Adds a multiple of each addend to each value, as values += addends * factor.
+ * @param values The values to add to
+ * @param addends The value to add to each value
+ * @param factor The factor to multiply each addend by
+ */
+void addScaledValues(std::span<float> values, std::span<const float> addends, float factor);
+
+/**
+ * Gets the squared distance from each position to a point.
+ * @param positionsX, positionsY The positions to measure from
+ * @param point The point to measure to
+ * @param distancesSquared Receives the squared distance of each position
+ */
+void getDistancesSquared(std::span<const float> positionsX, std::span<const float> positionsY, Vector2F point,
+                         std::span<float> distancesSquared);
+
+/**
+ * Finds the boxes that overlap an area, including boxes only touching its edges.
+ * @param minX, minY, maxX, maxY The bounds of each box
+ * @param area The area to test the boxes against
+ * @param mask Receives one bit per box, with bit (i % 64) of mask[i / 64] set if box i overlaps the area. It must hold
+ * at least (boxes + 63) / 64 words, and the bits after the last box are cleared.
+ */
+void getOverlapMask(std::span<const float> minX, std::span<const float> minY, std::span<const float> maxX,
+                    std::span<const float> maxY, const Rectangle2F& area, std::span<uint64_t> mask);
+
+/**
+ * Finds the rectangles that intersect an area, as Rectangle2F::intersects() does for each one.
+ * @param rectangles The rectangles to test
+ * @param area The area to test the rectangles against
+ * @param mask Receives one bit per rectangle, laid out as by getOverlapMask()
+ */
+void getIntersectionMask(std::span<const Rectangle2F> rectangles, const Rectangle2F& area, std::span<uint64_t> mask);
+
+#endif //VECTORBATCH_H
@@ -13,15 +13,20 @@
 //
 
 #include "AbstractServer.h"
+
+#include <thread>
+
 #include "utils/EngineCommon.h"
 
 using namespace std;
 
-AbstractServer::AbstractServer() : running(true), paused(false), serverTime(0.0)
+AbstractServer::AbstractServer() : running(true), paused(false), serverTime(0.0), lastTickStats()
 {
     const std::shared_ptr<XCube2Engine> engine = XCube2Engine::getInstance();
 
+    roomManager = engine->getRoomManager();
     networkEngine = engine->getNetworkEngine();
+    roomManager->getDefaultRoom()->setUpdateHandler([this](const float deltaTime) { update(deltaTime); });
 #ifdef __DEBUG
     graphicsEngine = engine->getGraphicsEngine();
     eventEngine = engine->getEventEngine();
@@ -56,6 +61,9 @@ AbstractServer::~AbstractServer()
 int AbstractServer::runMainLoop() {
 #ifdef __DEBUG
     debug("Entered Main Loop");
+#else
+    constexpr auto tickInterval = std::chrono::microseconds(16000);
+    auto nextTick = std::chrono::steady_clock::now();
 #endif
 
     while (running)
@@ -74,8 +82,11 @@ int AbstractServer::runMainLoop() {
 
         if (!paused) {
             constexpr float deltaTime = 0.016;	// 60 times a sec
-            update(deltaTime);
-            networkEngine->update();
+            // Ticks every room, update() is called by the default room's tick
+            roomManager->tick(deltaTime);
+            if (const Room* defaultRoom = roomManager->getDefaultRoom()) {
+                lastTickStats = defaultRoom->getLastTickStats();
+            }
             serverTime += deltaTime;
         }
 
@@ -85,6 +96,15 @@ int AbstractServer::runMainLoop() {
         graphicsEngine->showScreen();
 
         graphicsEngine->adjustFPSDelay(16);	// atm hardcoded to ~60 FPS
+#else
+        // Without a frame delay to pace the loop, wait for the next tick to be due
+        nextTick += tickInterval;
+        const auto now = std::chrono::steady_clock::now();
+        if (nextTick < now) {
+            // Ticks that overran are not caught up on, which would only make the following ticks overrun too
+            nextTick = now;
+        }
+        std::this_thread::sleep_until(nextTick);
 #endif
     }
 
@@ -95,6 +115,10 @@ int AbstractServer::runMainLoop() {
     return 0;
 }
 
+uint64_t AbstractServer::getCurrentTick() const {
+    const Room* defaultRoom = roomManager->getDefaultRoom();
+    return defaultRoom ? defaultRoom->getCurrentTick() : 0;
+}
 
 #ifdef __DEBUG
 void AbstractServer::handleMouseEvents() {
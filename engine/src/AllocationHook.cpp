@@ -0,0 +1,124 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+// Replaces the global operator new and delete to count allocations with AllocationTracker. This file is compiled
+// directly into executables through the EngineAllocationHook CMake target rather than into the Engine library, as
+// replacement allocation functions must be defined exactly once per program.
+
+#include <cstdlib>
+#include <new>
+
+#include "utils/AllocationTracker.h"
+
+namespace {
+[[maybe_unused]] const bool allocationHookEnabled = (AllocationTracker::enable(), true);
+
+void* allocate(std::size_t size) {
+    AllocationTracker::recordAllocation(size);
+    if (size == 0) {
+        size = 1;
+    }
+    while (true) {
+        if (void* pointer = std::malloc(size)) {
+            return pointer;
+        }
+        const std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* allocateAligned(std::size_t size, const std::align_val_t alignment) {
+    AllocationTracker::recordAllocation(size);
+    const auto align = static_cast<std::size_t>(alignment);
+    // aligned_alloc requires the size to be a non-zero multiple of the alignment
+    size = size == 0 ? align : (size + align - 1) / align * align;
+    while (true) {
+#ifdef _WIN32
+        if (void* pointer = _aligned_malloc(size, align)) {
+#else
+        if (void* pointer = std::aligned_alloc(align, size)) {
+#endif
+            return pointer;
+        }
+        const std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void deallocateAligned(void* pointer) {
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+}
+
+// ReSharper disable CppParameterNamesMismatch - the standard declarations are unnamed
+
+void* operator new(const std::size_t size) { return allocate(size); }
+void* operator new[](const std::size_t size) { return allocate(size); }
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment) {
+    return allocateAligned(size, alignment);
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment) {
+    return allocateAligned(size, alignment);
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    try {
+        return allocateAligned(size, alignment);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    try {
+        return allocateAligned(size, alignment);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, std::align_val_t) noexcept { deallocateAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { deallocateAligned(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { deallocateAligned(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { deallocateAligned(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { deallocateAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { deallocateAligned(pointer); }
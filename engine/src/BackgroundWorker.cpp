@@ -0,0 +1,79 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include "BackgroundWorker.h"
+
+#include <stdexcept>
+#include <utility>
+
+BackgroundWorker::BackgroundWorker(Job job)
+    : job_(std::move(job))
+    , thread_(&BackgroundWorker::run, this) {
+}
+
+BackgroundWorker::~BackgroundWorker() {
+    try {
+        wait();
+    } catch (...) {
+        // The job's results are no longer wanted
+    }
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    condition_.notify_all();
+    thread_.join();
+}
+
+void BackgroundWorker::start() {
+    if (running_) {
+        throw std::runtime_error("Background job is already running");
+    }
+    {
+        std::lock_guard lock(mutex_);
+        started_ = true;
+        finished_ = false;
+    }
+    running_ = true;
+    condition_.notify_all();
+}
+
+void BackgroundWorker::wait() {
+    if (!running_) {
+        return;
+    }
+    std::unique_lock lock(mutex_);
+    condition_.wait(lock, [this] { return finished_; });
+    running_ = false;
+    if (exception_) {
+        std::rethrow_exception(std::exchange(exception_, nullptr));
+    }
+}
+
+void BackgroundWorker::run() {
+    std::unique_lock lock(mutex_);
+    while (true) {
+        condition_.wait(lock, [this] { return started_ || stopping_; });
+        if (stopping_) {
+            return;
+        }
+        started_ = false;
+
+        lock.unlock();
+        std::exception_ptr exception;
+        try {
+            job_();
+        } catch (...) {
+            exception = std::current_exception();
+        }
+        lock.lock();
+
+        exception_ = exception;
+        finished_ = true;
+        condition_.notify_all();
+    }
+}
@@ -0,0 +1,153 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include "BoundingVolumeHierarchy.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+    // The most rectangles in a leaf, small enough that checking them all is cheaper than splitting further
+    constexpr uint32_t maxLeafSize = 4;
+
+    /**
+     * A range of rectangles waiting to be given a node while building, and the node whose second child it is.
+     */
+    struct BuildRange {
+        uint32_t begin;
+        uint32_t end;
+        uint32_t parent;
+    };
+
+    // Marks the range of the root, which is no node's second child
+    constexpr uint32_t noParent = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * Gets the enter and exit fractions of a segment along one axis, as Rectangle2F::getSegmentSlab() does.
+     */
+    Vector2F getSlab(const float start, const float scale, const bool parallel, const float min, const float max) {
+        constexpr float infinity = std::numeric_limits<float>::infinity();
+        if (parallel) {
+            const bool inside = start >= min && start <= max;
+            return inside ? Vector2F(-infinity, infinity) : Vector2F(infinity, -infinity);
+        }
+        const float first = (min - start) * scale;
+        const float second = (max - start) * scale;
+        return first < second ? Vector2F(first, second) : Vector2F(second, first);
+    }
+}
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy(const std::span<const Rectangle2F> rectangles) {
+    if (rectangles.size() >= std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("Bounding volume hierarchy has too many rectangles");
+    }
+    const auto count = static_cast<uint32_t>(rectangles.size());
+    if (count == 0) {
+        return;
+    }
+
+    // The bounds of rectangles with a negative size are flipped, so every node contains the rectangles below it
+    std::vector<Node> bounds(count);
+    std::vector<Vector2F> centres(count);
+    for (uint32_t index = 0; index < count; index++) {
+        const Rectangle2F& rectangle = rectangles[index];
+        const float maxX = rectangle.x + rectangle.w;
+        const float maxY = rectangle.y + rectangle.h;
+        bounds[index] = {std::min(rectangle.x, maxX), std::min(rectangle.y, maxY), std::max(rectangle.x, maxX),
+                         std::max(rectangle.y, maxY), 0, 0};
+        centres[index] = {(bounds[index].minX + bounds[index].maxX) * 0.5f,
+                          (bounds[index].minY + bounds[index].maxY) * 0.5f};
+    }
+
+    indices_.resize(count);
+    std::iota(indices_.begin(), indices_.end(), 0u);
+    // A binary tree with at least one rectangle in each leaf has fewer than twice as many nodes as rectangles
+    nodes_.reserve(2 * static_cast<size_t>(count));
+
+    // Ranges are split depth first, taking the first half of each split next so that it directly follows its parent
+    std::vector<BuildRange> ranges{{0, count, noParent}};
+    while (!ranges.empty()) {
+        const BuildRange range = ranges.back();
+        ranges.pop_back();
+
+        const auto nodeIndex = static_cast<uint32_t>(nodes_.size());
+        if (range.parent != noParent) {
+            nodes_[range.parent].first = nodeIndex;
+        }
+
+        constexpr float infinity = std::numeric_limits<float>::infinity();
+        Node node{infinity, infinity, -infinity, -infinity, range.begin, range.end - range.begin};
+        Vector2F centreMin(infinity), centreMax(-infinity);
+        for (uint32_t position = range.begin; position < range.end; position++) {
+            const Node& item = bounds[indices_[position]];
+            const Vector2F& centre = centres[indices_[position]];
+            node.minX = std::min(node.minX, item.minX);
+            node.minY = std::min(node.minY, item.minY);
+            node.maxX = std::max(node.maxX, item.maxX);
+            node.maxY = std::max(node.maxY, item.maxY);
+            centreMin = {std::min(centreMin.x, centre.x), std::min(centreMin.y, centre.y)};
+            centreMax = {std::max(centreMax.x, centre.x), std::max(centreMax.y, centre.y)};
+        }
+
+        if (node.count > maxLeafSize) {
+            const bool splitX = centreMax.x - centreMin.x >= centreMax.y - centreMin.y;
+            const uint32_t middle = range.begin + node.count / 2;
+            std::nth_element(indices_.begin() + range.begin, indices_.begin() + middle, indices_.begin() + range.end,
+                             [&](const uint32_t first, const uint32_t second) {
+                                 return splitX ? centres[first].x < centres[second].x
+                                               : centres[first].y < centres[second].y;
+                             });
+            node.count = 0;
+            ranges.push_back({middle, range.end, nodeIndex});
+            ranges.push_back({range.begin, middle, noParent});
+        }
+        nodes_.push_back(node);
+    }
+
+    rectangles_.reserve(count);
+    for (const uint32_t index: indices_) {
+        rectangles_.push_back(rectangles[index]);
+    }
+}
+
+bool BoundingVolumeHierarchy::intersectsAny(const Line2f& line) const {
+    const Segment segment(line);
+    return traverse([&](const Node& node) { return segment.overlaps(node); },
+                    [&](const uint32_t item) { return rectangles_[item].intersects(line); });
+}
+
+void BoundingVolumeHierarchy::getLineIntersectionMask(const std::span<const Line2f> lines,
+                                                      const std::span<uint64_t> mask) const {
+    const size_t wordCount = (lines.size() + 63) / 64;
+    if (mask.size() < wordCount) {
+        throw std::invalid_argument("Mask is too small for the number of lines");
+    }
+    std::fill_n(mask.begin(), wordCount, 0);
+
+    for (size_t index = 0; index < lines.size(); index++) {
+        mask[index / 64] |= static_cast<uint64_t>(intersectsAny(lines[index])) << (index % 64);
+    }
+}
+
+BoundingVolumeHierarchy::Segment::Segment(const Line2f& line)
+    : start(line.start),
+      scale(0.f),
+      parallelX(line.end.x == line.start.x),
+      parallelY(line.end.y == line.start.y) {
+    scale.x = 1.f / (parallelX ? 1.f : line.end.x - line.start.x);
+    scale.y = 1.f / (parallelY ? 1.f : line.end.y - line.start.y);
+}
+
+bool BoundingVolumeHierarchy::Segment::overlaps(const Node& node) const {
+    const Vector2F slabX = getSlab(start.x, scale.x, parallelX, node.minX, node.maxX);
+    const Vector2F slabY = getSlab(start.y, scale.y, parallelY, node.minY, node.maxY);
+    const float enter = std::max(slabX.x, slabY.x);
+    const float exit = std::min(slabX.y, slabY.y);
+    return (enter <= exit) & (enter <= 1.f) & (exit >= 0.f);
+}
@@ -0,0 +1,137 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include "utils/BufferPool.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace {
+constexpr size_t maxThreadCacheCapacity = 32;
+// Caches of large blocks hold fewer of them, so each thread holds at most this many bytes per size class
+constexpr size_t threadCacheBytes = 64 * 1024;
+
+constexpr size_t getSizeClass(const size_t size) {
+    return static_cast<size_t>(std::bit_width((std::max<size_t>(size, 1) - 1) / BufferPool::minBlockSize));
+}
+
+constexpr size_t getThreadCacheCapacity(const size_t sizeClass) {
+    return std::clamp<size_t>(threadCacheBytes / (BufferPool::minBlockSize << sizeClass), 4, maxThreadCacheCapacity);
+}
+
+struct SharedFreeList {
+    std::mutex mutex;
+    std::vector<void*> blocks;
+};
+
+using SharedFreeLists = std::array<SharedFreeList, BufferPool::sizeClassCount>;
+
+SharedFreeLists& getSharedFreeLists() {
+    // Never destroyed, so threads that exit during static destruction can still return their blocks
+    static auto* freeLists = new SharedFreeLists();
+    return *freeLists;
+}
+
+// Moves blocks from a thread's cache to the shared free list, freeing them if the list cannot grow
+void returnToShared(const size_t sizeClass, void* const* blocks, const size_t count) noexcept {
+    SharedFreeList& shared = getSharedFreeLists()[sizeClass];
+    std::lock_guard lock(shared.mutex);
+    try {
+        shared.blocks.insert(shared.blocks.end(), blocks, blocks + count);
+    } catch (const std::bad_alloc&) {
+        std::for_each(blocks, blocks + count, [](void* block) { ::operator delete(block); });
+    }
+}
+
+struct ThreadCache {
+    struct FreeList {
+        std::array<void*, maxThreadCacheCapacity> blocks{};
+        size_t count{0};
+    };
+
+    std::array<FreeList, BufferPool::sizeClassCount> freeLists{};
+
+    ~ThreadCache();
+};
+
+thread_local ThreadCache threadCache;
+// Blocks allocated or released by thread_local destructors running after the cache's are passed straight to the
+// shared free lists
+thread_local bool threadCacheDestroyed = false;
+
+ThreadCache::~ThreadCache() {
+    threadCacheDestroyed = true;
+    for (size_t sizeClass = 0; sizeClass < BufferPool::sizeClassCount; sizeClass++) {
+        if (const auto& [blocks, count] = freeLists[sizeClass]; count > 0) {
+            returnToShared(sizeClass, blocks.data(), count);
+        }
+    }
+}
+}
+
+void* BufferPool::allocate(const size_t size) {
+    if (size > maxBlockSize) {
+        return ::operator new(size);
+    }
+
+    const size_t sizeClass = getSizeClass(size);
+    SharedFreeList& shared = getSharedFreeLists()[sizeClass];
+    if (!threadCacheDestroyed) {
+        auto& [blocks, count] = threadCache.freeLists[sizeClass];
+        if (count == 0) {
+            // Refill half the cache, leaving room for blocks released before the next refill
+            std::lock_guard lock(shared.mutex);
+            const size_t refill = std::min(shared.blocks.size(), getThreadCacheCapacity(sizeClass) / 2);
+            std::copy(shared.blocks.end() - static_cast<std::ptrdiff_t>(refill), shared.blocks.end(), blocks.begin());
+            shared.blocks.resize(shared.blocks.size() - refill);
+            count = refill;
+        }
+        if (count > 0) {
+            return blocks[--count];
+        }
+    } else {
+        std::lock_guard lock(shared.mutex);
+        if (!shared.blocks.empty()) {
+            void* block = shared.blocks.back();
+            shared.blocks.pop_back();
+            return block;
+        }
+    }
+    return ::operator new(minBlockSize << sizeClass);
+}
+
+void BufferPool::deallocate(void* block, const size_t size) noexcept {
+    if (block == nullptr) {
+        return;
+    }
+    if (size > maxBlockSize) {
+        ::operator delete(block);
+        return;
+    }
+
+    const size_t sizeClass = getSizeClass(size);
+    if (threadCacheDestroyed) {
+        returnToShared(sizeClass, &block, 1);
+        return;
+    }
+
+    auto& [blocks, count] = threadCache.freeLists[sizeClass];
+    const size_t capacity = getThreadCacheCapacity(sizeClass);
+    if (count == capacity) {
+        // Return the older half of the cache, keeping the most recently released blocks which are likely still cached
+        const size_t returned = capacity / 2;
+        returnToShared(sizeClass, blocks.data(), returned);
+        std::copy(blocks.begin() + static_cast<std::ptrdiff_t>(returned),
+                  blocks.begin() + static_cast<std::ptrdiff_t>(count), blocks.begin());
+        count -= returned;
+    }
+    blocks[count++] = block;
+}
@@ -0,0 +1,97 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include "HitboxHistory.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+HitboxHistory::HitboxHistory(const size_t tickCount) : frames_(std::bit_ceil(tickCount > 0 ? tickCount : 1)) {}
+
+void HitboxHistory::record(const uint64_t tick, const InstanceId entity, const Rectangle2F& hitbox) {
+    if (latestTick_ && tick < *getOldestTick()) {
+        throw std::invalid_argument("Hitbox tick is older than the history keeps");
+    }
+    if (!latestTick_ || tick > *latestTick_) {
+        latestTick_ = tick;
+    }
+
+    // A frame holding another tick holds one too old to be kept, as the ticks sharing a frame are a history apart
+    Frame& frame = frames_[tick & (frames_.size() - 1)];
+    if (frame.tick != tick) {
+        frame.tick = tick;
+        std::ranges::fill(frame.present, 0);
+    }
+
+    const auto [entitySlot, inserted] = entitySlots_.try_emplace(entity, 0);
+    if (inserted) {
+        if (!freeSlots_.empty()) {
+            entitySlot->second = freeSlots_.back();
+            freeSlots_.pop_back();
+            slotEntities_[entitySlot->second] = entity;
+        } else {
+            entitySlot->second = static_cast<uint32_t>(slotEntities_.size());
+            slotEntities_.push_back(entity);
+        }
+    }
+    const uint32_t slot = entitySlot->second;
+
+    if (slot >= frame.hitboxes.size()) {
+        frame.hitboxes.resize(slotEntities_.size());
+        frame.present.resize((slotEntities_.size() + 63) / 64);
+    }
+    frame.hitboxes[slot] = hitbox;
+    frame.present[slot / 64] |= uint64_t{1} << (slot % 64);
+}
+
+void HitboxHistory::remove(const InstanceId entity) {
+    const auto entitySlot = entitySlots_.find(entity);
+    if (entitySlot == entitySlots_.end()) {
+        return;
+    }
+    const uint32_t slot = entitySlot->second;
+    // Cleared from every frame, so that the entity given the slot next is not found at the ticks before it had it
+    for (Frame& frame: frames_) {
+        if (slot / 64 < frame.present.size()) {
+            frame.present[slot / 64] &= ~(uint64_t{1} << (slot % 64));
+        }
+    }
+    freeSlots_.push_back(slot);
+    entitySlots_.erase(entitySlot);
+}
+
+bool HitboxHistory::contains(const uint64_t tick) const {
+    return findFrame(tick) != nullptr;
+}
+
+std::optional<uint64_t> HitboxHistory::getOldestTick() const {
+    if (!latestTick_) {
+        return std::nullopt;
+    }
+    return *latestTick_ - std::min<uint64_t>(*latestTick_, frames_.size() - 1);
+}
+
+std::optional<Rectangle2F> HitboxHistory::getHitbox(const uint64_t tick, const InstanceId entity) const {
+    const Frame* frame = findFrame(tick);
+    const auto entitySlot = entitySlots_.find(entity);
+    if (!frame || entitySlot == entitySlots_.end()) {
+        return std::nullopt;
+    }
+    const uint32_t slot = entitySlot->second;
+    if (slot / 64 >= frame->present.size() || !(frame->present[slot / 64] >> (slot % 64) & 1)) {
+        return std::nullopt;
+    }
+    return frame->hitboxes[slot];
+}
+
+const HitboxHistory::Frame* HitboxHistory::findFrame(const uint64_t tick) const {
+    if (!latestTick_ || tick > *latestTick_ || tick < *getOldestTick()) {
+        return nullptr;
+    }
+    const Frame& frame = frames_[tick & (frames_.size() - 1)];
+    return frame.tick == tick ? &frame : nullptr;
+}
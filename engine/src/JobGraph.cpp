@@ -0,0 +1,118 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include "JobGraph.h"
+
+#include <stdexcept>
+#include <utility>
+
+JobGraph::JobGraph(WorkStealingPool* pool) : pool_(pool) {}
+
+JobGraph::JobId JobGraph::addJob(Job job, const std::initializer_list<JobId> dependencies) {
+    if (running_) {
+        throw std::runtime_error("Cannot add a job to a running job graph");
+    }
+    for (const JobId dependency: dependencies) {
+        if (dependency >= jobs_.size()) {
+            throw std::invalid_argument("Job depends on a job that is not in the graph");
+        }
+    }
+
+    const JobId jobId = jobs_.size();
+    jobs_.emplace_back(std::move(job), std::vector<JobId>{}, dependencies.size(), 0);
+    for (const JobId dependency: dependencies) {
+        jobs_[dependency].dependents.push_back(jobId);
+    }
+    return jobId;
+}
+
+JobGraph::JobId JobGraph::addParallelFor(const size_t count, const size_t grainSize, RangeJob job,
+                                         const std::initializer_list<JobId> dependencies) {
+    return addJob([this, count, grainSize, job = std::move(job)] {
+        if (pool_) {
+            pool_->parallelFor(count, grainSize, job);
+        } else if (count > 0) {
+            job(0, count);
+        }
+    }, dependencies);
+}
+
+void JobGraph::run() {
+    if (running_) {
+        throw std::runtime_error("Job graph is already running");
+    }
+    running_ = true;
+    failed_ = false;
+    exception_ = nullptr;
+
+    if (pool_) {
+        // Every counter is reset before any job starts, as finished jobs decrement the counters of their dependents
+        remainingJobs_ = jobs_.size();
+        for (Node& node: jobs_) {
+            node.remainingDependencies = node.dependencyCount;
+        }
+        for (JobId jobId = 0; jobId < jobs_.size(); jobId++) {
+            if (jobs_[jobId].dependencyCount == 0) {
+                submit(jobId);
+            }
+        }
+        pool_->waitFor(remainingJobs_, this);
+    } else {
+        // Jobs only depend on jobs added before them, so running them in order satisfies every dependency
+        for (Node& node: jobs_) {
+            if (failed_) {
+                break;
+            }
+            try {
+                node.job();
+            } catch (...) {
+                exception_ = std::current_exception();
+                failed_ = true;
+            }
+        }
+    }
+
+    running_ = false;
+    if (exception_) {
+        std::rethrow_exception(std::exchange(exception_, nullptr));
+    }
+}
+
+void JobGraph::clear() {
+    if (running_) {
+        throw std::runtime_error("Cannot clear a running job graph");
+    }
+    jobs_.clear();
+}
+
+void JobGraph::submit(const JobId jobId) {
+    // Captures fit in std::function's local storage so submitting a job does not allocate
+    pool_->submit([this, jobId] { runJob(jobId); }, this);
+}
+
+void JobGraph::runJob(const JobId jobId) {
+    Node& node = jobs_[jobId];
+    if (!failed_) {
+        try {
+            node.job();
+        } catch (...) {
+            std::lock_guard lock(exceptionMutex_);
+            if (!exception_) {
+                exception_ = std::current_exception();
+            }
+            failed_ = true;
+        }
+    }
+
+    // Skipped jobs still release their dependents, so that every job is accounted for
+    for (const JobId dependent: node.dependents) {
+        if (jobs_[dependent].remainingDependencies.fetch_sub(1) == 1) {
+            submit(dependent);
+        }
+    }
+    remainingJobs_.fetch_sub(1);
+}
@@ -0,0 +1,141 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include "LoopbackNetworkProtocol.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+LoopbackNetworkProtocol::LoopbackNetworkProtocol(const uint32_t seed) : random_(seed) {}
+
+std::optional<Message> LoopbackNetworkProtocol::recieve() {
+    if (serverInbox_.empty()) {
+        return std::nullopt;
+    }
+    auto message = std::move(serverInbox_.front());
+    serverInbox_.pop();
+    return message;
+}
+
+void LoopbackNetworkProtocol::send(Message message) {
+    const auto endpoint = endpoints_.find(message.clientId);
+    if (endpoint == endpoints_.end()) {
+        return;
+    }
+    transmit(endpoint->second.downstream, std::move(message), false);
+}
+
+void LoopbackNetworkProtocol::disconnect(const ClientId clientId) {
+    endpoints_.erase(clientId);
+    serverInbox_.eraseIf([clientId](const Message& message) { return message.clientId == clientId; });
+}
+
+ClientId LoopbackNetworkProtocol::connectClient(const LinkConditions& upstream, const LinkConditions& downstream) {
+    const ClientId clientId = nextClientId_++;
+    Endpoint& endpoint = endpoints_[clientId];
+    endpoint.upstream.conditions = upstream;
+    endpoint.downstream.conditions = downstream;
+    serverInbox_.push({clientId, {}, MessageType::Connect});
+    return clientId;
+}
+
+void LoopbackNetworkProtocol::disconnectClient(const ClientId clientId) {
+    if (endpoints_.erase(clientId) > 0) {
+        serverInbox_.push({clientId, {}, MessageType::Disconnect});
+    }
+}
+
+void LoopbackNetworkProtocol::clientSend(const ClientId clientId, MessageBuffer body) {
+    transmit(getEndpoint(clientId).upstream, {clientId, std::move(body)}, true);
+}
+
+std::optional<Message> LoopbackNetworkProtocol::clientRecieve(const ClientId clientId) {
+    auto& inbox = getEndpoint(clientId).inbox;
+    if (inbox.empty()) {
+        return std::nullopt;
+    }
+    auto message = std::move(inbox.front());
+    inbox.pop();
+    return message;
+}
+
+void LoopbackNetworkProtocol::advanceTime(const double deltaTime) {
+    time_ += deltaTime;
+    while (!inFlight_.empty() && inFlight_.top().deliveryTime <= time_) {
+        // priority_queue::top is const, the message is moved out immediately before popping
+        auto inFlightMessage = std::move(const_cast<InFlightMessage&>(inFlight_.top()));
+        inFlight_.pop();
+
+        const auto endpoint = endpoints_.find(inFlightMessage.message.clientId);
+        if (endpoint == endpoints_.end()) {
+            // The client disconnected while the message was in flight
+            continue;
+        }
+
+        Link& link = inFlightMessage.toServer ? endpoint->second.upstream : endpoint->second.downstream;
+        link.statistics.messagesDelivered++;
+        link.statistics.bytesDelivered += inFlightMessage.message.body.size();
+
+        if (inFlightMessage.toServer) {
+            serverInbox_.push(std::move(inFlightMessage.message));
+        } else {
+            endpoint->second.inbox.push(std::move(inFlightMessage.message));
+        }
+    }
+}
+
+const LinkStatistics& LoopbackNetworkProtocol::getUpstreamStatistics(const ClientId clientId) const {
+    return getEndpoint(clientId).upstream.statistics;
+}
+
+const LinkStatistics& LoopbackNetworkProtocol::getDownstreamStatistics(const ClientId clientId) const {
+    return getEndpoint(clientId).downstream.statistics;
+}
+
+LoopbackNetworkProtocol::Endpoint& LoopbackNetworkProtocol::getEndpoint(const ClientId clientId) {
+    const auto endpoint = endpoints_.find(clientId);
+    if (endpoint == endpoints_.end()) {
+        throw std::invalid_argument("Client " + std::to_string(clientId) + " is not connected");
+    }
+    return endpoint->second;
+}
+
+const LoopbackNetworkProtocol::Endpoint& LoopbackNetworkProtocol::getEndpoint(const ClientId clientId) const {
+    const auto endpoint = endpoints_.find(clientId);
+    if (endpoint == endpoints_.end()) {
+        throw std::invalid_argument("Client " + std::to_string(clientId) + " is not connected");
+    }
+    return endpoint->second;
+}
+
+void LoopbackNetworkProtocol::transmit(Link& link, Message message, const bool toServer) {
+    const LinkConditions& conditions = link.conditions;
+    link.statistics.messagesSent++;
+    link.statistics.bytesSent += message.body.size();
+
+    // Random values are always drawn so that changing one condition does not change the sequence for the others
+    const double lossRoll = std::uniform_real_distribution(0.0, 1.0)(random_);
+    const double jitter = conditions.jitter * std::uniform_real_distribution(0.0, 1.0)(random_);
+
+    // A message occupies the link for as long as it takes to transmit at the capped bandwidth, queueing behind any
+    // messages that are still being transmitted
+    const double transmitStart = std::max(time_, link.busyUntil);
+    const double transmitTime = conditions.bandwidth > 0
+        ? static_cast<double>(message.body.size()) / conditions.bandwidth
+        : 0.0;
+    link.busyUntil = transmitStart + transmitTime;
+
+    if (lossRoll < conditions.lossRate) {
+        link.statistics.messagesDropped++;
+        return;
+    }
+
+    const double deliveryTime = std::max(link.busyUntil + conditions.latency + jitter, link.lastDeliveryTime);
+    link.lastDeliveryTime = deliveryTime;
+    inFlight_.push({deliveryTime, nextSequence_++, toServer, std::move(message)});
+}
@@ -8,86 +8,639 @@
 
 #include "NetworkEngine.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <ranges>
+
+#include "WorkStealingPool.h"
+#include "utils/EngineCommon.h"
+#include "utils/VectorBatch.h"
+
 //NetworkEngine::NetworkEngine() : NetworkEngine(std::make_unique<INetworkPort>()) {}
 
 NetworkEngine::NetworkEngine(std::unique_ptr<INetworkProtocol> networkPort) : networkPort_(std::move(networkPort)) {
 }
 
-void NetworkEngine::update() {
+void NetworkEngine::update(const float deltaTime) {
+    finishReplication();
+    time_ += deltaTime;
+
     while (const auto message = networkPort_->recieve()) {
-        if(std::ranges::find(players_, message->clientId) == players_.end()) {
-            players_.push_back(message->clientId);
+        if (message->type == MessageType::Disconnect) {
+            removePlayer(message->clientId);
+            continue;
+        }
+
+        const auto playerIndex = playerIndices_.find(message->clientId);
+        if (playerIndex == playerIndices_.end()) {
+            addPlayer(message->clientId);
+        } else {
+            playerLastHeardTimes_[playerIndex->second] = time_;
+        }
+        if (!message->body.empty()) {
+            decodeClientCommands(*message);
+        }
+    }
+
+    timeOutIdlePlayers();
+
+    updateCount_++;
+    if (players_.empty()) {
+        return;
+    }
+    captureFrame();
+    frameDeltaTime_ = deltaTime;
+
+    if (replicationWorker_) {
+        replicationWorker_->start();
+        return;
+    }
+    replicateFrame();
+    dispatchInterestEvents();
+}
+
+void NetworkEngine::setPipelinedReplication(const bool pipelined) {
+    if (pipelined == static_cast<bool>(replicationWorker_)) {
+        return;
+    }
+    finishReplication();
+    if (pipelined) {
+        replicationWorker_ = std::make_unique<BackgroundWorker>([this] { replicateFrame(); });
+    } else {
+        replicationWorker_.reset();
+    }
+}
+
+void NetworkEngine::setSnapshotPool(WorkStealingPool* pool) {
+    finishReplication();
+    snapshotPool_ = pool;
+}
+
+void NetworkEngine::finishReplication() {
+    if (!replicationWorker_ || !replicationWorker_->isRunning()) {
+        return;
+    }
+    try {
+        replicationWorker_->wait();
+    } catch (...) {
+        // Events are discarded along with the snapshots that failed
+        pendingGridRemovals_.clear();
+        for (PlayerReplication* replication: replicatedPlayers_ | std::views::values) {
+            replication->interestEvents.clear();
         }
+        throw;
+    }
+    for (const InstanceId instanceId: pendingGridRemovals_) {
+        interestGrid_.remove(instanceId);
     }
+    pendingGridRemovals_.clear();
+    dispatchInterestEvents();
+}
 
-    const std::vector<uint8_t> gameState = getReplicatedObjectsSerialized();
+void NetworkEngine::replicateFrame() {
+    // The full game state is shared by every player without a view or bandwidth, so it is only serialized if one exists
+    std::optional<MessageBuffer> gameState;
+    replicatedPlayers_.clear();
     for (const auto playerClientId: players_) {
-        networkPort_->send({playerClientId, gameState});
+        if (const auto replication = playerReplications_.find(playerClientId); replication != playerReplications_.end()) {
+            replicatedPlayers_.emplace_back(playerClientId, &replication->second);
+        } else if (!gameState) {
+            auto buffer = acquireSerializationBuffer(serializationBuffers_);
+            frame_.pack(*buffer);
+            gameState = toMessageBuffer(std::move(buffer));
+        }
+    }
+
+    const auto buildSnapshots = [this](const size_t begin, const size_t end) {
+        for (size_t index = begin; index < end; index++) {
+            const auto& [clientId, replication] = replicatedPlayers_[index];
+            buildPlayerSnapshot(clientId, *replication, frameDeltaTime_);
+        }
+    };
+    if (snapshotPool_ && replicatedPlayers_.size() > 1) {
+        snapshotPool_->parallelFor(replicatedPlayers_.size(), 1, buildSnapshots);
+    } else {
+        buildSnapshots(0, replicatedPlayers_.size());
+    }
+
+    for (const auto playerClientId: players_) {
+        if (const auto replication = playerReplications_.find(playerClientId); replication != playerReplications_.end()) {
+            networkPort_->send({playerClientId, std::move(*replication->second.snapshot)});
+            replication->second.snapshot.reset();
+        } else {
+            networkPort_->send({playerClientId, *gameState});
+        }
+    }
+}
+
+void NetworkEngine::applyClientCommands() {
+    for (size_t playerIndex = 0; playerIndex < players_.size(); playerIndex++) {
+        std::vector<size_t>& commandOrder = playerCommandOrders_[playerIndex];
+        for (const size_t channelIndex: commandOrder) {
+            clientCommandChannels_[channelIndex]->applyNext(players_[playerIndex]);
+        }
+        commandOrder.clear();
+    }
+}
+
+void NetworkEngine::disconnectPlayer(const ClientId clientId) {
+    finishReplication();
+    if (!playerIndices_.contains(clientId)) {
+        return;
+    }
+    networkPort_->disconnect(clientId);
+    removePlayer(clientId);
+}
+
+void NetworkEngine::setPlayerView(const ClientId clientId, const Rectangle2F& view) {
+    finishReplication();
+    if (!playerIndices_.contains(clientId)) {
+        throw std::invalid_argument("Cannot set the view of a player that is not connected");
+    }
+    playerReplications_[clientId].view = view;
+}
+
+void NetworkEngine::clearPlayerView(const ClientId clientId) {
+    finishReplication();
+    const auto replication = playerReplications_.find(clientId);
+    if (replication == playerReplications_.end()) {
+        return;
+    }
+    if (replication->second.scheduler.getBandwidth() == 0) {
+        erasePlayerReplication(replication);
+    } else {
+        // The next snapshot's candidates are every object, so nothing leaves and the rest enter as usual
+        replication->second.view.reset();
+    }
+}
+
+void NetworkEngine::erasePlayerReplication(
+    const std::unordered_map<ClientId, PlayerReplication>::iterator replication) {
+    // The player is sent the full game state from now on, so every object they were sent leaves their interest set
+    // just as it would leave their view, keeping each enter matched by a leave
+    for (const InstanceId instanceId: replication->second.visibleObjects) {
+        pendingInterestEvents_.push_back({replication->first, instanceId, false});
+    }
+    playerReplications_.erase(replication);
+}
+
+void NetworkEngine::setPlayerBandwidth(const ClientId clientId, const uint32_t bandwidth) {
+    finishReplication();
+    if (!playerIndices_.contains(clientId)) {
+        throw std::invalid_argument("Cannot set the bandwidth of a player that is not connected");
+    }
+    const auto replication = playerReplications_.find(clientId);
+    if (bandwidth == 0 && (replication == playerReplications_.end() || !replication->second.view)) {
+        if (replication != playerReplications_.end()) {
+            erasePlayerReplication(replication);
+        }
+        return;
+    }
+    playerReplications_[clientId].scheduler.setBandwidth(bandwidth);
+}
+
+void NetworkEngine::setInterestCellSize(const float cellSize) {
+    finishReplication();
+    // Objects are inserted into the new grid by the next update
+    interestGrid_ = SpatialHashGrid<InstanceId>(cellSize);
+}
+
+void NetworkEngine::setInterestHandlers(InterestHandler enterHandler, InterestHandler leaveHandler) {
+    interestEnterHandler_ = std::move(enterHandler);
+    interestLeaveHandler_ = std::move(leaveHandler);
+}
+
+void NetworkEngine::addPlayer(const ClientId clientId) {
+    playerIndices_.emplace(clientId, players_.size());
+    players_.push_back(clientId);
+    playerLastHeardTimes_.push_back(time_);
+    playerCommandOrders_.emplace_back();
+    for (const auto& channel: clientCommandChannels_) {
+        channel->addClient(clientId);
+    }
+    if (playerConnectedHandler_) {
+        playerConnectedHandler_(clientId);
+    }
+}
+
+void NetworkEngine::removePlayer(const ClientId clientId) {
+    const auto playerIndex = playerIndices_.find(clientId);
+    if (playerIndex == playerIndices_.end()) {
+        return;
+    }
+
+    const size_t index = playerIndex->second;
+    playerIndices_.erase(playerIndex);
+    if (index != players_.size() - 1) {
+        players_[index] = players_.back();
+        playerLastHeardTimes_[index] = playerLastHeardTimes_.back();
+        playerCommandOrders_[index] = std::move(playerCommandOrders_.back());
+        playerIndices_[players_[index]] = index;
+    }
+    players_.pop_back();
+    playerLastHeardTimes_.pop_back();
+    playerCommandOrders_.pop_back();
+    playerReplications_.erase(clientId);
+
+    for (const auto& channel: clientCommandChannels_) {
+        channel->removeClient(clientId);
+    }
+    if (playerDisconnectedHandler_) {
+        playerDisconnectedHandler_(clientId);
+    }
+}
+
+void NetworkEngine::timeOutIdlePlayers() {
+    if (playerTimeout_ <= 0.f) {
+        return;
+    }
+    // Iterate backwards so that removing a player only moves players that have already been checked
+    for (size_t index = players_.size(); index-- > 0;) {
+        if (time_ - playerLastHeardTimes_[index] > playerTimeout_) {
+#ifdef __DEBUG
+            debug("Player timed out:", static_cast<int>(players_[index]));
+#endif
+            disconnectPlayer(players_[index]);
+        }
+    }
+}
+
+void NetworkEngine::captureFrame() {
+    frame_.clear();
+    for (size_t index = 0; index < replicatedTypes_.size(); index++) {
+        frame_.addObjects(replicatedTypes_[index].typeId, replicatedTypes_[index].packBatch, replicatedObjects_[index]);
+    }
+    for (const IReplicatedStore* store: replicatedStores_) {
+        frame_.addStore(*store);
+    }
+    if (!playerReplications_.empty()) {
+        updateInterestGrid();
+    }
+}
+
+void NetworkEngine::updateInterestGrid() {
+    unpositionedObjects_.clear();
+    const auto objects = frame_.getObjects();
+    for (uint32_t index = 0; index < objects.size(); index++) {
+        if (objects[index].position) {
+            interestGrid_.update(objects[index].instanceId, *objects[index].position);
+        } else {
+            interestGrid_.remove(objects[index].instanceId);
+            unpositionedObjects_.push_back(index);
+        }
     }
 }
 
-void NetworkEngine::registerReplicatedObject(IReplicatable* object) {
+void NetworkEngine::buildPlayerSnapshot(const ClientId clientId, PlayerReplication& replication,
+                                        const float deltaTime) const {
+    const auto objects = frame_.getObjects();
+    auto& candidates = replication.candidates;
+    candidates.clear();
+    if (replication.view) {
+        interestGrid_.query(*replication.view, [this, &candidates](const InstanceId instanceId) {
+            if (const auto index = frame_.findObject(instanceId)) {
+                candidates.push_back(*index);
+            }
+        });
+        candidates.insert(candidates.end(), unpositionedObjects_.begin(), unpositionedObjects_.end());
+    } else {
+        for (uint32_t index = 0; index < objects.size(); index++) {
+            candidates.push_back(index);
+        }
+    }
+    std::ranges::sort(candidates, {}, [&objects](const uint32_t index) { return objects[index].instanceId; });
+
+    auto& visibleObjects = replication.nextVisibleObjects;
+    visibleObjects.clear();
+    for (const uint32_t index: candidates) {
+        visibleObjects.push_back(objects[index].instanceId);
+    }
+
+    // Both lists are sorted, so objects entering and leaving the view are found in a single pass
+    replication.leftObjects.clear();
+    auto previous = replication.visibleObjects.begin();
+    auto current = visibleObjects.begin();
+    while (previous != replication.visibleObjects.end() || current != visibleObjects.end()) {
+        if (current == visibleObjects.end()
+            || (previous != replication.visibleObjects.end() && *previous < *current)) {
+            replication.leftObjects.push_back(*previous);
+            replication.interestEvents.push_back({clientId, *previous++, false});
+        } else if (previous == replication.visibleObjects.end() || *current < *previous) {
+            replication.interestEvents.push_back({clientId, *current++, true});
+        } else {
+            ++previous;
+            ++current;
+        }
+    }
+    std::swap(replication.visibleObjects, visibleObjects);
+
+    // Objects further from the centre of the view lose priority, halving at the edge of the view
+    std::optional<Vector2F> viewCentre;
+    float viewRadius = 0.f;
+    if (replication.view) {
+        viewCentre = Vector2F(replication.view->x + replication.view->w * 0.5f,
+                              replication.view->y + replication.view->h * 0.5f);
+        viewRadius = std::max(replication.view->w, replication.view->h) * 0.5f;
+    }
+    // Distances are measured in one batch, with objects without a position placed at the centre to keep their priority
+    const bool distanceFalloff = viewCentre && viewRadius > 0.f;
+    if (distanceFalloff) {
+        replication.candidatesX.resize(candidates.size());
+        replication.candidatesY.resize(candidates.size());
+        replication.candidateDistancesSquared.resize(candidates.size());
+        for (size_t candidate = 0; candidate < candidates.size(); candidate++) {
+            const Vector2F position = objects[candidates[candidate]].position.value_or(*viewCentre);
+            replication.candidatesX[candidate] = position.x;
+            replication.candidatesY[candidate] = position.y;
+        }
+        getDistancesSquared(replication.candidatesX, replication.candidatesY, *viewCentre,
+                            replication.candidateDistancesSquared);
+    }
+    const bool limited = replication.scheduler.getBandwidth() > 0;
+    replication.scheduleCandidates.clear();
+    for (size_t candidate = 0; candidate < candidates.size(); candidate++) {
+        const ReplicationFrame::Object& object = objects[candidates[candidate]];
+        float priority = object.priority;
+        if (distanceFalloff) {
+            priority /= 1.f + std::sqrt(replication.candidateDistancesSquared[candidate]) / viewRadius;
+        }
+        replication.scheduleCandidates.push_back({object.instanceId, priority, limited ? object.size : 0});
+    }
+    replication.scheduler.schedule(replication.scheduleCandidates, deltaTime, replication.scheduledCandidates);
+
+    // The frame groups objects by type, so objects are serialized in frame order
+    replication.snapshotObjects.clear();
+    for (const size_t candidate: replication.scheduledCandidates) {
+        replication.snapshotObjects.push_back(candidates[candidate]);
+    }
+    std::ranges::sort(replication.snapshotObjects);
+
+    auto buffer = acquireSerializationBuffer(replication.serializationBuffers);
+    msgpack::packer packer(*buffer);
+    packer.pack_array(2);
+    frame_.pack(*buffer, replication.snapshotObjects);
+    packer.pack(replication.leftObjects);
+    replication.snapshot = toMessageBuffer(std::move(buffer));
+}
+
+std::shared_ptr<msgpack::sbuffer> NetworkEngine::acquireSerializationBuffer(
+    std::vector<std::shared_ptr<msgpack::sbuffer>>& buffers) {
+    for (const auto& buffer: buffers) {
+        // Only the engine hands out references to its buffers, so once every message sharing a buffer has been released
+        // nothing else can start using it
+        if (buffer.use_count() == 1) {
+            // Pairs with the release of the last message, so its reads of the buffer happen before it is overwritten
+            std::atomic_thread_fence(std::memory_order_acquire);
+            buffer->clear();
+            return buffer;
+        }
+    }
+    // Past the cap the buffer is not kept, so a client that is slow to release its messages cannot grow the pool
+    if (buffers.size() >= maxPooledSerializationBuffers) {
+        return std::make_shared<msgpack::sbuffer>();
+    }
+    return buffers.emplace_back(std::make_shared<msgpack::sbuffer>());
+}
+
+MessageBuffer NetworkEngine::toMessageBuffer(std::shared_ptr<msgpack::sbuffer> buffer) {
+    const auto data = reinterpret_cast<const uint8_t*>(buffer->data());
+    const size_t size = buffer->size();
+    return {std::move(buffer), data, size};
+}
+
+void NetworkEngine::dispatchInterestEvents() {
+    for (PlayerReplication* replication: replicatedPlayers_ | std::views::values) {
+        pendingInterestEvents_.insert(pendingInterestEvents_.end(), replication->interestEvents.begin(),
+                                      replication->interestEvents.end());
+        replication->interestEvents.clear();
+    }
+    for (const auto& [clientId, instanceId, entered]: pendingInterestEvents_) {
+        const InterestHandler& handler = entered ? interestEnterHandler_ : interestLeaveHandler_;
+        if (handler) {
+            handler(clientId, instanceId);
+        }
+    }
+    pendingInterestEvents_.clear();
+}
+
+void NetworkEngine::decodeClientCommands(const Message& message) {
+    // Referencing the message body means only the object tree itself is allocated, from the reused zone
+    constexpr msgpack::unpack_reference_func referenceBody = [](msgpack::type::object_type, std::size_t, void*) {
+        return true;
+    };
+
+    // The player's connected handler may have disconnected them again
+    const auto playerIndex = playerIndices_.find(message.clientId);
+    if (playerIndex == playerIndices_.end()) {
+        return;
+    }
+    std::vector<size_t>& commandOrder = playerCommandOrders_[playerIndex->second];
+
+    const auto data = reinterpret_cast<const char*>(message.body.data());
+    std::size_t offset = 0;
+    while (offset < message.body.size()) {
+        clientCommandZone_.clear();
+        try {
+            const msgpack::object command = msgpack::unpack(
+                clientCommandZone_, data, message.body.size(), offset, referenceBody);
+
+            if (command.type != msgpack::type::ARRAY || command.via.array.size != 3
+                || command.via.array.ptr[0].type != msgpack::type::STR) {
+                throw msgpack::type_error();
+            }
+            const msgpack::object_str& typeId = command.via.array.ptr[0].via.str;
+            const auto channelIndex = clientCommandChannelIndices_.find(TypeId(typeId.ptr, typeId.size));
+            if (channelIndex == clientCommandChannelIndices_.end()) {
+#ifdef __DEBUG
+                debug("Discarded client command of unknown type");
+#endif
+                continue;
+            }
+
+            if (clientCommandChannels_[channelIndex->second]->enqueue(
+                    message.clientId, command.via.array.ptr[1].as<CommandSequence>(), command.via.array.ptr[2])) {
+                commandOrder.push_back(channelIndex->second);
+            }
+        } catch (const msgpack::unpack_error&) {
+            // The rest of the message cannot be parsed
+#ifdef __DEBUG
+            debug("Discarded malformed client message");
+#endif
+            break;
+        } catch (const msgpack::type_error&) {
+#ifdef __DEBUG
+            debug("Discarded malformed client command");
+#endif
+        }
+    }
+}
+
+void NetworkEngine::registerReplicatedObject(IReplicatable* object, const PackBatchFunction packBatch) {
     if (!object) {
         throw std::invalid_argument("Cannot register null object");
     }
 
-    if (nextReplicatedObjectInstanceId_ == std::numeric_limits<InstanceId>::max()) {
-        throw std::runtime_error("Instance ID overflow");
+    if (std::ranges::any_of(replicatedStores_, [object](const IReplicatedStore* store) {
+        return store->getTypeId() == object->getTypeId();
+    })) {
+        throw std::runtime_error("Object type already used by a replicated store");
+    }
+
+    const auto [typeIndex, inserted] = replicatedTypeIndices_.try_emplace(object->getTypeId(), replicatedTypes_.size());
+    if (inserted) {
+        replicatedTypes_.push_back({object->getTypeId(), packBatch});
+        replicatedObjects_.emplace_back();
+    } else if (replicatedTypes_[typeIndex->second].packBatch != packBatch) {
+        throw std::runtime_error("Object registered with a different serializer to other objects of its type");
     }
 
-    auto& objectsOfType = replicatedObjects_[object->getTypeId()];
+    auto& objectsOfType = replicatedObjects_[typeIndex->second];
     if (std::ranges::find(objectsOfType, object) != objectsOfType.end()) {
         throw std::runtime_error("Object already registered");
     }
 
-    if (object->initializeInstanceId(nextReplicatedObjectInstanceId_++)) {
+    const InstanceId instanceId = allocateInstanceId();
+    if (object->initializeInstanceId(instanceId)) {
         objectsOfType.push_back(object);
+        instanceSlots_[instanceId].object = object;
     }
     else {
+        releaseInstanceId(instanceId);
         throw std::runtime_error("Object instance ID already initialized");
     }
 }
 
 void NetworkEngine::unregisterReplicatedObject(IReplicatable* object) {
-    auto& objectsOfType = replicatedObjects_[object->getTypeId()];
-    std::erase(objectsOfType, object);
-
-    if (objectsOfType.empty()) {
-        replicatedObjects_.erase(object->getTypeId());
-    }
-}
-
-// Custom adaptor class template specialization to support packing `replicatableObjects_`
-// ReSharper disable once CppRedundantNamespaceDefinition - msgpack-c documented syntax
-namespace msgpack {
-MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS) {
-template <>
-struct adaptor::pack<std::unordered_map<TypeId, std::vector<IReplicatable*>>> {
-    template <typename Stream>
-    packer<Stream>& operator()(packer<Stream>& o,
-        const std::unordered_map<TypeId, std::vector<IReplicatable*>>& v) const {
-        static_assert(std::is_same_v<Stream, sbuffer>, "IReplicatable* can only be packed into a msgpack::sbuffer");
-        o.pack_map(v.size());
-        for (const auto& [typeId, objects] : v) {
-            o.pack(typeId);
-            o.pack_map(objects.size());
-            for (auto object: objects) {
-                if (object == nullptr) {
-                    throw std::runtime_error("Attempting to serialize null pointer");
-                }
-                o.pack(object->getInstanceId());
-                o.pack(*object);
-            }
+    if (replicationWorker_ && replicationWorker_->isRunning()) {
+        pendingGridRemovals_.push_back(object->getInstanceId());
+    } else {
+        interestGrid_.remove(object->getInstanceId());
+    }
+
+    const auto typeIndex = replicatedTypeIndices_.find(object->getTypeId());
+    if (typeIndex != replicatedTypeIndices_.end() && std::erase(replicatedObjects_[typeIndex->second], object) > 0) {
+        releaseInstanceId(object->getInstanceId());
+    }
+}
+
+void NetworkEngine::registerReplicatedStore(IReplicatedStore* store) {
+    if (!store) {
+        throw std::invalid_argument("Cannot register null store");
+    }
+    if (std::ranges::find(replicatedStores_, store) != replicatedStores_.end()) {
+        throw std::runtime_error("Store already registered");
+    }
+    // Types are never removed, so a type only used by objects that have all been unregistered is still reserved
+    if (replicatedTypeIndices_.contains(store->getTypeId())
+        || std::ranges::any_of(replicatedStores_, [store](const IReplicatedStore* other) {
+            return other->getTypeId() == store->getTypeId();
+        })) {
+        throw std::runtime_error("Store type already used by other replicated objects");
+    }
+    replicatedStores_.push_back(store);
+}
+
+void NetworkEngine::unregisterReplicatedStore(const IReplicatedStore* store) {
+    std::erase(replicatedStores_, store);
+}
+
+InstanceId NetworkEngine::allocateInstanceId() {
+    InstanceId instanceId;
+    if (!releasedInstanceIds_.empty()
+        && updateCount_ - releasedInstanceIds_.front().releaseUpdate >= instanceIdReuseDelay_) {
+        instanceId = releasedInstanceIds_.front().instanceId;
+        releasedInstanceIds_.pop();
+    } else if (instanceSlots_.size() <= std::numeric_limits<InstanceId>::max()) {
+        instanceId = static_cast<InstanceId>(instanceSlots_.size());
+        instanceSlots_.emplace_back();
+    } else {
+        throw std::runtime_error("Instance ID overflow");
+    }
+    instanceSlots_[instanceId].allocated = true;
+    return instanceId;
+}
+
+void NetworkEngine::releaseInstanceId(const InstanceId instanceId) {
+    if (instanceId == uninitializedInstanceID || instanceId >= instanceSlots_.size()
+        || !instanceSlots_[instanceId].allocated) {
+        return;
+    }
+    InstanceSlot& slot = instanceSlots_[instanceId];
+    slot.generation++;
+    slot.allocated = false;
+    slot.object = nullptr;
+    releasedInstanceIds_.push({instanceId, updateCount_});
+}
+
+void NetworkEngine::setInstanceIdReuseDelay(const uint32_t updates) {
+    if (updates == 0) {
+        throw std::invalid_argument("Instance ID reuse delay must be at least 1 update");
+    }
+    instanceIdReuseDelay_ = updates;
+}
+
+InstanceHandle NetworkEngine::getInstanceHandle(const InstanceId instanceId) const {
+    const InstanceSlot* slot = findInstanceSlot(instanceId);
+    if (!slot) {
+        throw std::invalid_argument("Instance ID is not allocated");
+    }
+    return {instanceId, slot->generation};
+}
+
+bool NetworkEngine::isInstanceLive(const InstanceHandle& handle) const {
+    const InstanceSlot* slot = findInstanceSlot(handle.instanceId);
+    return slot && slot->generation == handle.generation;
+}
+
+IReplicatable* NetworkEngine::findReplicatedObject(const InstanceHandle& handle) const {
+    const InstanceSlot* slot = findInstanceSlot(handle.instanceId);
+    return slot && slot->generation == handle.generation ? slot->object : nullptr;
+}
+
+const NetworkEngine::InstanceSlot* NetworkEngine::findInstanceSlot(const InstanceId instanceId) const {
+    if (instanceId >= instanceSlots_.size() || !instanceSlots_[instanceId].allocated) {
+        return nullptr;
+    }
+    return &instanceSlots_[instanceId];
+}
+
+std::unordered_map<TypeId, std::vector<IReplicatable*>> NetworkEngine::getReplicatedObjects() const {
+    std::unordered_map<TypeId, std::vector<IReplicatable*>> replicatedObjects;
+    for (size_t index = 0; index < replicatedTypes_.size(); index++) {
+        if (!replicatedObjects_[index].empty()) {
+            replicatedObjects.emplace(replicatedTypes_[index].typeId, replicatedObjects_[index]);
         }
+    }
+    return replicatedObjects;
+}
 
-        return o;
+void NetworkEngine::packReplicatedObjects(msgpack::sbuffer& buffer,
+                                          const std::vector<std::vector<IReplicatable*>>& objectsByType) const {
+    msgpack::packer packer(buffer);
+    // Types without any objects are left out
+    const auto typeCount = std::ranges::count_if(objectsByType, [](const auto& objects) {
+        return !objects.empty();
+    }) + std::ranges::count_if(replicatedStores_, [](const IReplicatedStore* store) {
+        return store->size() > 0;
+    });
+    packer.pack_map(static_cast<uint32_t>(typeCount));
+    for (size_t index = 0; index < objectsByType.size(); index++) {
+        if (objectsByType[index].empty()) continue;
+        packer.pack(replicatedTypes_[index].typeId);
+        // One indirect call per type, the batch function serializes every object of the type
+        replicatedTypes_[index].packBatch(buffer, objectsByType[index], nullptr);
+    }
+    for (const IReplicatedStore* store: replicatedStores_) {
+        if (store->size() == 0) continue;
+        packer.pack(store->getTypeId());
+        store->pack(packer);
     }
-}; // namespace adaptor
-} // MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS)
-} // namespace msgpack
+}
 
 std::vector<uint8_t> NetworkEngine::getReplicatedObjectsSerialized() const {
     msgpack::sbuffer buffer;
-    msgpack::pack(buffer, replicatedObjects_);
+    packReplicatedObjects(buffer, replicatedObjects_);
     return {buffer.data(), buffer.data() + buffer.size()};
-}
\ No newline at end of file
+}
@@ -0,0 +1,215 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include "NetworkRouter.h"
+
+#include <stdexcept>
+
+#include "utils/EngineCommon.h"
+#include "utils/RingBuffer.h"
+
+class NetworkRouter::Endpoint final : public INetworkProtocol {
+public:
+    Endpoint(NetworkRouter& router, const RoomId roomId)
+        : router_(router)
+        , roomId_(roomId) {
+    }
+
+    ~Endpoint() override {
+        router_.removeEndpoint(roomId_);
+    }
+
+    std::optional<Message> recieve() override {
+        std::lock_guard lock(inboxMutex_);
+        if (inbox_.empty()) {
+            return std::nullopt;
+        }
+        auto message = std::move(inbox_.front());
+        inbox_.pop();
+        return message;
+    }
+
+    void send(Message message) override { router_.send(roomId_, std::move(message)); }
+
+    void disconnect(const ClientId clientId) override {
+        router_.disconnect(roomId_, clientId);
+        // Messages routed to the room but not yet received would otherwise make the room add the client again
+        std::lock_guard lock(inboxMutex_);
+        inbox_.eraseIf([clientId](const Message& message) { return message.clientId == clientId; });
+    }
+
+    void deliver(Message message) {
+        std::lock_guard lock(inboxMutex_);
+        inbox_.push(std::move(message));
+    }
+
+private:
+    NetworkRouter& router_;
+    RoomId roomId_;
+    // Messages are delivered by whichever thread routes or assigns clients while the room receives on its own thread
+    std::mutex inboxMutex_;
+    RingBuffer<Message> inbox_{};
+};
+
+NetworkRouter::NetworkRouter(std::unique_ptr<INetworkProtocol> transport) : transport_(std::move(transport)) {
+    if (!transport_) {
+        throw std::invalid_argument("Network router requires a transport");
+    }
+}
+
+NetworkRouter::~NetworkRouter() {
+#ifdef __DEBUG
+    if (!endpoints_.empty()) {
+        debug("NetworkRouter destroyed before its endpoints");
+    }
+#endif
+}
+
+std::unique_ptr<INetworkProtocol> NetworkRouter::createEndpoint(const RoomId roomId) {
+    std::lock_guard lock(mutex_);
+    if (endpoints_.contains(roomId)) {
+        throw std::runtime_error("Room already has a network endpoint");
+    }
+    auto endpoint = std::make_unique<Endpoint>(*this, roomId);
+    endpoints_.emplace(roomId, endpoint.get());
+    return endpoint;
+}
+
+void NetworkRouter::setDefaultRoom(const std::optional<RoomId> roomId) {
+    std::lock_guard lock(mutex_);
+    if (roomId && !endpoints_.contains(*roomId)) {
+        throw std::invalid_argument("Default room has no network endpoint");
+    }
+    defaultRoom_ = roomId;
+}
+
+std::optional<RoomId> NetworkRouter::getDefaultRoom() const {
+    std::lock_guard lock(mutex_);
+    return defaultRoom_;
+}
+
+void NetworkRouter::assignClient(const ClientId clientId, const RoomId roomId) {
+    std::lock_guard lock(mutex_);
+    const auto clientRoom = clientRooms_.find(clientId);
+    if (clientRoom == clientRooms_.end()) {
+        throw std::invalid_argument("Cannot assign a client that is not connected to a room");
+    }
+    if (!endpoints_.contains(roomId)) {
+        throw std::invalid_argument("Cannot assign a client to a room without a network endpoint");
+    }
+    if (clientRoom->second == roomId) {
+        return;
+    }
+
+    if (clientRoom->second) {
+        deliver(*clientRoom->second, {clientId, {}, MessageType::Disconnect});
+    }
+    clientRoom->second = roomId;
+    deliver(roomId, {clientId, {}, MessageType::Connect});
+}
+
+std::optional<RoomId> NetworkRouter::getClientRoom(const ClientId clientId) const {
+    std::lock_guard lock(mutex_);
+    return findClientRoom(clientId);
+}
+
+void NetworkRouter::route() {
+    std::lock_guard lock(mutex_);
+    while (auto message = transport_->recieve()) {
+        if (const auto disconnected = disconnectedClients_.find(message->clientId);
+            disconnected != disconnectedClients_.end()) {
+            if (message->type != MessageType::Connect) {
+                if (message->type == MessageType::Disconnect) {
+                    disconnectedClients_.erase(disconnected);
+                }
+                continue;
+            }
+            // The transport has reused the client's ID for a new connection
+            disconnectedClients_.erase(disconnected);
+        }
+        if (message->type == MessageType::Disconnect) {
+            if (const auto clientRoom = clientRooms_.find(message->clientId); clientRoom != clientRooms_.end()) {
+                if (clientRoom->second) {
+                    deliver(*clientRoom->second, std::move(*message));
+                }
+                clientRooms_.erase(clientRoom);
+            }
+            continue;
+        }
+
+        // Clients sending data before their Connect event are treated as connecting, as NetworkEngine does
+        auto clientRoom = clientRooms_.find(message->clientId);
+        if (clientRoom == clientRooms_.end()) {
+            clientRoom = clientRooms_.emplace(message->clientId, defaultRoom_).first;
+            if (defaultRoom_ && message->type == MessageType::Data) {
+                deliver(*defaultRoom_, {message->clientId, {}, MessageType::Connect});
+            }
+        } else if (message->type == MessageType::Connect) {
+            continue;
+        }
+
+        if (clientRoom->second) {
+            deliver(*clientRoom->second, std::move(*message));
+        }
+#ifdef __DEBUG
+        else if (message->type == MessageType::Data) {
+            debug("Discarded message from client not in a room:", static_cast<int>(message->clientId));
+        }
+#endif
+    }
+    // Every message the transport held when these clients were disconnected has now been discarded, and transports
+    // deliver none once a client is disconnected
+    disconnectedClients_.clear();
+}
+
+std::optional<RoomId> NetworkRouter::findClientRoom(const ClientId clientId) const {
+    const auto clientRoom = clientRooms_.find(clientId);
+    return clientRoom != clientRooms_.end() ? clientRoom->second : std::nullopt;
+}
+
+void NetworkRouter::deliver(const RoomId roomId, Message message) {
+    endpoints_.at(roomId)->deliver(std::move(message));
+}
+
+void NetworkRouter::send(const RoomId roomId, Message message) {
+    std::lock_guard lock(mutex_);
+    // Rooms may still send to clients that have moved to another room until they process the Disconnect event
+    if (findClientRoom(message.clientId) == roomId) {
+        transport_->send(std::move(message));
+    }
+}
+
+void NetworkRouter::disconnect(const RoomId roomId, const ClientId clientId) {
+    std::lock_guard lock(mutex_);
+    if (findClientRoom(clientId) == roomId) {
+        transport_->disconnect(clientId);
+        clientRooms_.erase(clientId);
+        disconnectedClients_.insert(clientId);
+    }
+}
+
+void NetworkRouter::removeEndpoint(const RoomId roomId) {
+    std::lock_guard lock(mutex_);
+    endpoints_.erase(roomId);
+    if (defaultRoom_ == roomId) {
+        defaultRoom_.reset();
+    }
+
+    for (auto clientRoom = clientRooms_.begin(); clientRoom != clientRooms_.end();) {
+        if (clientRoom->second != roomId) {
+            ++clientRoom;
+        } else if (defaultRoom_) {
+            clientRoom->second = defaultRoom_;
+            deliver(*defaultRoom_, {clientRoom->first, {}, MessageType::Connect});
+            ++clientRoom;
+        } else {
+            transport_->disconnect(clientRoom->first);
+            disconnectedClients_.insert(clientRoom->first);
+            clientRoom = clientRooms_.erase(clientRoom);
+        }
+    }
+}
@@ -0,0 +1,401 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include "PhysicsWorld.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+#include "utils/VectorBatch.h"
+
+namespace {
+// The fraction of the overlap of each collision removed by moving its bodies apart
+constexpr float correctionPercent = 0.8f;
+// The overlap left between bodies, so that resting bodies keep touching rather than jittering in and out of contact
+constexpr float correctionSlop = 0.01f;
+}
+
+BodyHandle PhysicsWorld::createBody(const BodyDefinition& definition) {
+    const Vector2F halfExtents = definition.shape == BodyShape::Circle
+        ? Vector2F(definition.radius)
+        : definition.halfExtents;
+    if (halfExtents.x < 0.f || halfExtents.y < 0.f) {
+        throw std::invalid_argument("Physics body size must not be negative");
+    }
+    if (definition.mass < 0.f) {
+        throw std::invalid_argument("Physics body mass must not be negative");
+    }
+
+    uint32_t slot;
+    if (!freeSlots_.empty()) {
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(slots_.size());
+        slots_.emplace_back();
+    }
+    const auto index = static_cast<uint32_t>(positionX_.size());
+    slots_[slot].index = index;
+    slots_[slot].alive = true;
+
+    bodySlots_.push_back(slot);
+    shapes_.push_back(definition.shape);
+    positionX_.push_back(definition.position.x);
+    positionY_.push_back(definition.position.y);
+    velocityX_.push_back(definition.velocity.x);
+    velocityY_.push_back(definition.velocity.y);
+    halfExtentX_.push_back(halfExtents.x);
+    halfExtentY_.push_back(halfExtents.y);
+    inverseMass_.push_back(definition.mass > 0.f ? 1.f / definition.mass : 0.f);
+    gravityScale_.push_back(definition.mass > 0.f ? definition.gravityScale : 0.f);
+    timeScale_.push_back(definition.mass > 0.f ? 1.f : 0.f);
+    restitution_.push_back(definition.restitution);
+    layers_.push_back(definition.layers);
+    collidesWith_.push_back(definition.collidesWith);
+    minX_.emplace_back();
+    minY_.emplace_back();
+    maxX_.emplace_back();
+    maxY_.emplace_back();
+    updateBounds(index);
+
+    const BodyHandle body{slot, slots_[slot].generation};
+    createdBodies_.push_back(body);
+    return body;
+}
+
+void PhysicsWorld::destroyBody(const BodyHandle body) {
+    if (!isValid(body)) {
+        return;
+    }
+    Slot& slot = slots_[body.slot];
+    const uint32_t index = slot.index;
+    const auto last = static_cast<uint32_t>(positionX_.size() - 1);
+
+    // Move the last body into the destroyed body's place so the arrays stay dense
+    if (index != last) {
+        bodySlots_[index] = bodySlots_[last];
+        shapes_[index] = shapes_[last];
+        positionX_[index] = positionX_[last];
+        positionY_[index] = positionY_[last];
+        velocityX_[index] = velocityX_[last];
+        velocityY_[index] = velocityY_[last];
+        halfExtentX_[index] = halfExtentX_[last];
+        halfExtentY_[index] = halfExtentY_[last];
+        inverseMass_[index] = inverseMass_[last];
+        gravityScale_[index] = gravityScale_[last];
+        timeScale_[index] = timeScale_[last];
+        restitution_[index] = restitution_[last];
+        layers_[index] = layers_[last];
+        collidesWith_[index] = collidesWith_[last];
+        minX_[index] = minX_[last];
+        minY_[index] = minY_[last];
+        maxX_[index] = maxX_[last];
+        maxY_[index] = maxY_[last];
+        slots_[bodySlots_[index]].index = index;
+    }
+    bodySlots_.pop_back();
+    shapes_.pop_back();
+    positionX_.pop_back();
+    positionY_.pop_back();
+    velocityX_.pop_back();
+    velocityY_.pop_back();
+    halfExtentX_.pop_back();
+    halfExtentY_.pop_back();
+    inverseMass_.pop_back();
+    gravityScale_.pop_back();
+    timeScale_.pop_back();
+    restitution_.pop_back();
+    layers_.pop_back();
+    collidesWith_.pop_back();
+    minX_.pop_back();
+    minY_.pop_back();
+    maxX_.pop_back();
+    maxY_.pop_back();
+
+    slot.alive = false;
+    slot.generation++;
+    freeSlots_.push_back(body.slot);
+}
+
+bool PhysicsWorld::isValid(const BodyHandle body) const {
+    return body.slot < slots_.size() && slots_[body.slot].alive && slots_[body.slot].generation == body.generation;
+}
+
+Vector2F PhysicsWorld::getPosition(const BodyHandle body) const {
+    const uint32_t index = getIndex(body);
+    return {positionX_[index], positionY_[index]};
+}
+
+void PhysicsWorld::setPosition(const BodyHandle body, const Vector2F position) {
+    const uint32_t index = getIndex(body);
+    positionX_[index] = position.x;
+    positionY_[index] = position.y;
+}
+
+Vector2F PhysicsWorld::getVelocity(const BodyHandle body) const {
+    const uint32_t index = getIndex(body);
+    return {velocityX_[index], velocityY_[index]};
+}
+
+void PhysicsWorld::setVelocity(const BodyHandle body, const Vector2F velocity) {
+    const uint32_t index = getIndex(body);
+    velocityX_[index] = velocity.x;
+    velocityY_[index] = velocity.y;
+}
+
+void PhysicsWorld::applyImpulse(const BodyHandle body, const Vector2F impulse) {
+    const uint32_t index = getIndex(body);
+    velocityX_[index] += impulse.x * inverseMass_[index];
+    velocityY_[index] += impulse.y * inverseMass_[index];
+}
+
+Rectangle2F PhysicsWorld::getBounds(const BodyHandle body) const {
+    const uint32_t index = getIndex(body);
+    return {positionX_[index] - halfExtentX_[index], positionY_[index] - halfExtentY_[index],
+            halfExtentX_[index] * 2.f, halfExtentY_[index] * 2.f};
+}
+
+void PhysicsWorld::setSolverIterations(const uint32_t iterations) {
+    if (iterations == 0) {
+        throw std::invalid_argument("Physics solver iterations must be at least 1");
+    }
+    solverIterations_ = iterations;
+}
+
+void PhysicsWorld::step(const float deltaTime) {
+    const size_t bodyCount = positionX_.size();
+
+    // Static bodies have a gravity and time scale of 0, so every body is integrated without branching around them
+    addScaledValues(velocityX_, gravityScale_, gravity_.x * deltaTime);
+    addScaledValues(velocityY_, gravityScale_, gravity_.y * deltaTime);
+    integratePositions(positionX_, positionY_, velocityX_, velocityY_, timeScale_, deltaTime);
+    for (uint32_t index = 0; index < bodyCount; index++) {
+        updateBounds(index);
+    }
+
+    sortBodies();
+    findPairs();
+
+    for (uint32_t iteration = 0; iteration < solverIterations_; iteration++) {
+        for (const BodyPair& pair: pairs_) {
+            resolvePair(pair);
+        }
+    }
+    contacts_.clear();
+    for (const BodyPair& pair: pairs_) {
+        correctPair(pair);
+        contacts_.push_back({
+            {bodySlots_[pair.first], slots_[bodySlots_[pair.first]].generation},
+            {bodySlots_[pair.second], slots_[bodySlots_[pair.second]].generation},
+            pair.normal, pair.penetration
+        });
+    }
+}
+
+uint32_t PhysicsWorld::getIndex(const BodyHandle body) const {
+    if (!isValid(body)) {
+        throw std::invalid_argument("Physics body has been destroyed");
+    }
+    return slots_[body.slot].index;
+}
+
+void PhysicsWorld::updateBounds(const uint32_t index) {
+    minX_[index] = positionX_[index] - halfExtentX_[index];
+    minY_[index] = positionY_[index] - halfExtentY_[index];
+    maxX_[index] = positionX_[index] + halfExtentX_[index];
+    maxY_[index] = positionY_[index] + halfExtentY_[index];
+}
+
+void PhysicsWorld::sortBodies() {
+    const auto isDestroyed = [this](const BodyHandle& body) { return !isValid(body); };
+    std::erase_if(sortedBodies_, isDestroyed);
+    std::erase_if(createdBodies_, isDestroyed);
+
+    // Bodies move little between steps so the list is nearly sorted, which insertion sort handles in close to linear
+    // time where std::sort would not
+    for (size_t sorted = 1; sorted < sortedBodies_.size(); sorted++) {
+        const BodyHandle body = sortedBodies_[sorted];
+        const float minX = minX_[slots_[body.slot].index];
+        size_t position = sorted;
+        while (position > 0 && minX_[slots_[sortedBodies_[position - 1].slot].index] > minX) {
+            sortedBodies_[position] = sortedBodies_[position - 1];
+            position--;
+        }
+        sortedBodies_[position] = body;
+    }
+
+    // New bodies can be anywhere, so they are sorted on their own and merged in rather than inserted one at a time
+    if (!createdBodies_.empty()) {
+        const auto byMinX = [this](const BodyHandle& first, const BodyHandle& second) {
+            return minX_[slots_[first.slot].index] < minX_[slots_[second.slot].index];
+        };
+        std::ranges::stable_sort(createdBodies_, byMinX);
+        const auto middle = static_cast<std::ptrdiff_t>(sortedBodies_.size());
+        sortedBodies_.insert(sortedBodies_.end(), createdBodies_.begin(), createdBodies_.end());
+        std::inplace_merge(sortedBodies_.begin(), sortedBodies_.begin() + middle, sortedBodies_.end(), byMinX);
+        createdBodies_.clear();
+    }
+
+    const size_t sortedCount = sortedBodies_.size();
+    sortedIndices_.resize(sortedCount);
+    sortedMinX_.resize(sortedCount);
+    sortedMinY_.resize(sortedCount);
+    sortedMaxX_.resize(sortedCount);
+    sortedMaxY_.resize(sortedCount);
+    for (size_t sorted = 0; sorted < sortedCount; sorted++) {
+        const uint32_t index = slots_[sortedBodies_[sorted].slot].index;
+        sortedIndices_[sorted] = index;
+        sortedMinX_[sorted] = minX_[index];
+        sortedMinY_[sorted] = minY_[index];
+        sortedMaxX_[sorted] = maxX_[index];
+        sortedMaxY_[sorted] = maxY_[index];
+    }
+}
+
+void PhysicsWorld::findPairs() {
+    pairs_.clear();
+    const size_t sortedCount = sortedIndices_.size();
+    for (size_t sorted = 0; sorted < sortedCount; sorted++) {
+        const uint32_t first = sortedIndices_[sorted];
+
+        // Only the bodies starting before this one ends can overlap it along the x-axis
+        const size_t begin = sorted + 1;
+        size_t end = begin;
+        while (end < sortedCount && sortedMinX_[end] <= maxX_[first]) {
+            end++;
+        }
+        if (end == begin) {
+            continue;
+        }
+
+        const size_t count = end - begin;
+        const Rectangle2F bounds(minX_[first], minY_[first], maxX_[first] - minX_[first], maxY_[first] - minY_[first]);
+        overlapMask_.resize((count + 63) / 64);
+        getOverlapMask(std::span(sortedMinX_).subspan(begin, count), std::span(sortedMinY_).subspan(begin, count),
+                       std::span(sortedMaxX_).subspan(begin, count), std::span(sortedMaxY_).subspan(begin, count),
+                       bounds, overlapMask_);
+
+        for (size_t word = 0; word < overlapMask_.size(); word++) {
+            for (uint64_t bits = overlapMask_[word]; bits != 0; bits &= bits - 1) {
+                const uint32_t second = sortedIndices_[begin + word * 64 + std::countr_zero(bits)];
+                if (inverseMass_[first] == 0.f && inverseMass_[second] == 0.f) {
+                    continue;
+                }
+                if (!(layers_[first] & collidesWith_[second]) || !(layers_[second] & collidesWith_[first])) {
+                    continue;
+                }
+                BodyPair pair{first, second, {}, 0.f};
+                if (testPair(first, second, pair)) {
+                    pairs_.push_back(pair);
+                }
+            }
+        }
+    }
+}
+
+bool PhysicsWorld::testPair(const uint32_t first, const uint32_t second, BodyPair& pair) const {
+    const float deltaX = positionX_[second] - positionX_[first];
+    const float deltaY = positionY_[second] - positionY_[first];
+
+    if (shapes_[first] == BodyShape::Box && shapes_[second] == BodyShape::Box) {
+        // Separate the boxes along the axis they overlap least on
+        const float overlapX = halfExtentX_[first] + halfExtentX_[second] - std::abs(deltaX);
+        const float overlapY = halfExtentY_[first] + halfExtentY_[second] - std::abs(deltaY);
+        if (overlapX <= 0.f || overlapY <= 0.f) {
+            return false;
+        }
+        if (overlapX < overlapY) {
+            pair.normal = {deltaX < 0.f ? -1.f : 1.f, 0.f};
+            pair.penetration = overlapX;
+        } else {
+            pair.normal = {0.f, deltaY < 0.f ? -1.f : 1.f};
+            pair.penetration = overlapY;
+        }
+        return true;
+    }
+
+    if (shapes_[first] == BodyShape::Circle && shapes_[second] == BodyShape::Circle) {
+        const float radii = halfExtentX_[first] + halfExtentX_[second];
+        const float distanceSquared = deltaX * deltaX + deltaY * deltaY;
+        if (distanceSquared >= radii * radii) {
+            return false;
+        }
+        const float distance = std::sqrt(distanceSquared);
+        pair.normal = distance > 0.f ? Vector2F(deltaX / distance, deltaY / distance) : Vector2F(1.f, 0.f);
+        pair.penetration = radii - distance;
+        return true;
+    }
+
+    // A box and a circle, tested from the box to the circle and flipped if the circle is the first body
+    const bool circleFirst = shapes_[first] == BodyShape::Circle;
+    const uint32_t box = circleFirst ? second : first;
+    const uint32_t circle = circleFirst ? first : second;
+    const float offsetX = circleFirst ? -deltaX : deltaX;
+    const float offsetY = circleFirst ? -deltaY : deltaY;
+    const float radius = halfExtentX_[circle];
+
+    const float closestX = std::clamp(offsetX, -halfExtentX_[box], halfExtentX_[box]);
+    const float closestY = std::clamp(offsetY, -halfExtentY_[box], halfExtentY_[box]);
+    Vector2F normal;
+    if (closestX != offsetX || closestY != offsetY) {
+        // The circle's centre is outside the box, so it collides with the closest point on the box
+        const float separationX = offsetX - closestX;
+        const float separationY = offsetY - closestY;
+        const float distanceSquared = separationX * separationX + separationY * separationY;
+        if (distanceSquared >= radius * radius) {
+            return false;
+        }
+        const float distance = std::sqrt(distanceSquared);
+        normal = {separationX / distance, separationY / distance};
+        pair.penetration = radius - distance;
+    } else {
+        // The circle's centre is inside the box, so it is pushed out through the nearest edge
+        const float edgeX = halfExtentX_[box] - std::abs(offsetX);
+        const float edgeY = halfExtentY_[box] - std::abs(offsetY);
+        if (edgeX < edgeY) {
+            normal = {offsetX < 0.f ? -1.f : 1.f, 0.f};
+            pair.penetration = radius + edgeX;
+        } else {
+            normal = {0.f, offsetY < 0.f ? -1.f : 1.f};
+            pair.penetration = radius + edgeY;
+        }
+    }
+    pair.normal = circleFirst ? Vector2F(-normal.x, -normal.y) : normal;
+    return true;
+}
+
+void PhysicsWorld::resolvePair(const BodyPair& pair) {
+    const uint32_t first = pair.first;
+    const uint32_t second = pair.second;
+    const float normalVelocity = (velocityX_[second] - velocityX_[first]) * pair.normal.x
+        + (velocityY_[second] - velocityY_[first]) * pair.normal.y;
+    // The bodies are already moving apart
+    if (normalVelocity > 0.f) {
+        return;
+    }
+
+    const float restitution = std::min(restitution_[first], restitution_[second]);
+    const float impulse = -(1.f + restitution) * normalVelocity / (inverseMass_[first] + inverseMass_[second]);
+    velocityX_[first] -= impulse * pair.normal.x * inverseMass_[first];
+    velocityY_[first] -= impulse * pair.normal.y * inverseMass_[first];
+    velocityX_[second] += impulse * pair.normal.x * inverseMass_[second];
+    velocityY_[second] += impulse * pair.normal.y * inverseMass_[second];
+}
+
+void PhysicsWorld::correctPair(const BodyPair& pair) {
+    const uint32_t first = pair.first;
+    const uint32_t second = pair.second;
+    const float correction = std::max(pair.penetration - correctionSlop, 0.f) * correctionPercent
+        / (inverseMass_[first] + inverseMass_[second]);
+    positionX_[first] -= correction * pair.normal.x * inverseMass_[first];
+    positionY_[first] -= correction * pair.normal.y * inverseMass_[first];
+    positionX_[second] += correction * pair.normal.x * inverseMass_[second];
+    positionY_[second] += correction * pair.normal.y * inverseMass_[second];
+}
@@ -0,0 +1,114 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include "ReplicationFrame.h"
+
+void ReplicationFrame::clear() {
+    for (const Object& object: objects_) {
+        objectIndices_[object.instanceId] = 0;
+    }
+    typeIds_.clear();
+    objects_.clear();
+    stores_.clear();
+    bytes_.clear();
+}
+
+void ReplicationFrame::addObjects(const TypeId typeId, const PackBatchFunction packBatch,
+                                  const std::span<IReplicatable* const> objects) {
+    if (objects.empty()) {
+        return;
+    }
+    const auto typeIndex = static_cast<uint32_t>(typeIds_.size());
+    typeIds_.push_back(typeId);
+
+    // One call serializes the whole batch and records every object, the map header is left out of the objects
+    packedObjects_.resize(objects.size());
+    packBatch(bytes_, objects, packedObjects_.data());
+    objects_.reserve(objects_.size() + objects.size());
+    for (size_t index = 0; index < packedObjects_.size(); index++) {
+        const PackedObject& packed = packedObjects_[index];
+        const size_t end = index + 1 < packedObjects_.size() ? packedObjects_[index + 1].offset : bytes_.size();
+        if (packed.instanceId >= objectIndices_.size()) {
+            objectIndices_.resize(packed.instanceId + 1, 0);
+        }
+        objectIndices_[packed.instanceId] = static_cast<uint32_t>(objects_.size() + 1);
+        objects_.push_back({
+            packed.instanceId, typeIndex, packed.position, packed.priority,
+            static_cast<uint32_t>(packed.offset), static_cast<uint32_t>(end - packed.offset)
+        });
+    }
+}
+
+void ReplicationFrame::addStore(const IReplicatedStore& store) {
+    if (store.size() == 0) {
+        return;
+    }
+    const auto offset = static_cast<uint32_t>(bytes_.size());
+    msgpack::packer packer(bytes_);
+    store.pack(packer);
+    stores_.push_back({store.getTypeId(), offset, static_cast<uint32_t>(bytes_.size()) - offset});
+}
+
+std::optional<uint32_t> ReplicationFrame::findObject(const InstanceId instanceId) const {
+    if (instanceId >= objectIndices_.size() || objectIndices_[instanceId] == 0) {
+        return std::nullopt;
+    }
+    return objectIndices_[instanceId] - 1;
+}
+
+void ReplicationFrame::pack(msgpack::sbuffer& buffer) const {
+    msgpack::packer packer(buffer);
+    packer.pack_map(static_cast<uint32_t>(typeIds_.size() + stores_.size()));
+    size_t objectIndex = 0;
+    for (uint32_t typeIndex = 0; typeIndex < typeIds_.size(); typeIndex++) {
+        const size_t typeStart = objectIndex;
+        while (objectIndex < objects_.size() && objects_[objectIndex].typeIndex == typeIndex) {
+            objectIndex++;
+        }
+        packer.pack(typeIds_[typeIndex]);
+        packer.pack_map(static_cast<uint32_t>(objectIndex - typeStart));
+        // Objects of a type are captured one after another, so the whole batch is copied at once
+        const Object& first = objects_[typeStart];
+        const Object& last = objects_[objectIndex - 1];
+        buffer.write(bytes_.data() + first.offset, last.offset + last.size - first.offset);
+    }
+    packStores(buffer);
+}
+
+void ReplicationFrame::pack(msgpack::sbuffer& buffer, const std::span<const uint32_t> objectIndices) const {
+    msgpack::packer packer(buffer);
+    uint32_t typeCount = 0;
+    for (size_t index = 0; index < objectIndices.size(); index++) {
+        if (index == 0 || objects_[objectIndices[index]].typeIndex != objects_[objectIndices[index - 1]].typeIndex) {
+            typeCount++;
+        }
+    }
+    packer.pack_map(typeCount + static_cast<uint32_t>(stores_.size()));
+
+    for (size_t index = 0; index < objectIndices.size();) {
+        const uint32_t typeIndex = objects_[objectIndices[index]].typeIndex;
+        size_t typeEnd = index;
+        while (typeEnd < objectIndices.size() && objects_[objectIndices[typeEnd]].typeIndex == typeIndex) {
+            typeEnd++;
+        }
+        packer.pack(typeIds_[typeIndex]);
+        packer.pack_map(static_cast<uint32_t>(typeEnd - index));
+        for (; index < typeEnd; index++) {
+            const Object& object = objects_[objectIndices[index]];
+            buffer.write(bytes_.data() + object.offset, object.size);
+        }
+    }
+    packStores(buffer);
+}
+
+void ReplicationFrame::packStores(msgpack::sbuffer& buffer) const {
+    msgpack::packer packer(buffer);
+    for (const Store& store: stores_) {
+        packer.pack(store.typeId);
+        buffer.write(bytes_.data() + store.offset, store.size);
+    }
+}
@@ -0,0 +1,79 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include "ReplicationScheduler.h"
+
+#include <algorithm>
+
+void ReplicationScheduler::setBandwidth(const uint32_t bandwidth) {
+    bandwidth_ = bandwidth;
+    byteCredit_ = 0.0;
+}
+
+void ReplicationScheduler::schedule(const std::span<const Candidate> candidates, const float deltaTime,
+                                    std::vector<size_t>& selected) {
+    // Carry over the state of objects that are still relevant, both lists being sorted by instance ID
+    nextObjects_.clear();
+    auto previous = objects_.begin();
+    for (const Candidate& candidate: candidates) {
+        while (previous != objects_.end() && previous->instanceId < candidate.instanceId) {
+            ++previous;
+        }
+        ObjectState state{candidate.instanceId, 0.f, false};
+        if (previous != objects_.end() && previous->instanceId == candidate.instanceId) {
+            state = *previous;
+        }
+        state.accumulatedPriority += candidate.priority * deltaTime;
+        nextObjects_.push_back(state);
+    }
+    std::swap(objects_, nextObjects_);
+
+    selected.clear();
+    if (bandwidth_ == 0) {
+        for (size_t index = 0; index < objects_.size(); index++) {
+            objects_[index].accumulatedPriority = 0.f;
+            objects_[index].sent = true;
+            selected.push_back(index);
+        }
+        return;
+    }
+
+    const double updateBudget = static_cast<double>(bandwidth_) * deltaTime;
+    byteCredit_ = std::min(byteCredit_ + updateBudget, updateBudget);
+
+    order_.resize(objects_.size());
+    for (size_t index = 0; index < order_.size(); index++) {
+        order_[index] = index;
+    }
+    std::ranges::sort(order_, [this](const size_t a, const size_t b) {
+        const ObjectState& stateA = objects_[a];
+        const ObjectState& stateB = objects_[b];
+        if (stateA.sent != stateB.sent) return !stateA.sent;
+        if (stateA.accumulatedPriority != stateB.accumulatedPriority) {
+            return stateA.accumulatedPriority > stateB.accumulatedPriority;
+        }
+        return stateA.instanceId < stateB.instanceId;
+    });
+
+    // Smaller objects further down the order may still fit after a larger one has been deferred
+    for (const size_t index: order_) {
+        if (candidates[index].size <= byteCredit_) {
+            byteCredit_ -= candidates[index].size;
+            selected.push_back(index);
+        }
+    }
+    if (selected.empty() && !order_.empty() && byteCredit_ >= updateBudget) {
+        byteCredit_ -= candidates[order_.front()].size;
+        selected.push_back(order_.front());
+    }
+
+    for (const size_t index: selected) {
+        objects_[index].accumulatedPriority = 0.f;
+        objects_[index].sent = true;
+    }
+    std::ranges::sort(selected);
+}
@@ -0,0 +1,37 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include "Room.h"
+
+Room::Room(const RoomId roomId, std::unique_ptr<INetworkProtocol> networkPort, const uint64_t randomSeed)
+    : id_(roomId)
+    , networkEngine_(std::move(networkPort))
+    , random_(randomSeed) {
+}
+
+void Room::tick(const float deltaTime, const std::optional<std::chrono::steady_clock::time_point> deadline) {
+    const auto startTime = std::chrono::steady_clock::now();
+    currentTick_++;
+    const AllocationCounts tickStart = AllocationTracker::getThreadCounts();
+    networkEngine_.applyClientCommands();
+    const AllocationCounts commandsEnd = AllocationTracker::getThreadCounts();
+    if (updateHandler_) {
+        updateHandler_(deltaTime);
+    }
+    const AllocationCounts updateEnd = AllocationTracker::getThreadCounts();
+    networkEngine_.update(deltaTime);
+    const AllocationCounts networkEnd = AllocationTracker::getThreadCounts();
+
+    const auto endTime = std::chrono::steady_clock::now();
+    const bool missedDeadline = deadline && endTime > *deadline;
+    if (missedDeadline) {
+        missedDeadlineCount_++;
+    }
+    lastTickStats_ = {
+        commandsEnd - tickStart, updateEnd - commandsEnd, networkEnd - updateEnd, endTime - startTime, missedDeadline
+    };
+}
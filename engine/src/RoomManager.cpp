@@ -0,0 +1,143 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include "RoomManager.h"
+
+#include <algorithm>
+#include <utility>
+
+RoomManager::RoomManager(std::unique_ptr<INetworkProtocol> transport) : router_(std::move(transport)) {}
+
+Room& RoomManager::createRoom() {
+    std::lock_guard lock(roomsMutex_);
+    const RoomId roomId = nextRoomId_++;
+    auto room = std::make_unique<Room>(roomId, router_.createEndpoint(roomId), Random::deriveSeed(randomSeed_, roomId));
+    room->getNetworkEngine().setSnapshotPool(pool_.get());
+    roomIndices_.emplace(roomId, rooms_.size());
+    return *rooms_.emplace_back(std::move(room));
+}
+
+void RoomManager::destroyRoom(const RoomId roomId) {
+    std::lock_guard lock(roomsMutex_);
+    destroyRoomLocked(roomId);
+}
+
+void RoomManager::destroyRoomLocked(const RoomId roomId) {
+    const auto roomIndex = roomIndices_.find(roomId);
+    if (roomIndex == roomIndices_.end()) {
+        return;
+    }
+    if (ticking_) {
+        pendingDestroyedRooms_.push_back(roomId);
+        return;
+    }
+
+    // Rooms are kept in creation order so that they tick in a stable order
+    const size_t index = roomIndex->second;
+    roomIndices_.erase(roomIndex);
+    rooms_.erase(rooms_.begin() + static_cast<std::ptrdiff_t>(index));
+    for (size_t later = index; later < rooms_.size(); later++) {
+        roomIndices_[rooms_[later]->getId()] = later;
+    }
+}
+
+Room* RoomManager::findRoom(const RoomId roomId) const {
+    std::lock_guard lock(roomsMutex_);
+    const auto roomIndex = roomIndices_.find(roomId);
+    return roomIndex != roomIndices_.end() ? rooms_[roomIndex->second].get() : nullptr;
+}
+
+Room* RoomManager::getDefaultRoom() const {
+    const auto roomId = router_.getDefaultRoom();
+    return roomId ? findRoom(*roomId) : nullptr;
+}
+
+Room* RoomManager::getClientRoom(const ClientId clientId) const {
+    const auto roomId = router_.getClientRoom(clientId);
+    return roomId ? findRoom(*roomId) : nullptr;
+}
+
+size_t RoomManager::getRoomCount() const {
+    std::lock_guard lock(roomsMutex_);
+    return rooms_.size();
+}
+
+void RoomManager::setWorkerCount(const size_t workerCount, const bool pinThreads) {
+    std::lock_guard lock(roomsMutex_);
+    for (const std::unique_ptr<Room>& room: rooms_) {
+        room->getNetworkEngine().setSnapshotPool(nullptr);
+    }
+    pool_.reset();
+    if (workerCount == 0) {
+        return;
+    }
+    pool_ = std::make_unique<WorkStealingPool>(workerCount, pinThreads);
+    // Rooms build their players' snapshots on the same pool as they tick on
+    for (const std::unique_ptr<Room>& room: rooms_) {
+        room->getNetworkEngine().setSnapshotPool(pool_.get());
+    }
+}
+
+void RoomManager::tick(const float deltaTime) {
+    const auto deadline = std::chrono::steady_clock::now()
+        + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(deltaTime));
+    router_.route();
+
+    {
+        std::lock_guard lock(roomsMutex_);
+        ticking_ = true;
+        // Rooms created during the tick are first ticked on the next one
+        tickOrder_.clear();
+        for (const std::unique_ptr<Room>& room: rooms_) {
+            tickOrder_.push_back(room.get());
+        }
+    }
+
+    std::exception_ptr exception;
+    if (!pool_) {
+        for (Room* room: tickOrder_) {
+            try {
+                room->tick(deltaTime, deadline);
+            } catch (...) {
+                exception = exception ? exception : std::current_exception();
+            }
+        }
+    } else {
+        // Pool tasks run newest first on each worker, so rooms are submitted shortest first to start the longest first
+        std::ranges::stable_sort(tickOrder_, [](const Room* first, const Room* second) {
+            return first->getLastTickStats().duration < second->getLastTickStats().duration;
+        });
+        tickDeltaTime_ = deltaTime;
+        tickDeadline_ = deadline;
+        remainingRoomTicks_ = tickOrder_.size();
+        for (Room* room: tickOrder_) {
+            pool_->submit([this, room] {
+                try {
+                    room->tick(tickDeltaTime_, tickDeadline_);
+                } catch (...) {
+                    std::lock_guard lock(tickExceptionMutex_);
+                    tickException_ = tickException_ ? tickException_ : std::current_exception();
+                }
+                remainingRoomTicks_.fetch_sub(1);
+            }, this);
+        }
+        pool_->waitFor(remainingRoomTicks_, this);
+        exception = std::exchange(tickException_, nullptr);
+    }
+
+    {
+        std::lock_guard lock(roomsMutex_);
+        ticking_ = false;
+        for (const RoomId roomId: pendingDestroyedRooms_) {
+            destroyRoomLocked(roomId);
+        }
+        pendingDestroyedRooms_.clear();
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
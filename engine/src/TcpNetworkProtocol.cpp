@@ -7,6 +7,7 @@
 
 #include "TcpNetworkProtocol.h"
 
+#include <algorithm>
 #include <iostream>
 #include <mutex>
 #include <stdexcept>
@@ -76,14 +77,26 @@ std::optional<Message> TcpNetworkProtocol::recieve() {
     if (incomingMessageQueue_.empty()) {
         return std::nullopt;
     }
-    auto message = incomingMessageQueue_.front();
+    auto message = std::move(incomingMessageQueue_.front());
     incomingMessageQueue_.pop();
     return message;
 }
 
-void TcpNetworkProtocol::send(const Message message) {
+void TcpNetworkProtocol::send(Message message) {
     std::lock_guard lock(outgoingMessageQueueMutex_);
-    outgoingMessageQueue_.push(message);
+    outgoingMessageQueue_.push(std::move(message));
+}
+
+void TcpNetworkProtocol::disconnect(const ClientId clientId) {
+    const auto isClients = [clientId](const Message& message) { return message.clientId == clientId; };
+    {
+        // The socket is closed by the receive thread, which drops the client's data until then
+        std::lock_guard lock(incomingMessageQueueMutex_);
+        serverClosedClients_.push_back(clientId);
+        incomingMessageQueue_.eraseIf(isClients);
+    }
+    std::lock_guard lock(outgoingMessageQueueMutex_);
+    outgoingMessageQueue_.eraseIf(isClients);
 }
 
 bool TcpNetworkProtocol::acceptSocket() {
@@ -94,13 +107,48 @@ bool TcpNetworkProtocol::acceptSocket() {
         return false;
     }
     std::lock_guard incomingMessageQueueLock(incomingMessageQueueMutex_);
-    incomingMessageQueue_.push({nextClientId, {}});
+    incomingMessageQueue_.push({nextClientId, {}, MessageType::Connect});
     nextClientId++;
     return true;
 }
 
+void TcpNetworkProtocol::closeSockets(const std::vector<ClientId>& clientIds) {
+    if (clientIds.empty()) return;
+    std::unique_lock socketsLock(socketsMutex_);
+    std::lock_guard incomingMessageQueueLock(incomingMessageQueueMutex_);
+    for (const ClientId clientId: clientIds) {
+        // The socket may already have been closed, and clients the server disconnected get no Disconnect event
+        if (sockets_.erase(clientId) > 0 && !isServerClosed(clientId)) {
+            incomingMessageQueue_.push({clientId, {}, MessageType::Disconnect});
+        }
+    }
+}
+
+void TcpNetworkProtocol::closeRequestedSockets() {
+    std::vector<ClientId> serverClosedClients;
+    std::vector<ClientId> failedClients;
+    {
+        // Nothing is pushed for the server closed clients between here and closing them, as only this thread pushes
+        std::lock_guard lock(incomingMessageQueueMutex_);
+        serverClosedClients.swap(serverClosedClients_);
+        failedClients.swap(failedClients_);
+    }
+    if (!serverClosedClients.empty()) {
+        std::unique_lock socketsLock(socketsMutex_);
+        for (const ClientId clientId: serverClosedClients) {
+            sockets_.erase(clientId);
+        }
+    }
+    closeSockets(failedClients);
+}
+
+bool TcpNetworkProtocol::isServerClosed(const ClientId clientId) const {
+    return std::ranges::find(serverClosedClients_, clientId) != serverClosedClients_.end();
+}
+
 void TcpNetworkProtocol::processReceive() {
     while (running_) {
+        closeRequestedSockets();
         int activeSockets = SDLNet_CheckSockets(socketSet_, 100);
         if (activeSockets <= 0) continue;
         if (SDLNet_SocketReady(serverSocket_->get())) {
@@ -114,12 +162,16 @@ void TcpNetworkProtocol::processReceive() {
         {
             std::shared_lock socketsLock(socketsMutex_);
             for (auto &[clientId, socket]: sockets_) {
-                if (SDLNet_SocketReady(socket.get())) {
+                if (SDLNet_SocketReady(socket->get())) {
                     uint8_t buffer[256];
                     int receivedSize = SDLNet_TCP_Recv(socket->get(), buffer, 256);
                     if (receivedSize > 0) {
+                        // Pooled, as the body is released by the game thread rather than this one
+                        auto body = MessageBuffer::copy({buffer, static_cast<size_t>(receivedSize)});
                         std::lock_guard incomingMessageQueueLock(incomingMessageQueueMutex_);
-                        incomingMessageQueue_.push({clientId, std::vector(buffer, buffer + receivedSize)});
+                        if (!isServerClosed(clientId)) {
+                            incomingMessageQueue_.push({clientId, std::move(body)});
+                        }
                     } else {
                         disconnectedClients.push_back(clientId);
                         debug("Client Disconnected");
@@ -127,27 +179,32 @@ void TcpNetworkProtocol::processReceive() {
                 }
             }
         }
-        {
-            std::unique_lock socketsLock(socketsMutex_);
-            for (ClientId clientId: disconnectedClients) {
-                sockets_.erase(clientId);
-            }
-        }
+        closeSockets(disconnectedClients);
     }
 }
 
 void TcpNetworkProtocol::processSend() {
     while (running_) {
-        std::lock_guard outgoingMessageQueueLock(outgoingMessageQueueMutex_);
-        while(!outgoingMessageQueue_.empty()) {
-            auto [clientId, body] = outgoingMessageQueue_.front();
-            if (sockets_[clientId]) {
-                if (SDLNet_TCP_Send(sockets_[clientId]->get(), &body, static_cast<int>(body.size())) < body.size()) {
-                    std::cerr << "SLDNet_TCP_Send: " << SDLNet_GetError() << std::endl;
-                    sockets_.erase(clientId);
+        std::vector<ClientId> failedClients;
+        {
+            std::lock_guard outgoingMessageQueueLock(outgoingMessageQueueMutex_);
+            std::shared_lock socketsLock(socketsMutex_);
+            while(!outgoingMessageQueue_.empty()) {
+                const auto& [clientId, body, type] = outgoingMessageQueue_.front();
+                // Messages for clients that have already disconnected are discarded
+                if (const auto socket = sockets_.find(clientId); socket != sockets_.end()) {
+                    const int bodySize = static_cast<int>(body.size());
+                    if (SDLNet_TCP_Send(socket->second->get(), body.data(), bodySize) < bodySize) {
+                        std::cerr << "SLDNet_TCP_Send: " << SDLNet_GetError() << std::endl;
+                        failedClients.push_back(clientId);
+                    }
                 }
+                outgoingMessageQueue_.pop();
             }
-            outgoingMessageQueue_.pop();
+        }
+        if (!failedClients.empty()) {
+            std::lock_guard incomingMessageQueueLock(incomingMessageQueueMutex_);
+            failedClients_.insert(failedClients_.end(), failedClients.begin(), failedClients.end());
         }
     }
 }
@@ -0,0 +1,264 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include "utils/VectorBatch.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define VECTOR_BATCH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VECTOR_BATCH_SSE2
+#endif
+
+namespace {
+#if defined(VECTOR_BATCH_AVX2)
+    constexpr size_t laneCount = 8;
+#elif defined(VECTOR_BATCH_SSE2)
+    constexpr size_t laneCount = 4;
+#else
+    constexpr size_t laneCount = 1;
+#endif
+
+    // The number of values processed by the vector loops, with the remainder processed one at a time
+    size_t getVectorCount(const size_t count) {
+        return count - count % laneCount;
+    }
+
+    void checkSizes(const size_t expected, const size_t size) {
+        if (size != expected) {
+            throw std::invalid_argument("Vector batch arrays must be the same length");
+        }
+    }
+
+    // Adds each product of two arrays times a factor to each value, as values += first * second * factor
+    void addScaledProducts(const std::span<float> values, const std::span<const float> first,
+                           const std::span<const float> second, const float factor) {
+        const size_t vectorCount = getVectorCount(values.size());
+        size_t index = 0;
+#if defined(VECTOR_BATCH_AVX2)
+        const __m256 factors = _mm256_set1_ps(factor);
+        for (; index < vectorCount; index += laneCount) {
+            const __m256 product = _mm256_mul_ps(_mm256_loadu_ps(&first[index]), _mm256_loadu_ps(&second[index]));
+            const __m256 scaled = _mm256_mul_ps(product, factors);
+            _mm256_storeu_ps(&values[index], _mm256_add_ps(_mm256_loadu_ps(&values[index]), scaled));
+        }
+#elif defined(VECTOR_BATCH_SSE2)
+        const __m128 factors = _mm_set1_ps(factor);
+        for (; index < vectorCount; index += laneCount) {
+            const __m128 product = _mm_mul_ps(_mm_loadu_ps(&first[index]), _mm_loadu_ps(&second[index]));
+            const __m128 scaled = _mm_mul_ps(product, factors);
+            _mm_storeu_ps(&values[index], _mm_add_ps(_mm_loadu_ps(&values[index]), scaled));
+        }
+#endif
+        for (; index < values.size(); index++) {
+            values[index] += first[index] * second[index] * factor;
+        }
+    }
+
+    void clearMask(const size_t count, const std::span<uint64_t> mask) {
+        const size_t wordCount = (count + 63) / 64;
+        if (mask.size() < wordCount) {
+            throw std::invalid_argument("Mask is too small for the number of boxes");
+        }
+        std::fill_n(mask.begin(), wordCount, 0);
+    }
+}
+
+const char* getVectorBatchInstructionSet() {
+#if defined(VECTOR_BATCH_AVX2)
+    return "AVX2";
+#elif defined(VECTOR_BATCH_SSE2)
+    return "SSE2";
+#else
+    return "Scalar";
+#endif
+}
+
+void integratePositions(const std::span<float> positionsX, const std::span<float> positionsY,
+                        const std::span<const float> velocitiesX, const std::span<const float> velocitiesY,
+                        const float deltaTime) {
+    checkSizes(positionsX.size(), positionsY.size());
+    checkSizes(positionsX.size(), velocitiesX.size());
+    checkSizes(positionsX.size(), velocitiesY.size());
+    addScaledValues(positionsX, velocitiesX, deltaTime);
+    addScaledValues(positionsY, velocitiesY, deltaTime);
+}
+
+void integratePositions(const std::span<float> positionsX, const std::span<float> positionsY,
+                        const std::span<const float> velocitiesX, const std::span<const float> velocitiesY,
+                        const std::span<const float> timeScales, const float deltaTime) {
+    checkSizes(positionsX.size(), positionsY.size());
+    checkSizes(positionsX.size(), velocitiesX.size());
+    checkSizes(positionsX.size(), velocitiesY.size());
+    checkSizes(positionsX.size(), timeScales.size());
+    addScaledProducts(positionsX, velocitiesX, timeScales, deltaTime);
+    addScaledProducts(positionsY, velocitiesY, timeScales, deltaTime);
+}
+
+void scaleValues(const std::span<float> values, const float factor) {
+    const size_t vectorCount = getVectorCount(values.size());
+    size_t index = 0;
+#if defined(VECTOR_BATCH_AVX2)
+    const __m256 factors = _mm256_set1_ps(factor);
+    for (; index < vectorCount; index += laneCount) {
+        _mm256_storeu_ps(&values[index], _mm256_mul_ps(_mm256_loadu_ps(&values[index]), factors));
+    }
+#elif defined(VECTOR_BATCH_SSE2)
+    const __m128 factors = _mm_set1_ps(factor);
+    for (; index < vectorCount; index += laneCount) {
+        _mm_storeu_ps(&values[index], _mm_mul_ps(_mm_loadu_ps(&values[index]), factors));
+    }
+#endif
+    for (; index < values.size(); index++) {
+        values[index] *= factor;
+    }
+}
+
+void addScaledValues(const std::span<float> values, const std::span<const float> addends, const float factor) {
+    checkSizes(values.size(), addends.size());
+    const size_t vectorCount = getVectorCount(values.size());
+    size_t index = 0;
+#if defined(VECTOR_BATCH_AVX2)
+    // Multiplied and added separately rather than fused, so results match the scalar loop exactly
+    const __m256 factors = _mm256_set1_ps(factor);
+    for (; index < vectorCount; index += laneCount) {
+        const __m256 scaled = _mm256_mul_ps(_mm256_loadu_ps(&addends[index]), factors);
+        _mm256_storeu_ps(&values[index], _mm256_add_ps(_mm256_loadu_ps(&values[index]), scaled));
+    }
+#elif defined(VECTOR_BATCH_SSE2)
+    const __m128 factors = _mm_set1_ps(factor);
+    for (; index < vectorCount; index += laneCount) {
+        const __m128 scaled = _mm_mul_ps(_mm_loadu_ps(&addends[index]), factors);
+        _mm_storeu_ps(&values[index], _mm_add_ps(_mm_loadu_ps(&values[index]), scaled));
+    }
+#endif
+    for (; index < values.size(); index++) {
+        values[index] += addends[index] * factor;
+    }
+}
+
+void getDistancesSquared(const std::span<const float> positionsX, const std::span<const float> positionsY,
+                         const Vector2F point, const std::span<float> distancesSquared) {
+    checkSizes(positionsX.size(), positionsY.size());
+    checkSizes(positionsX.size(), distancesSquared.size());
+    const size_t vectorCount = getVectorCount(positionsX.size());
+    size_t index = 0;
+#if defined(VECTOR_BATCH_AVX2)
+    const __m256 pointX = _mm256_set1_ps(point.x);
+    const __m256 pointY = _mm256_set1_ps(point.y);
+    for (; index < vectorCount; index += laneCount) {
+        const __m256 deltaX = _mm256_sub_ps(_mm256_loadu_ps(&positionsX[index]), pointX);
+        const __m256 deltaY = _mm256_sub_ps(_mm256_loadu_ps(&positionsY[index]), pointY);
+        _mm256_storeu_ps(&distancesSquared[index],
+                         _mm256_add_ps(_mm256_mul_ps(deltaX, deltaX), _mm256_mul_ps(deltaY, deltaY)));
+    }
+#elif defined(VECTOR_BATCH_SSE2)
+    const __m128 pointX = _mm_set1_ps(point.x);
+    const __m128 pointY = _mm_set1_ps(point.y);
+    for (; index < vectorCount; index += laneCount) {
+        const __m128 deltaX = _mm_sub_ps(_mm_loadu_ps(&positionsX[index]), pointX);
+        const __m128 deltaY = _mm_sub_ps(_mm_loadu_ps(&positionsY[index]), pointY);
+        _mm_storeu_ps(&distancesSquared[index], _mm_add_ps(_mm_mul_ps(deltaX, deltaX), _mm_mul_ps(deltaY, deltaY)));
+    }
+#endif
+    for (; index < positionsX.size(); index++) {
+        const float deltaX = positionsX[index] - point.x;
+        const float deltaY = positionsY[index] - point.y;
+        distancesSquared[index] = deltaX * deltaX + deltaY * deltaY;
+    }
+}
+
+void getOverlapMask(const std::span<const float> minX, const std::span<const float> minY,
+                    const std::span<const float> maxX, const std::span<const float> maxY, const Rectangle2F& area,
+                    const std::span<uint64_t> mask) {
+    const size_t count = minX.size();
+    checkSizes(count, minY.size());
+    checkSizes(count, maxX.size());
+    checkSizes(count, maxY.size());
+    clearMask(count, mask);
+
+    const float areaMaxX = area.x + area.w;
+    const float areaMaxY = area.y + area.h;
+    const size_t vectorCount = getVectorCount(count);
+    size_t index = 0;
+#if defined(VECTOR_BATCH_AVX2)
+    const __m256 areaMinXs = _mm256_set1_ps(area.x);
+    const __m256 areaMinYs = _mm256_set1_ps(area.y);
+    const __m256 areaMaxXs = _mm256_set1_ps(areaMaxX);
+    const __m256 areaMaxYs = _mm256_set1_ps(areaMaxY);
+    for (; index < vectorCount; index += laneCount) {
+        const __m256 overlapX = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(&minX[index]), areaMaxXs, _CMP_LE_OQ),
+                                              _mm256_cmp_ps(_mm256_loadu_ps(&maxX[index]), areaMinXs, _CMP_GE_OQ));
+        const __m256 overlapY = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(&minY[index]), areaMaxYs, _CMP_LE_OQ),
+                                              _mm256_cmp_ps(_mm256_loadu_ps(&maxY[index]), areaMinYs, _CMP_GE_OQ));
+        const auto bits = static_cast<uint64_t>(_mm256_movemask_ps(_mm256_and_ps(overlapX, overlapY)));
+        // Groups of 8 never straddle a 64 bit word
+        mask[index / 64] |= bits << (index % 64);
+    }
+#elif defined(VECTOR_BATCH_SSE2)
+    const __m128 areaMinXs = _mm_set1_ps(area.x);
+    const __m128 areaMinYs = _mm_set1_ps(area.y);
+    const __m128 areaMaxXs = _mm_set1_ps(areaMaxX);
+    const __m128 areaMaxYs = _mm_set1_ps(areaMaxY);
+    for (; index < vectorCount; index += laneCount) {
+        const __m128 overlapX = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&minX[index]), areaMaxXs),
+                                           _mm_cmpge_ps(_mm_loadu_ps(&maxX[index]), areaMinXs));
+        const __m128 overlapY = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&minY[index]), areaMaxYs),
+                                           _mm_cmpge_ps(_mm_loadu_ps(&maxY[index]), areaMinYs));
+        const auto bits = static_cast<uint64_t>(_mm_movemask_ps(_mm_and_ps(overlapX, overlapY)));
+        // Groups of 4 never straddle a 64 bit word
+        mask[index / 64] |= bits << (index % 64);
+    }
+#endif
+    for (; index < count; index++) {
+        const bool overlaps = minX[index] <= areaMaxX && maxX[index] >= area.x
+            && minY[index] <= areaMaxY && maxY[index] >= area.y;
+        mask[index / 64] |= static_cast<uint64_t>(overlaps) << (index % 64);
+    }
+}
+
+void getIntersectionMask(const std::span<const Rectangle2F> rectangles, const Rectangle2F& area,
+                         const std::span<uint64_t> mask) {
+    const size_t count = rectangles.size();
+    clearMask(count, mask);
+    // An empty area intersects nothing
+    if (!(area.w > 0.f) || !(area.h > 0.f)) {
+        return;
+    }
+
+    size_t index = 0;
+#if defined(VECTOR_BATCH_AVX2) || defined(VECTOR_BATCH_SSE2)
+    // Each rectangle fills one 4 float register, so 4 rectangles are transposed into registers of their x, y, w and h.
+    // AVX2 builds use the same 4 wide loop, as transposing 8 rectangles costs more than it saves.
+    static_assert(sizeof(Rectangle2F) == 4 * sizeof(float));
+    const size_t vectorCount = count - count % 4;
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 areaMinX = _mm_set1_ps(area.x);
+    const __m128 areaMinY = _mm_set1_ps(area.y);
+    const __m128 areaMaxX = _mm_set1_ps(area.x + area.w);
+    const __m128 areaMaxY = _mm_set1_ps(area.y + area.h);
+    for (; index < vectorCount; index += 4) {
+        __m128 x = _mm_loadu_ps(&rectangles[index].x);
+        __m128 y = _mm_loadu_ps(&rectangles[index + 1].x);
+        __m128 w = _mm_loadu_ps(&rectangles[index + 2].x);
+        __m128 h = _mm_loadu_ps(&rectangles[index + 3].x);
+        _MM_TRANSPOSE4_PS(x, y, w, h);
+        const __m128 notEmpty = _mm_and_ps(_mm_cmpgt_ps(w, zero), _mm_cmpgt_ps(h, zero));
+        const __m128 overlapX = _mm_and_ps(_mm_cmplt_ps(x, areaMaxX), _mm_cmplt_ps(areaMinX, _mm_add_ps(x, w)));
+        const __m128 overlapY = _mm_and_ps(_mm_cmplt_ps(y, areaMaxY), _mm_cmplt_ps(areaMinY, _mm_add_ps(y, h)));
+        const auto bits = static_cast<uint64_t>(_mm_movemask_ps(_mm_and_ps(notEmpty, _mm_and_ps(overlapX, overlapY))));
+        mask[index / 64] |= bits << (index % 64);
+    }
+#endif
+    for (; index < count; index++) {
+        mask[index / 64] |= static_cast<uint64_t>(rectangles[index].intersects(area)) << (index % 64);
+    }
+}
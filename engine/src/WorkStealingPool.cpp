@@ -0,0 +1,245 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+// Index of the worker running on this thread in the pool it belongs to, so tasks submitted by tasks stay local
+thread_local const WorkStealingPool* currentPool = nullptr;
+thread_local size_t currentWorker = 0;
+}
+
+WorkStealingPool::WorkStealingPool(const size_t workerCount, const bool pinThreads) {
+    // The calling thread steals from the queues while waiting, so a pool without workers still has one queue
+    const size_t queueCount = std::max<size_t>(workerCount, 1);
+    queues_.reserve(queueCount);
+    for (size_t index = 0; index < queueCount; index++) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+
+    workers_.reserve(workerCount);
+    for (size_t index = 0; index < workerCount; index++) {
+        workers_.emplace_back(&WorkStealingPool::runWorker, this, index);
+        if (pinThreads) {
+            pinToCore(workers_.back(), index + 1);
+        }
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    try {
+        wait();
+    } catch (...) {
+        // Exceptions not collected by a call to wait() are discarded
+    }
+    {
+        std::lock_guard lock(sleepMutex_);
+        stopping_ = true;
+    }
+    workAvailable_.notify_all();
+    for (std::thread& worker: workers_) {
+        worker.join();
+    }
+}
+
+void WorkStealingPool::submit(Task task, const void* group) {
+    const size_t index = currentPool == this
+        ? currentWorker
+        : nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    pendingCount_.fetch_add(1);
+    {
+        std::lock_guard lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back({std::move(task), group});
+        queuedCount_.fetch_add(1);
+    }
+    {
+        // Taking the lock orders the new task before any worker's check for work, so none sleep through it
+        std::lock_guard lock(sleepMutex_);
+    }
+    workAvailable_.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    Task task;
+    while (pendingCount_.load() > 0) {
+        if (trySteal(queues_.size(), task)) {
+            run(task);
+            continue;
+        }
+        std::unique_lock lock(sleepMutex_);
+        allFinished_.wait(lock, [this] { return pendingCount_.load() == 0 || queuedCount_.load() > 0; });
+    }
+
+    std::lock_guard lock(exceptionMutex_);
+    if (exception_) {
+        std::rethrow_exception(std::exchange(exception_, nullptr));
+    }
+}
+
+void WorkStealingPool::runParallelFor(const size_t count, const size_t grainSize, void* body,
+                                      const ChunkFunction function) {
+    if (count == 0) {
+        return;
+    }
+    const size_t chunkSize = std::max<size_t>(grainSize, 1);
+    const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+    ParallelFor parallelFor{body, function, count, chunkSize, chunkCount, {}, nullptr};
+    for (size_t chunk = 1; chunk < chunkCount; chunk++) {
+        submit([&parallelFor, chunk] { parallelFor.runChunk(chunk); }, &parallelFor);
+    }
+    parallelFor.runChunk(0);
+    waitFor(parallelFor.remainingChunks, &parallelFor);
+
+    if (parallelFor.exception) {
+        std::rethrow_exception(parallelFor.exception);
+    }
+}
+
+void WorkStealingPool::waitFor(const std::atomic<size_t>& counter, const void* group) {
+    // Rather than sleeping until the counter reaches 0 the calling thread helps with the group's queued tasks
+    Task task;
+    while (counter.load() > 0) {
+        if (tryTakeFromGroup(group, task)) {
+            run(task);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void WorkStealingPool::ParallelFor::runChunk(const size_t chunk) {
+    const size_t begin = chunk * grainSize;
+    try {
+        function(body, begin, std::min(begin + grainSize, count));
+    } catch (...) {
+        std::lock_guard lock(exceptionMutex);
+        if (!exception) {
+            exception = std::current_exception();
+        }
+    }
+    remainingChunks.fetch_sub(1);
+}
+
+size_t WorkStealingPool::getDefaultWorkerCount() {
+    const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+void WorkStealingPool::runWorker(const size_t index) {
+    currentPool = this;
+    currentWorker = index;
+    Task task;
+    while (true) {
+        if (tryPop(index, task) || trySteal(index, task)) {
+            run(task);
+            continue;
+        }
+        std::unique_lock lock(sleepMutex_);
+        workAvailable_.wait(lock, [this] { return stopping_ || queuedCount_.load() > 0; });
+        if (stopping_ && queuedCount_.load() == 0) {
+            return;
+        }
+    }
+}
+
+bool WorkStealingPool::tryPop(const size_t index, Task& task) {
+    Queue& queue = *queues_[index];
+    std::lock_guard lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back().task);
+    queue.tasks.pop_back();
+    queuedCount_.fetch_sub(1);
+    return true;
+}
+
+bool WorkStealingPool::trySteal(const size_t thief, Task& task) {
+    // Start with the next worker's queue so thieves spread out rather than all stealing from the first queue
+    for (size_t offset = 1; offset <= queues_.size(); offset++) {
+        Queue& queue = *queues_[(thief + offset) % queues_.size()];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front().task);
+            queue.tasks.pop_front();
+            queuedCount_.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingPool::tryTakeFromGroup(const void* group, Task& task) {
+    // Workers look in their own queue first, where the tasks they submitted are, newest first as in tryPop()
+    const size_t first = currentPool == this ? currentWorker : 0;
+    for (size_t offset = 0; offset < queues_.size(); offset++) {
+        const size_t index = (first + offset) % queues_.size();
+        const bool ownQueue = currentPool == this && index == currentWorker;
+        std::deque<QueuedTask>& tasks = queues_[index]->tasks;
+        std::lock_guard lock(queues_[index]->mutex);
+        size_t found = tasks.size();
+        for (size_t position = 0; position < tasks.size(); position++) {
+            const size_t candidate = ownQueue ? tasks.size() - 1 - position : position;
+            if (tasks[candidate].group == group) {
+                found = candidate;
+                break;
+            }
+        }
+        if (found == tasks.size()) {
+            continue;
+        }
+        task = std::move(tasks[found].task);
+        tasks.erase(tasks.begin() + static_cast<std::ptrdiff_t>(found));
+        queuedCount_.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::run(Task& task) {
+    try {
+        task();
+    } catch (...) {
+        std::lock_guard lock(exceptionMutex_);
+        if (!exception_) {
+            exception_ = std::current_exception();
+        }
+    }
+    task = nullptr;
+    if (pendingCount_.fetch_sub(1) == 1) {
+        std::lock_guard lock(sleepMutex_);
+        allFinished_.notify_all();
+    }
+}
+
+void WorkStealingPool::pinToCore(std::thread& thread, const size_t core) {
+    const unsigned int coreCount = std::max(std::thread::hardware_concurrency(), 1u);
+#if defined(_WIN32)
+    SetThreadAffinityMask(thread.native_handle(), DWORD_PTR{1} << (core % coreCount));
+#elif defined(__linux__)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(core % coreCount, &cpuSet);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuSet);
+#else
+    (void)thread;
+    (void)core;
+    (void)coreCount;
+#endif
+}
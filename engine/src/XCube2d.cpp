@@ -37,9 +37,14 @@ XCube2Engine::XCube2Engine()
         #endif
     #endif
 
-    networkEngine = std::make_shared<NetworkEngine>(std::make_unique<TcpNetworkProtocol>());
+    roomManager = std::make_shared<RoomManager>(std::make_unique<TcpNetworkProtocol>());
+    Room& defaultRoom = roomManager->createRoom();
+    roomManager->setDefaultRoom(defaultRoom.getId());
+    // Rooms tick in parallel on a worker thread per remaining core
+    roomManager->setWorkerCount(WorkStealingPool::getDefaultWorkerCount(), true);
+    networkEngine = std::shared_ptr<NetworkEngine>(roomManager, &defaultRoom.getNetworkEngine());
 #ifdef __DEBUG
-    debug("NetworkEngine() successful");
+    debug("RoomManager() successful");
 #endif
 
 #ifdef __DEBUG
@@ -61,6 +66,7 @@ XCube2Engine::~XCube2Engine()
 #endif
 
     networkEngine.reset();
+    roomManager.reset();
 #ifdef __DEBUG
     graphicsEngine.reset();
     eventEngine.reset();
@@ -0,0 +1,126 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>
+#include <msgpack.hpp>
+#include <thread>
+
+#include "LoopbackNetworkProtocol.h"
+#include "NetworkEngine.h"
+#include "Replicated.h"
+#include "utils/AllocationTracker.h"
+
+namespace {
+class MovingObject final : public Replicated<MovingObject> {
+public:
+    MovingObject(NetworkEngine& networkEngine, const Vector2F position)
+        : Replicated(networkEngine)
+        , position(position) {
+    }
+
+    [[nodiscard]] std::optional<Vector2F> getReplicationPosition() const override { return position; }
+
+    static constexpr TypeId typeId{"MovingObject"};
+    MSGPACK_DEFINE(position.x, position.y);
+
+    Vector2F position;
+};
+
+struct NudgeCommand {
+    static constexpr TypeId typeId{"NudgeCommand"};
+    float dx{};
+    MSGPACK_DEFINE(dx);
+};
+
+MessageBuffer packNudge(const CommandSequence sequence, const float dx) {
+    msgpack::sbuffer buffer;
+    msgpack::packer packer(buffer);
+    packer.pack_array(3);
+    packer.pack(NudgeCommand::typeId);
+    packer.pack(sequence);
+    packer.pack(NudgeCommand{dx});
+    return std::vector<uint8_t>(buffer.data(), buffer.data() + buffer.size());
+}
+}
+
+TEST(AllocationTrackerTest, ScopeCountsAllocationsOfTheCallingThread) {
+    if (!AllocationTracker::isEnabled()) {
+        GTEST_SKIP() << "The allocation hook is not linked";
+    }
+
+    std::vector<uint32_t> values;
+    const AllocationScope scope;
+    values.reserve(100);
+    ASSERT_EQ(scope.getCounts(), (AllocationCounts{1, 100 * sizeof(uint32_t)}));
+
+    std::vector<uint32_t> otherThreadValues;
+    AllocationCounts otherThreadCounts;
+    std::thread([&] {
+        const AllocationScope threadScope;
+        otherThreadValues.reserve(50);
+        otherThreadCounts = threadScope.getCounts();
+    }).join();
+    ASSERT_EQ(otherThreadCounts, (AllocationCounts{1, 50 * sizeof(uint32_t)}));
+}
+
+TEST(AllocationTrackerTest, SteadyStateNetworkUpdateDoesNotAllocateOnTheCallingThread) {
+    if (!AllocationTracker::isEnabled()) {
+        GTEST_SKIP() << "The allocation hook is not linked";
+    }
+
+    // Only the calling thread's allocations are counted. The loopback protocol has no threads of its own and the
+    // engine has no snapshot pool or pipelined replication, so here that is every allocation the update makes, but
+    // the allocations of protocol and worker threads in other setups are not checked
+
+    auto protocol = std::make_unique<LoopbackNetworkProtocol>();
+    LoopbackNetworkProtocol& loopback = *protocol;
+    NetworkEngine networkEngine(std::move(protocol));
+    networkEngine.setInterestCellSize(64.f);
+
+    std::vector<std::unique_ptr<MovingObject>> objects;
+    for (int i = 0; i < 32; i++) {
+        objects.push_back(std::make_unique<MovingObject>(networkEngine, Vector2F(i * 16.f, 0.f)));
+    }
+    networkEngine.registerClientCommand<NudgeCommand>([&](const ClientId clientId, const NudgeCommand& command) {
+        objects[clientId]->position.x += command.dx;
+    });
+
+    const ClientId viewer = loopback.connectClient();
+    const ClientId watcher = loopback.connectClient();
+    loopback.advanceTime(0.0);
+    networkEngine.update(0.016f);
+    networkEngine.setPlayerView(viewer, {0.f, -64.f, 256.f, 128.f});
+    networkEngine.setPlayerBandwidth(viewer, 8000);
+
+    size_t tickAllocations = 0;
+    for (CommandSequence tick = 1; tick <= 60; tick++) {
+        // Objects move back and forth between cells, in and out of the viewer's view
+        const float dx = tick % 2 == 0 ? 80.f : -80.f;
+        loopback.clientSend(viewer, packNudge(tick, dx));
+        loopback.clientSend(watcher, packNudge(tick, -dx));
+        loopback.advanceTime(0.016);
+        for (auto& object: objects) {
+            object->position.y = tick % 2 == 0 ? 70.f : 0.f;
+        }
+
+        const AllocationScope scope;
+        networkEngine.applyClientCommands();
+        networkEngine.update(0.016f);
+        loopback.advanceTime(0.0);
+        const AllocationCounts counts = scope.getCounts();
+
+        while (loopback.clientRecieve(viewer)) {}
+        while (loopback.clientRecieve(watcher)) {}
+
+        // The first ticks grow this thread's buffers, queues and grid cells to the size the rest reuse
+        if (tick > 10) {
+            tickAllocations += counts.allocations;
+        }
+    }
+
+    ASSERT_EQ(tickAllocations, 0);
+}
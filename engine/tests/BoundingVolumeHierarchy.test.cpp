@@ -0,0 +1,93 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "BoundingVolumeHierarchy.h"
+
+namespace {
+    std::vector<Rectangle2F> createWalls(const size_t count) {
+        std::mt19937 random(3);
+        std::uniform_real_distribution position(0.f, 500.f);
+        std::uniform_real_distribution size(-1.f, 30.f);
+        std::vector<Rectangle2F> walls(count);
+        for (Rectangle2F& wall: walls) {
+            wall = {position(random), position(random), size(random), size(random)};
+        }
+        return walls;
+    }
+
+    template<typename Query>
+    std::vector<uint32_t> getSorted(Query&& query) {
+        std::vector<uint32_t> found;
+        query([&](const uint32_t index) { found.push_back(index); });
+        std::ranges::sort(found);
+        return found;
+    }
+}
+
+TEST(BoundingVolumeHierarchyTest, QueriesFindTheSameRectanglesAsALinearScan) {
+    const std::vector<Rectangle2F> walls = createWalls(1000);
+    const BoundingVolumeHierarchy hierarchy(walls);
+    EXPECT_EQ(hierarchy.size(), walls.size());
+
+    std::mt19937 random(5);
+    std::uniform_real_distribution position(-20.f, 520.f);
+    std::uniform_real_distribution size(0.f, 60.f);
+    for (int query = 0; query < 200; query++) {
+        const Rectangle2F area(position(random), position(random), size(random), size(random));
+        const Vector2F point(position(random), position(random));
+        // Every third line is axis aligned, to cover segments parallel to the node edges
+        Line2f line({position(random), position(random)}, {position(random), position(random)});
+        if (query % 3 == 0) line.end.y = line.start.y;
+
+        std::vector<uint32_t> inArea, atPoint, onLine;
+        for (uint32_t index = 0; index < walls.size(); index++) {
+            if (walls[index].intersects(area)) inArea.push_back(index);
+            if (walls[index].contains(point)) atPoint.push_back(index);
+            if (walls[index].intersects(line)) onLine.push_back(index);
+        }
+
+        EXPECT_EQ(getSorted([&](auto&& visitor) { hierarchy.query(area, visitor); }), inArea);
+        EXPECT_EQ(getSorted([&](auto&& visitor) { hierarchy.queryPoint(point, visitor); }), atPoint);
+        EXPECT_EQ(getSorted([&](auto&& visitor) { hierarchy.queryLine(line, visitor); }), onLine);
+        EXPECT_EQ(hierarchy.intersectsAny(line), !onLine.empty());
+    }
+}
+
+TEST(BoundingVolumeHierarchyTest, LineIntersectionMaskMatchesIntersectsAny) {
+    const std::vector<Rectangle2F> walls = createWalls(300);
+    const BoundingVolumeHierarchy hierarchy(walls);
+
+    // Lines of sight from one point, as checked from a player to everyone around them
+    std::mt19937 random(9);
+    std::uniform_real_distribution position(0.f, 500.f);
+    std::vector<Line2f> lines(150);
+    for (Line2f& line: lines) {
+        line = {{250.f, 250.f}, {position(random), position(random)}};
+    }
+    std::vector<uint64_t> mask(3, ~uint64_t{0});
+    hierarchy.getLineIntersectionMask(lines, mask);
+
+    size_t blocked = 0;
+    for (size_t index = 0; index < lines.size(); index++) {
+        const bool expected = hierarchy.intersectsAny(lines[index]);
+        EXPECT_EQ((mask[index / 64] >> (index % 64)) & 1, expected) << "Line " << index;
+        blocked += expected;
+    }
+    EXPECT_GT(blocked, 0);
+    EXPECT_LT(blocked, lines.size());
+    EXPECT_THROW(hierarchy.getLineIntersectionMask(lines, std::span(mask).first(2)), std::invalid_argument);
+
+    const BoundingVolumeHierarchy empty;
+    EXPECT_FALSE(empty.intersectsAny(lines[0]));
+    empty.getLineIntersectionMask(lines, mask);
+    EXPECT_EQ(mask, std::vector<uint64_t>(3, 0));
+}
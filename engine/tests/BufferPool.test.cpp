@@ -0,0 +1,68 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include <array>
+#include <gtest/gtest.h>
+#include <thread>
+
+#include "NetworkProtocol.h"
+#include "utils/AllocationTracker.h"
+#include "utils/BufferPool.h"
+
+TEST(BufferPoolTest, BlocksAreReusedWithinASizeClass) {
+    static_assert(BufferPool::getBlockSize(1) == 64);
+    static_assert(BufferPool::getBlockSize(100) == 128);
+    static_assert(BufferPool::getBlockSize(BufferPool::maxBlockSize + 1) == BufferPool::maxBlockSize + 1);
+
+    void* block = BufferPool::allocate(100);
+    BufferPool::deallocate(block, 100);
+    void* reused = BufferPool::allocate(128);
+    ASSERT_EQ(reused, block);
+    void* other = BufferPool::allocate(129);
+    ASSERT_NE(other, block);
+    BufferPool::deallocate(reused, 128);
+    BufferPool::deallocate(other, 129);
+
+    const std::array<uint8_t, 3> bytes{1, 2, 3};
+    const MessageBuffer buffer = MessageBuffer::copy(bytes);
+    ASSERT_EQ(buffer, (MessageBuffer{1, 2, 3}));
+    ASSERT_TRUE(MessageBuffer::copy({}).empty());
+}
+
+TEST(BufferPoolTest, BodiesReleasedOnAnotherThreadAreReused) {
+    if (!AllocationTracker::isEnabled()) {
+        GTEST_SKIP() << "The allocation hook is not linked";
+    }
+
+    // Bodies are received on one thread and released on another, as by a protocol's I/O thread and the game thread
+    constexpr size_t messagesPerRound = 100;
+    const std::array<uint8_t, 200> bytes{};
+    std::vector<MessageBuffer> bodies;
+    bodies.reserve(messagesPerRound);
+
+    AllocationCounts steadyState{};
+    for (int round = 0; round < 10; round++) {
+        AllocationCounts receiveCounts;
+        std::thread([&] {
+            const AllocationScope scope;
+            for (size_t i = 0; i < messagesPerRound; i++) {
+                bodies.push_back(MessageBuffer::copy(bytes));
+            }
+            receiveCounts = scope.getCounts();
+        }).join();
+
+        const AllocationScope releaseScope;
+        bodies.clear();
+        // The first rounds fill the pool with as many blocks as are in use at once
+        if (round >= 5) {
+            steadyState += receiveCounts;
+            steadyState += releaseScope.getCounts();
+        }
+    }
+
+    ASSERT_EQ(steadyState.allocations, 0);
+}
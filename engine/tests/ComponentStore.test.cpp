@@ -0,0 +1,81 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>
+#include <msgpack.hpp>
+
+#include "ComponentStore.h"
+#include "EmptyNetworkProtocol.h"
+#include "Replicated.h"
+
+namespace {
+enum AsteroidComponent { Position, Velocity, Health };
+using AsteroidStore = ComponentStore<Vector2F, Vector2F, float>;
+
+class Ship final : public Replicated<Ship> {
+public:
+    explicit Ship(NetworkEngine& networkEngine) : Replicated(networkEngine) {}
+
+    static constexpr TypeId typeId{"Ship"};
+    MSGPACK_DEFINE(health);
+
+    int health{10};
+};
+}
+
+TEST(ComponentStoreTest, DestroyKeepsComponentsDense) {
+    NetworkEngine networkEngine(std::make_unique<EmptyNetworkProtocol>());
+    AsteroidStore asteroids(networkEngine, "Asteroid");
+    const auto first = asteroids.create({0.f, 0.f}, {1.f, 0.f}, 10.f);
+    const auto second = asteroids.create({5.f, 5.f}, {0.f, 1.f}, 20.f);
+    const auto third = asteroids.create({9.f, 9.f}, {1.f, 1.f}, 30.f);
+
+    asteroids.destroy(first);
+    ASSERT_FALSE(asteroids.contains(first));
+    ASSERT_EQ(asteroids.size(), 2);
+    // The last entity is moved into the destroyed entity's place
+    ASSERT_EQ(asteroids.getEntities()[0], third);
+    ASSERT_EQ(asteroids.getComponents<Health>()[0], 30.f);
+    ASSERT_EQ(asteroids.get<Position>(second), Vector2F(5.f, 5.f));
+    ASSERT_THROW((void)asteroids.get<Health>(first), std::invalid_argument);
+
+    const auto positions = asteroids.getComponents<Position>();
+    const auto velocities = asteroids.getComponents<Velocity>();
+    for (size_t i = 0; i < asteroids.size(); i++) {
+        positions[i] += velocities[i];
+    }
+    ASSERT_EQ(asteroids.get<Position>(third), Vector2F(10.f, 10.f));
+}
+
+TEST(ComponentStoreTest, EntitiesReplicatedAlongsideObjects) {
+    NetworkEngine networkEngine(std::make_unique<EmptyNetworkProtocol>());
+    const Ship ship(networkEngine);
+    AsteroidStore asteroids(networkEngine, "Asteroid");
+    const auto asteroid = asteroids.create({1.f, 2.f}, {3.f, 4.f}, 50.f);
+    ASSERT_NE(asteroid, ship.getInstanceId());
+    ASSERT_THROW(AsteroidStore(networkEngine, "Ship"), std::runtime_error);
+
+    const std::vector<uint8_t> serialized = networkEngine.getReplicatedObjectsSerialized();
+    const msgpack::object_handle handle = msgpack::unpack(reinterpret_cast<const char*>(serialized.data()),
+                                                          serialized.size());
+    const msgpack::object& snapshot = handle.get();
+    ASSERT_EQ(snapshot.via.map.size, 2);
+    for (uint32_t i = 0; i < snapshot.via.map.size; i++) {
+        const msgpack::object& objects = snapshot.via.map.ptr[i].val;
+        ASSERT_EQ(objects.via.map.size, 1);
+        const msgpack::object& object = objects.via.map.ptr[0].val;
+        if (snapshot.via.map.ptr[i].key.as<std::string>() == "Ship") {
+            ASSERT_EQ(objects.via.map.ptr[0].key.as<InstanceId>(), ship.getInstanceId());
+            ASSERT_EQ(object.as<std::vector<int>>(), std::vector{10});
+            continue;
+        }
+        ASSERT_EQ(objects.via.map.ptr[0].key.as<InstanceId>(), asteroid);
+        ASSERT_EQ(object.via.array.size, 3);
+        ASSERT_EQ(object.via.array.ptr[1].as<Vector2F>(), Vector2F(3.f, 4.f));
+        ASSERT_EQ(object.via.array.ptr[2].as<float>(), 50.f);
+    }
+}
@@ -0,0 +1,26 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#ifndef EMPTYNETWORKPROTOCOL_H
+#define EMPTYNETWORKPROTOCOL_H
+
+#include "NetworkProtocol.h"
+
+/**
+ * Network protocol for tests that never receives a message and discards everything sent, for NetworkEngines that are
+ * only used to replicate objects.
+ */
+class EmptyNetworkProtocol final : public INetworkProtocol {
+public:
+    std::optional<Message> recieve() override { return std::nullopt; }
+
+    void send(Message) override {}
+
+    void disconnect(ClientId) override {}
+};
+
+#endif //EMPTYNETWORKPROTOCOL_H
@@ -0,0 +1,101 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include <array>
+#include <limits>
+#include <gtest/gtest.h>
+
+#include "Quantization.h"
+#include "utils/FixedPoint.h"
+
+static_assert(Fixed16(3) * Fixed16(0.5f) == Fixed16(1.5f));
+static_assert((Fixed16(-3) / Fixed16(2)).raw == -3 * Fixed16::one / 2);
+static_assert(Fixed16(2.25f).sqrt() == Fixed16(1.5f));
+
+TEST(FixedPointTest, ArithmeticIsExactAndRoundsDown) {
+    EXPECT_EQ(Fixed16(1.5f).raw, 0x18000);
+    EXPECT_EQ(Fixed16(-1.5f).raw, -0x18000);
+    EXPECT_FLOAT_EQ(Fixed16(1.25f).toFloat(), 1.25f);
+    EXPECT_EQ(Fixed16(-1.25f).toInt(), -2);
+    EXPECT_EQ(Fixed16(7) - Fixed16(10), Fixed16(-3));
+
+    // One step times a half rounds down to 0, and negative quotients round down rather than towards zero
+    EXPECT_EQ((Fixed16::fromRaw(1) * Fixed16(0.5f)).raw, 0);
+    EXPECT_EQ((Fixed16::fromRaw(-1) * Fixed16(0.5f)).raw, -1);
+    EXPECT_EQ((Fixed16::fromRaw(-1) / Fixed16(2)).raw, -1);
+    EXPECT_EQ((Fixed16(1) / Fixed16(3)).raw, Fixed16::one / 3);
+    EXPECT_THROW(Fixed16(1) / Fixed16(), std::invalid_argument);
+
+    // Overflow wraps rather than being undefined
+    EXPECT_EQ((Fixed16::fromRaw(INT32_MAX) + Fixed16::fromRaw(1)).raw, INT32_MIN);
+
+    EXPECT_EQ(Fixed16(16).sqrt(), Fixed16(4));
+    EXPECT_EQ(Fixed16(-4).sqrt(), Fixed16());
+    EXPECT_NEAR(Fixed16(1000.f).sqrt().toFloat(), 31.6227766f, 1.f / Fixed16::one);
+}
+
+TEST(FixedPointTest, FloatsOutsideTheRangeWrap) {
+    EXPECT_EQ(Fixed16(32768.f), Fixed16(-32768));
+    EXPECT_EQ(Fixed16(65537.5f), Fixed16(1.5f));
+    EXPECT_EQ(Fixed16(-1e30f), Fixed16());
+    EXPECT_EQ(Fixed16(std::numeric_limits<float>::infinity()), Fixed16());
+    EXPECT_EQ(Fixed16(std::numeric_limits<float>::quiet_NaN()), Fixed16());
+}
+
+TEST(FixedPointTest, LengthsDoNotOverflowWhenTheirSquaresDo) {
+    // 181 is the longest length whose square fits in Q16.16
+    EXPECT_EQ(Vector2Fixed16(Fixed16(200), Fixed16()).getMagnitude(), Fixed16(200));
+    EXPECT_EQ(Vector2Fixed16(Fixed16(-3000), Fixed16(4000)).getMagnitude(), Fixed16(5000));
+    EXPECT_NEAR(Vector2Fixed16(Fixed16(150), Fixed16(150)).getMagnitude().toFloat(), 212.1320344f, 1e-4f);
+    EXPECT_EQ(Vector2Fixed16(Fixed16(-100), Fixed16()).getDistanceTo({Fixed16(200), Fixed16(400)}), Fixed16(500));
+    EXPECT_EQ(Vector2Fixed16(Fixed16(), Fixed16(-20000)).getUnitVector(), Vector2Fixed16(Fixed16(), Fixed16(-1)));
+    EXPECT_EQ(Vector2Fixed16(Fixed16(300), Fixed16(400)).getUnitVector(),
+              Vector2Fixed16(Fixed16(3) / Fixed16(5), Fixed16(4) / Fixed16(5)));
+}
+
+TEST(FixedPointTest, DotAndCrossProductsWrapAtTheEdgesOfTheRange) {
+    // The sum of the products is 2^63, one past the largest int64_t, and a constant expression would reject overflow
+    constexpr Vector2Fixed16 smallest(Fixed16::fromRaw(INT32_MIN), Fixed16::fromRaw(INT32_MIN));
+    constexpr Fixed16 dot = smallest.dot(smallest);
+    EXPECT_EQ(dot.raw, 0);
+    EXPECT_EQ(smallest.dot({Fixed16::fromRaw(INT32_MIN), Fixed16::fromRaw(INT32_MAX)}), Fixed16(0.5f));
+
+    // 2^63 - 2^31 fits, and wraps once rounded to Q16.16
+    constexpr Fixed16 cross = smallest.cross({Fixed16::fromRaw(INT32_MAX), Fixed16::fromRaw(INT32_MIN)});
+    EXPECT_EQ(cross, Fixed16(-0.5f));
+}
+
+TEST(FixedPointTest, VectorsAndRectanglesMatchTheirFloatCounterparts) {
+    const Vector2Fixed16 a(Vector2F(3.f, 4.f));
+    const Vector2Fixed16 b(Fixed16(-1), Fixed16(2.5f));
+    EXPECT_EQ(a.getMagnitude(), Fixed16(5));
+    EXPECT_EQ(a.dot(b), Fixed16(7));
+    EXPECT_EQ(a.cross(b), Fixed16(11.5f));
+    EXPECT_EQ(a + b, Vector2Fixed16(Fixed16(2), Fixed16(6.5f)));
+    EXPECT_EQ(a * Fixed16(2), Vector2Fixed16(Fixed16(6), Fixed16(8)));
+    EXPECT_EQ(-a, Vector2Fixed16(Vector2F(-3.f, -4.f)));
+    EXPECT_EQ(a.getDistanceSquaredTo(b), Fixed16(18.25f));
+    EXPECT_EQ(a.getUnitVector(), Vector2Fixed16(Fixed16(3) / Fixed16(5), Fixed16(4) / Fixed16(5)));
+    EXPECT_NEAR(static_cast<Vector2F>(a.getUnitVector()).x, 0.6f, 1.f / Fixed16::one);
+
+    const Rectangle2Fixed16 rectangle(Rectangle2F(0.f, 0.f, 10.f, 10.f));
+    EXPECT_TRUE(rectangle.contains(a));
+    EXPECT_FALSE(rectangle.contains(b));
+    EXPECT_TRUE(rectangle.intersects(rectangle + a));
+    EXPECT_FALSE(rectangle.intersects(rectangle + Vector2Fixed16(Fixed16(10), Fixed16())));
+
+    // Fixed point values are sent over the network without losing any precision
+    std::array<uint8_t, 16> buffer{};
+    const QuantizedVector2Fixed codec(QuantizedFixed(Fixed16(-1024), Fixed16(1024)));
+    EXPECT_EQ(codec.getBits(), 2 * 28);
+    BitWriter writer(buffer);
+    codec.write(writer, b);
+    BitReader reader{std::span<const uint8_t>(buffer).first(writer.getByteCount())};
+    Vector2Fixed16 received;
+    codec.read(reader, received);
+    EXPECT_EQ(received, b);
+}
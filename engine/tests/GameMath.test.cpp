@@ -0,0 +1,68 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "utils/GameMath.h"
+#include "utils/VectorBatch.h"
+
+static_assert(Rectangle2F(0.f, 0.f, 10.f, 10.f).intersects(Rectangle2F(5.f, 5.f, 10.f, 10.f)));
+static_assert(!Rectangle2F(0.f, 0.f, 10.f, 10.f).intersects(Rectangle2F(10.f, 0.f, 10.f, 10.f)));
+static_assert(!Rectangle2F(0.f, 0.f, 10.f, 10.f).intersects(Rectangle2F(5.f, 5.f, 0.f, 10.f)));
+static_assert(Rectangle2I(0, 0, 10, 10).intersects(Line2i({-5, 5}, {15, 5})));
+
+TEST(GameMathTest, RectanglesIntersectWhenTheyShareArea) {
+    std::mt19937 random(11);
+    std::uniform_real_distribution position(0.f, 100.f);
+    std::uniform_real_distribution size(-2.f, 20.f);
+    const Rectangle2F area(40.f, 30.f, 20.f, 25.f);
+
+    std::vector<Rectangle2F> rectangles(133);
+    for (Rectangle2F& rectangle: rectangles) {
+        rectangle = {position(random), position(random), size(random), size(random)};
+    }
+    std::vector<uint64_t> mask(3);
+    getIntersectionMask(rectangles, area, mask);
+
+    for (size_t index = 0; index < rectangles.size(); index++) {
+        const Rectangle2F& rectangle = rectangles[index];
+        const bool expected = rectangle.w > 0.f && rectangle.h > 0.f
+            && std::max(rectangle.x, area.x) < std::min(rectangle.x + rectangle.w, area.x + area.w)
+            && std::max(rectangle.y, area.y) < std::min(rectangle.y + rectangle.h, area.y + area.h);
+        EXPECT_EQ(rectangle.intersects(area), expected) << "Rectangle " << index;
+        EXPECT_EQ(area.intersects(rectangle), expected) << "Rectangle " << index;
+        EXPECT_EQ((mask[index / 64] >> (index % 64)) & 1, expected) << "Rectangle " << index;
+    }
+}
+
+TEST(GameMathTest, LinesIntersectRectanglesTheyPassThroughOrTouch) {
+    const Rectangle2F rectangle(10.f, 10.f, 20.f, 10.f);
+    // Crossing, inside, ending on an edge, along an edge, diagonal through a corner and a point inside
+    EXPECT_TRUE(rectangle.intersects(Line2f({0.f, 15.f}, {40.f, 15.f})));
+    EXPECT_TRUE(rectangle.intersects(Line2f({12.f, 12.f}, {14.f, 18.f})));
+    EXPECT_TRUE(rectangle.intersects(Line2f({20.f, 0.f}, {20.f, 10.f})));
+    EXPECT_TRUE(rectangle.intersects(Line2f({0.f, 10.f}, {40.f, 10.f})));
+    EXPECT_TRUE(rectangle.intersects(Line2f({0.f, 0.f}, {10.f, 10.f})));
+    EXPECT_TRUE(rectangle.intersects(Line2f({15.f, 15.f}, {15.f, 15.f})));
+
+    // Stopping short, parallel outside, passing a corner diagonally and a point outside
+    EXPECT_FALSE(rectangle.intersects(Line2f({0.f, 15.f}, {9.f, 15.f})));
+    EXPECT_FALSE(rectangle.intersects(Line2f({0.f, 25.f}, {40.f, 25.f})));
+    EXPECT_FALSE(rectangle.intersects(Line2f({0.f, 5.f}, {10.f, -5.f})));
+    EXPECT_FALSE(rectangle.intersects(Line2f({25.f, 0.f}, {35.f, 10.f - 1e-3f})));
+    EXPECT_FALSE(rectangle.intersects(Line2f({5.f, 5.f}, {5.f, 5.f})));
+    EXPECT_FALSE(Rectangle2F(10.f, 10.f, -5.f, 10.f).intersects(Line2f({0.f, 15.f}, {40.f, 15.f})));
+
+    // Empty rectangles are never touched, as they never share area with another rectangle
+    EXPECT_FALSE(Rectangle2F(10.f, 10.f, 0.f, 10.f).intersects(Line2f({0.f, 15.f}, {40.f, 15.f})));
+    EXPECT_FALSE(Rectangle2F(10.f, 10.f, 20.f, 0.f).intersects(Line2f({15.f, 0.f}, {15.f, 40.f})));
+    EXPECT_FALSE(Rectangle2F(10.f, 10.f, 0.f, 0.f).intersects(Line2f({10.f, 10.f}, {10.f, 10.f})));
+    EXPECT_FALSE(Rectangle2I(10, 10, 0, 10).intersects(Line2i({0, 15}, {40, 15})));
+}
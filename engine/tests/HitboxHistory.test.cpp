@@ -0,0 +1,65 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "HitboxHistory.h"
+
+namespace {
+    std::vector<InstanceId> getHits(const HitboxHistory& history, const uint64_t tick, const Line2f& line) {
+        std::vector<InstanceId> hits;
+        history.queryLine(tick, line, [&](const InstanceId entity, const Rectangle2F&) { hits.push_back(entity); });
+        std::ranges::sort(hits);
+        return hits;
+    }
+}
+
+TEST(HitboxHistoryTest, ShotsHitEntitiesWhereTheyWereAtTheShotsTick) {
+    HitboxHistory history(8);
+    // A runner crossing the shot's path between ticks 1 and 5, and a target standing in it throughout
+    for (uint64_t tick = 1; tick <= 10; tick++) {
+        history.record(tick, 7, {static_cast<float>(tick) * 10.f, 0.f, 5.f, 5.f});
+        history.record(tick, 9, {100.f, 0.f, 5.f, 5.f});
+    }
+    const Line2f shot({32.f, -10.f}, {32.f, 10.f});
+    EXPECT_EQ(getHits(history, 3, shot), std::vector<InstanceId>{7});
+    EXPECT_EQ(getHits(history, 4, shot), std::vector<InstanceId>{});
+    EXPECT_EQ(getHits(history, 10, Line2f({0.f, 2.f}, {200.f, 2.f})), (std::vector<InstanceId>{7, 9}));
+    EXPECT_EQ(history.getHitbox(6, 7)->x, 60.f);
+
+    // Only the last 8 ticks are kept
+    EXPECT_EQ(history.getOldestTick(), 3);
+    EXPECT_FALSE(history.contains(2));
+    EXPECT_FALSE(history.queryLine(2, shot, [](InstanceId, const Rectangle2F&) { FAIL(); }));
+    EXPECT_FALSE(history.contains(11));
+    EXPECT_THROW(history.record(2, 7, {}), std::invalid_argument);
+}
+
+TEST(HitboxHistoryTest, RemovedEntitiesAreNotFoundAndTheirSlotsAreReused) {
+    HitboxHistory history(4);
+    history.record(1, 1, {0.f, 0.f, 10.f, 10.f});
+    history.record(1, 2, {20.f, 0.f, 10.f, 10.f});
+    history.remove(1);
+    // Takes the removed entity's slot, but was not there at tick 1
+    history.record(2, 3, {0.f, 0.f, 10.f, 10.f});
+
+    const Line2f shot({5.f, 5.f}, {25.f, 5.f});
+    EXPECT_EQ(getHits(history, 1, shot), std::vector<InstanceId>{2});
+    EXPECT_EQ(getHits(history, 2, shot), std::vector<InstanceId>{3});
+    EXPECT_FALSE(history.getHitbox(1, 1));
+    EXPECT_FALSE(history.getHitbox(1, 3));
+    EXPECT_FALSE(history.getHitbox(2, 2));
+
+    // Skipping ticks leaves the ticks in between without a frame
+    history.record(5, 2, {20.f, 0.f, 10.f, 10.f});
+    EXPECT_FALSE(history.contains(4));
+    EXPECT_FALSE(history.contains(1));
+    EXPECT_TRUE(history.contains(2));
+    EXPECT_EQ(getHits(history, 5, shot), std::vector<InstanceId>{2});
+}
@@ -0,0 +1,46 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "JobGraph.h"
+
+TEST(JobGraphTest, JobsStartOnceTheirDependenciesHaveFinished) {
+    WorkStealingPool pool(3);
+    JobGraph graph(&pool);
+    std::vector<float> values(10000, 1.f);
+    std::atomic<int> order{0};
+    int scaledAt = -1;
+    int summedAt = -1;
+    float sum = 0.f;
+    float expectedSum = 0.f;
+    for (size_t index = 0; index < values.size(); index++) expectedSum += static_cast<float>(index % 7) * 2.f;
+
+    const auto fill = graph.addParallelFor(values.size(), 256, [&](const size_t begin, const size_t end) {
+        for (size_t index = begin; index < end; index++) values[index] = static_cast<float>(index % 7);
+    });
+    const auto scale = graph.addParallelFor(values.size(), 256, [&](const size_t begin, const size_t end) {
+        for (size_t index = begin; index < end; index++) values[index] *= 2.f;
+    }, {fill});
+    const auto marker = graph.addJob([&] { scaledAt = order++; }, {scale});
+    graph.addJob([&] {
+        summedAt = order++;
+        sum = 0.f;
+        for (const float value: values) sum += value;
+    }, {scale, marker});
+    ASSERT_THROW(graph.addJob([] {}, {42}), std::invalid_argument);
+
+    // The same graph runs every tick
+    for (int tick = 0; tick < 3; tick++) {
+        order = 0;
+        graph.run();
+        ASSERT_LT(scaledAt, summedAt);
+        ASSERT_FLOAT_EQ(sum, expectedSum);
+    }
+}
@@ -0,0 +1,133 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>
+
+#include "LoopbackNetworkProtocol.h"
+#include "NetworkEngine.h"
+
+TEST(LoopbackNetworkProtocolTest, ConnectNotifiesServer) {
+    LoopbackNetworkProtocol protocol;
+    const ClientId clientId = protocol.connectClient();
+
+    const auto message = protocol.recieve();
+    ASSERT_TRUE(message.has_value());
+    ASSERT_EQ(message->clientId, clientId);
+    ASSERT_EQ(message->type, MessageType::Connect);
+    ASSERT_FALSE(protocol.recieve().has_value());
+}
+
+TEST(LoopbackNetworkProtocolTest, LatencyDelaysDelivery) {
+    LoopbackNetworkProtocol protocol;
+    const ClientId clientId = protocol.connectClient({.latency = 0.1});
+    protocol.recieve();
+
+    protocol.clientSend(clientId, {1, 2, 3});
+    protocol.advanceTime(0.05);
+    ASSERT_FALSE(protocol.recieve().has_value());
+
+    protocol.advanceTime(0.05);
+    const auto message = protocol.recieve();
+    ASSERT_TRUE(message.has_value());
+    ASSERT_EQ(message->body, (std::vector<uint8_t>{1, 2, 3}));
+}
+
+TEST(LoopbackNetworkProtocolTest, BandwidthCapSpacesMessages) {
+    LoopbackNetworkProtocol protocol;
+    const ClientId clientId = protocol.connectClient({}, {.bandwidth = 100});
+
+    protocol.send({clientId, std::vector<uint8_t>(50)});
+    protocol.send({clientId, std::vector<uint8_t>(50)});
+
+    protocol.advanceTime(0.5);
+    ASSERT_TRUE(protocol.clientRecieve(clientId).has_value());
+    ASSERT_FALSE(protocol.clientRecieve(clientId).has_value());
+
+    protocol.advanceTime(0.5);
+    ASSERT_TRUE(protocol.clientRecieve(clientId).has_value());
+}
+
+TEST(LoopbackNetworkProtocolTest, FullLossDropsEverything) {
+    LoopbackNetworkProtocol protocol;
+    const ClientId clientId = protocol.connectClient({}, {.lossRate = 1.0});
+
+    for (int i = 0; i < 10; i++) {
+        protocol.send({clientId, {0}});
+    }
+    protocol.advanceTime(1.0);
+
+    ASSERT_FALSE(protocol.clientRecieve(clientId).has_value());
+    ASSERT_EQ(protocol.getDownstreamStatistics(clientId).messagesDropped, 10);
+}
+
+TEST(LoopbackNetworkProtocolTest, JitterNeverReordersMessages) {
+    LoopbackNetworkProtocol protocol(42);
+    const ClientId clientId = protocol.connectClient({}, {.latency = 0.05, .jitter = 0.1});
+
+    for (uint8_t i = 0; i < 100; i++) {
+        protocol.send({clientId, {i}});
+        protocol.advanceTime(0.001);
+    }
+    protocol.advanceTime(1.0);
+
+    for (uint8_t i = 0; i < 100; i++) {
+        const auto message = protocol.clientRecieve(clientId);
+        ASSERT_TRUE(message.has_value());
+        ASSERT_EQ(message->body[0], i);
+    }
+}
+
+TEST(LoopbackNetworkProtocolTest, SameSeedIsDeterministic) {
+    auto run = [](const uint32_t seed) {
+        LoopbackNetworkProtocol protocol(seed);
+        const ClientId clientId = protocol.connectClient({}, {.latency = 0.02, .jitter = 0.05, .lossRate = 0.3});
+        std::vector<double> arrivals;
+        for (uint8_t i = 0; i < 50; i++) {
+            protocol.send({clientId, {i}});
+            protocol.advanceTime(0.01);
+            while (protocol.clientRecieve(clientId)) {
+                arrivals.push_back(protocol.getTime());
+            }
+        }
+        return arrivals;
+    };
+
+    ASSERT_EQ(run(7), run(7));
+}
+
+TEST(LoopbackNetworkProtocolTest, ReplicatesToClientsThroughNetworkEngine) {
+    auto newProtocol = std::make_unique<LoopbackNetworkProtocol>();
+    LoopbackNetworkProtocol* protocol = newProtocol.get();
+    NetworkEngine networkEngine(std::move(newProtocol));
+
+    const ClientId client0 = protocol->connectClient();
+    const ClientId client1 = protocol->connectClient({}, {.latency = 0.016});
+
+    networkEngine.update();
+    protocol->advanceTime(0.0);
+    ASSERT_TRUE(protocol->clientRecieve(client0).has_value());
+    ASSERT_FALSE(protocol->clientRecieve(client1).has_value());
+
+    protocol->advanceTime(0.016);
+    ASSERT_TRUE(protocol->clientRecieve(client1).has_value());
+}
+
+TEST(LoopbackNetworkProtocolTest, DisconnectedPlayersRemovedFromNetworkEngine) {
+    auto newProtocol = std::make_unique<LoopbackNetworkProtocol>();
+    LoopbackNetworkProtocol* protocol = newProtocol.get();
+    NetworkEngine networkEngine(std::move(newProtocol));
+
+    const ClientId client0 = protocol->connectClient();
+    const ClientId client1 = protocol->connectClient();
+    networkEngine.update();
+    ASSERT_EQ(networkEngine.getPlayers().size(), 2);
+
+    protocol->disconnectClient(client0);
+    networkEngine.update();
+    ASSERT_EQ(networkEngine.getPlayers(), std::vector{client1});
+    ASSERT_EQ(protocol->getDownstreamStatistics(client1).messagesSent, 2);
+}
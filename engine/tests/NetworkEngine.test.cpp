@@ -5,24 +5,21 @@
 // You should have received a copy of the GNU General Public License along with this program.
 // If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
 
+#include <algorithm>
 #include <gtest/gtest.h>
 #include <msgpack.hpp>
 #include <queue>
 
+#include "EmptyNetworkProtocol.h"
+#include "LoopbackNetworkProtocol.h"
 #include "NetworkEngine.h"
 #include "Replicated.h"
-
-class EmptyNetworkAdaptor final : public INetworkProtocol {
-public:
-    std::optional<Message> recieve() override { return std::nullopt; }
-
-    void send(Message message) override {};
-};
+#include "WorkStealingPool.h"
 
 class NetworkSerializationTest : public testing::Test {
 protected:
     void SetUp() override {
-        networkEngine = std::make_unique<NetworkEngine>(std::make_unique<EmptyNetworkAdaptor>());
+        networkEngine = std::make_unique<NetworkEngine>(std::make_unique<EmptyNetworkProtocol>());
     }
 
     void TearDown() override {
@@ -115,6 +112,29 @@ TEST_F(NetworkSerializationTest, DestroyReplicatedObject) {
     ASSERT_EQ(networkEngine->getReplicatedObjects().size(), 0);
 }
 
+TEST_F(NetworkSerializationTest, InstanceIdsAreReusedAfterTheReuseDelay) {
+    auto testObject0 = std::make_unique<TestObject>(*networkEngine);
+    const auto testObject1 = std::make_unique<TestObject>(*networkEngine);
+    const InstanceHandle handle0 = networkEngine->getInstanceHandle(testObject0->getInstanceId());
+    ASSERT_EQ(networkEngine->findReplicatedObject(handle0), testObject0.get());
+
+    testObject0.reset();
+    ASSERT_FALSE(networkEngine->isInstanceLive(handle0));
+    ASSERT_THROW((void)networkEngine->getInstanceHandle(handle0.instanceId), std::invalid_argument);
+
+    // The ID is not reused until every player has been sent a snapshot without the destroyed object
+    const auto testObject2 = std::make_unique<TestObject>(*networkEngine);
+    ASSERT_EQ(testObject2->getInstanceId(), 3);
+
+    networkEngine->update();
+    const auto testObject3 = std::make_unique<TestObject>(*networkEngine);
+    ASSERT_EQ(testObject3->getInstanceId(), handle0.instanceId);
+    ASSERT_FALSE(networkEngine->isInstanceLive(handle0));
+    ASSERT_EQ(networkEngine->findReplicatedObject(handle0), nullptr);
+    ASSERT_EQ(networkEngine->findReplicatedObject(networkEngine->getInstanceHandle(handle0.instanceId)),
+              testObject3.get());
+}
+
 TEST_F(NetworkSerializationTest, SerializeReplicatedObjects) {
     const auto testObject = std::make_unique<TestObject>(*networkEngine);
     testObject->setTestBool(true);
@@ -144,6 +164,50 @@ TEST_F(NetworkSerializationTest, SerializeReplicatedObjects) {
     );
 }
 
+TEST_F(NetworkSerializationTest, EachTypeIsSerializedByItsBatchFunction) {
+    const auto first = std::make_unique<TestObjectInt>(*networkEngine);
+    const auto second = std::make_unique<TestObjectInt>(*networkEngine);
+    const auto flag = std::make_unique<TestObject>(*networkEngine);
+    first->setTestInt(7);
+    second->setTestInt(-3);
+    flag->setTestBool(true);
+
+    // Replicated's batch functions write the same bytes as serializing each object through its virtual methods
+    const std::vector<IReplicatable*> ints{first.get(), second.get()};
+    const std::vector<IReplicatable*> flags{flag.get()};
+    msgpack::sbuffer expected;
+    msgpack::packer packer(expected);
+    packer.pack_map(2);
+    packer.pack(TestObjectInt::typeId);
+    packReplicatableBatch(expected, ints, nullptr);
+    packer.pack(TestObject::typeId);
+    packReplicatableBatch(expected, flags, nullptr);
+    ASSERT_EQ(networkEngine->getReplicatedObjectsSerialized(),
+              std::vector<uint8_t>(expected.data(), expected.data() + expected.size()));
+
+    // Each object's instance ID is recorded along with where it was written
+    std::vector<PackedObject> packed(ints.size());
+    msgpack::sbuffer batch;
+    TestObjectInt::packBatch(batch, ints, packed.data());
+    for (size_t index = 0; index < ints.size(); index++) {
+        ASSERT_EQ(packed[index].instanceId, ints[index]->getInstanceId());
+        ASSERT_FALSE(packed[index].position.has_value());
+        ASSERT_EQ(packed[index].priority, 1.f);
+        const msgpack::object_handle instanceId = msgpack::unpack(batch.data() + packed[index].offset,
+                                                                  batch.size() - packed[index].offset);
+        ASSERT_EQ(instanceId->as<InstanceId>(), ints[index]->getInstanceId());
+    }
+
+    // Every object of a type must be serialized by the same function
+    networkEngine->unregisterReplicatedObject(second.get());
+    try {
+        networkEngine->registerReplicatedObject(second.get(), packReplicatableBatch);
+        FAIL() << "Registering with a different serializer did not throw";
+    } catch (const std::runtime_error& error) {
+        ASSERT_STREQ(error.what(), "Object registered with a different serializer to other objects of its type");
+    }
+}
+
 class MockNetworkAdaptor final : public INetworkProtocol {
 public:
     std::optional<Message> recieve() override {
@@ -159,11 +223,16 @@ public:
         sentMessages.push_back(message);
     }
 
+    void disconnect(const ClientId clientId) override {
+        disconnectedClients.push_back(clientId);
+    }
+
     void queueMessage(const Message& response) {
         messageQueue_.push(response);
     }
 
     std::vector<Message> sentMessages;
+    std::vector<ClientId> disconnectedClients;
 private:
     std::queue<Message> messageQueue_;
 };
@@ -194,3 +263,408 @@ TEST_F(NetworkRecieveTest, MessageFromNewClient) {
     networkEngine->update();
     ASSERT_EQ(networkAdaptorMock->sentMessages.size(), 2);
 }
+
+struct MoveCommand {
+    static constexpr TypeId typeId{"MoveCommand"};
+    int dx{};
+    int dy{};
+    MSGPACK_DEFINE(dx, dy);
+};
+
+struct FireCommand : MoveCommand {
+    static constexpr TypeId typeId{"FireCommand"};
+};
+
+std::vector<uint8_t> packCommand(const TypeId typeId, const CommandSequence sequence, const MoveCommand& command) {
+    msgpack::sbuffer buffer;
+    msgpack::packer packer(buffer);
+    packer.pack_array(3);
+    packer.pack(typeId);
+    packer.pack(sequence);
+    packer.pack(command);
+    return {buffer.data(), buffer.data() + buffer.size()};
+}
+
+TEST_F(NetworkRecieveTest, ClientCommandsAppliedInOrder) {
+    std::vector<std::pair<ClientId, int>> applied;
+    networkEngine->registerClientCommand<MoveCommand>([&](const ClientId clientId, const MoveCommand& command) {
+        applied.emplace_back(clientId, command.dx);
+    });
+
+    networkAdaptorMock->queueMessage({0, {}});
+    auto body = packCommand(MoveCommand::typeId, 1, {1, 0});
+    const auto second = packCommand(MoveCommand::typeId, 2, {2, 0});
+    body.insert(body.end(), second.begin(), second.end());
+    networkAdaptorMock->queueMessage({0, body});
+    networkAdaptorMock->queueMessage({0, packCommand(MoveCommand::typeId, 3, {3, 0})});
+    networkEngine->update();
+
+    ASSERT_TRUE(applied.empty());
+    networkEngine->applyClientCommands();
+    ASSERT_EQ(applied, (std::vector<std::pair<ClientId, int>>{{0, 1}, {0, 2}, {0, 3}}));
+
+    applied.clear();
+    networkEngine->applyClientCommands();
+    ASSERT_TRUE(applied.empty());
+}
+
+TEST_F(NetworkRecieveTest, ClientCommandsOfDifferentTypesAppliedInOrder) {
+    std::vector<std::pair<std::string_view, int>> applied;
+    networkEngine->registerClientCommand<MoveCommand>([&](ClientId, const MoveCommand& command) {
+        applied.emplace_back("move", command.dx);
+    });
+    networkEngine->registerClientCommand<FireCommand>([&](ClientId, const FireCommand& command) {
+        applied.emplace_back("fire", command.dx);
+    });
+
+    // The fire command is registered last but received between the moves
+    networkAdaptorMock->queueMessage({0, {}});
+    auto body = packCommand(MoveCommand::typeId, 1, {1, 0});
+    const auto fire = packCommand(FireCommand::typeId, 1, {2, 0});
+    body.insert(body.end(), fire.begin(), fire.end());
+    networkAdaptorMock->queueMessage({0, body});
+    networkAdaptorMock->queueMessage({0, packCommand(MoveCommand::typeId, 2, {3, 0})});
+    networkEngine->update();
+    networkEngine->applyClientCommands();
+
+    ASSERT_EQ(applied, (std::vector<std::pair<std::string_view, int>>{{"move", 1}, {"fire", 2}, {"move", 3}}));
+}
+
+TEST_F(NetworkRecieveTest, StaleAndMalformedClientCommandsDiscarded) {
+    std::vector<int> applied;
+    networkEngine->registerClientCommand<MoveCommand>([&](ClientId, const MoveCommand& command) {
+        applied.push_back(command.dx);
+    }, 2);
+
+    networkAdaptorMock->queueMessage({0, {}});
+    networkAdaptorMock->queueMessage({0, packCommand(MoveCommand::typeId, 5, {5, 0})});
+    networkAdaptorMock->queueMessage({0, packCommand(MoveCommand::typeId, 4, {4, 0})});
+    networkAdaptorMock->queueMessage({0, packCommand("UnknownCommand", 6, {6, 0})});
+    networkAdaptorMock->queueMessage({0, {0xc1, 0x00}});
+    networkAdaptorMock->queueMessage({0, packCommand(MoveCommand::typeId, 7, {7, 0})});
+    networkAdaptorMock->queueMessage({0, packCommand(MoveCommand::typeId, 8, {8, 0})});
+    networkEngine->update();
+    networkEngine->applyClientCommands();
+
+    // Sequence 4 is stale and 8 exceeds the queue capacity of 2
+    ASSERT_EQ(applied, (std::vector<int>{5, 7}));
+}
+
+TEST_F(NetworkRecieveTest, DisconnectEventRemovesPlayer) {
+    std::vector<ClientId> disconnected;
+    networkEngine->setPlayerDisconnectedHandler([&](const ClientId clientId) { disconnected.push_back(clientId); });
+
+    networkAdaptorMock->queueMessage({0, {}, MessageType::Connect});
+    networkAdaptorMock->queueMessage({1, {}, MessageType::Connect});
+    networkAdaptorMock->queueMessage({2, {}, MessageType::Connect});
+    networkEngine->update();
+    ASSERT_EQ(networkEngine->getPlayers().size(), 3);
+
+    networkAdaptorMock->queueMessage({0, {}, MessageType::Disconnect});
+    networkEngine->update();
+    ASSERT_FALSE(networkEngine->hasPlayer(0));
+    ASSERT_TRUE(networkEngine->hasPlayer(1));
+    ASSERT_TRUE(networkEngine->hasPlayer(2));
+    ASSERT_EQ(disconnected, std::vector<ClientId>{0});
+
+    networkAdaptorMock->sentMessages.clear();
+    networkEngine->update();
+    ASSERT_EQ(networkAdaptorMock->sentMessages.size(), 2);
+    for (const auto& message: networkAdaptorMock->sentMessages) {
+        ASSERT_NE(message.clientId, 0);
+    }
+}
+
+TEST(NetworkEngineLoopbackTest, KickedPlayerIsNotRejoinedByDataSentBeforeTheKick) {
+    auto newProtocol = std::make_unique<LoopbackNetworkProtocol>();
+    LoopbackNetworkProtocol& protocol = *newProtocol;
+    NetworkEngine networkEngine(std::move(newProtocol));
+
+    const ClientId clientId = protocol.connectClient();
+    protocol.advanceTime(0.0);
+    networkEngine.update();
+    ASSERT_TRUE(networkEngine.hasPlayer(clientId));
+
+    // Delivered to the server but not yet received when the player is kicked
+    protocol.clientSend(clientId, {1, 2, 3});
+    protocol.advanceTime(0.0);
+    networkEngine.disconnectPlayer(clientId);
+    ASSERT_FALSE(networkEngine.hasPlayer(clientId));
+
+    networkEngine.update();
+    ASSERT_FALSE(networkEngine.hasPlayer(clientId));
+    ASSERT_TRUE(networkEngine.getPlayers().empty());
+}
+
+TEST_F(NetworkRecieveTest, IdlePlayerTimesOut) {
+    networkEngine->setPlayerTimeout(1.f);
+    networkAdaptorMock->queueMessage({0, {}, MessageType::Connect});
+    networkAdaptorMock->queueMessage({1, {}, MessageType::Connect});
+    networkEngine->update(0.f);
+
+    networkEngine->update(0.6f);
+    networkAdaptorMock->queueMessage({1, {0x90}});
+    networkEngine->update(0.6f);
+
+    ASSERT_FALSE(networkEngine->hasPlayer(0));
+    ASSERT_TRUE(networkEngine->hasPlayer(1));
+    ASSERT_EQ(networkAdaptorMock->disconnectedClients, std::vector<ClientId>{0});
+}
+
+class PositionedObject final : public Replicated<PositionedObject> {
+public:
+    PositionedObject(NetworkEngine &networkEngine, const Vector2F position)
+        : Replicated(networkEngine)
+        , position(position) {
+    }
+
+    [[nodiscard]] std::optional<Vector2F> getReplicationPosition() const override { return position; }
+
+    static constexpr TypeId typeId{"PositionedObject"};
+    MSGPACK_DEFINE(position.x, position.y);
+
+    Vector2F position;
+};
+
+std::vector<InstanceId> getSnapshotInstanceIds(const MessageBuffer& snapshot, std::vector<InstanceId>& left) {
+    const msgpack::object_handle handle = msgpack::unpack(reinterpret_cast<const char*>(snapshot.data()), snapshot.size());
+    const msgpack::object& root = handle.get();
+    std::vector<InstanceId> instanceIds;
+    for (uint32_t i = 0; i < root.via.array.ptr[0].via.map.size; i++) {
+        const msgpack::object& objects = root.via.array.ptr[0].via.map.ptr[i].val;
+        for (uint32_t j = 0; j < objects.via.map.size; j++) {
+            instanceIds.push_back(objects.via.map.ptr[j].key.as<InstanceId>());
+        }
+    }
+    std::ranges::sort(instanceIds);
+    root.via.array.ptr[1].convert(left);
+    return instanceIds;
+}
+
+TEST(SpatialHashGridTest, QueryFindsItemsInIntersectingCells) {
+    SpatialHashGrid<int> grid(10.f);
+    grid.update(1, {5.f, 5.f});
+    grid.update(2, {-5.f, 5.f});
+    grid.update(3, {55.f, 55.f});
+
+    std::vector<int> found;
+    grid.query({0.f, 0.f, 9.f, 9.f}, [&](const int item) { found.push_back(item); });
+    ASSERT_EQ(found, std::vector{1});
+
+    grid.update(1, {56.f, 56.f});
+    grid.remove(3);
+    found.clear();
+    grid.query({50.f, 50.f, 1000.f, 1000.f}, [&](const int item) { found.push_back(item); });
+    ASSERT_EQ(found, std::vector{1});
+    ASSERT_EQ(grid.size(), 2);
+}
+
+TEST(SpatialHashGridTest, EmptyCellsAreKeptForReuseUntilTheyOutnumberOccupiedCells) {
+    SpatialHashGrid<int> grid(10.f);
+    // Moving between the same cells reuses them
+    for (int step = 0; step < 100; step++) {
+        grid.update(1, {static_cast<float>(step % 2) * 10.f, 0.f});
+    }
+    ASSERT_EQ(grid.getCellCount(), 2);
+
+    // Roaming across the world frees the cells left behind
+    for (int step = 0; step < 1000; step++) {
+        grid.update(1, {static_cast<float>(step) * 10.f, 0.f});
+        grid.update(2, {0.f, static_cast<float>(step) * 10.f});
+    }
+    ASSERT_LE(grid.getCellCount(), SpatialHashGrid<int>::minPrunedEmptyCells + 3);
+
+    std::vector<int> found;
+    grid.query({9990.f, 0.f, 1.f, 1.f}, [&](const int item) { found.push_back(item); });
+    ASSERT_EQ(found, std::vector{1});
+    grid.remove(1);
+    grid.remove(2);
+    ASSERT_EQ(grid.size(), 0);
+}
+
+TEST_F(NetworkRecieveTest, PlayerViewLimitsReplicatedObjects) {
+    std::vector<std::pair<InstanceId, bool>> events;
+    networkEngine->setInterestCellSize(100.f);
+    networkEngine->setInterestHandlers(
+        [&](ClientId, const InstanceId instanceId) { events.emplace_back(instanceId, true); },
+        [&](ClientId, const InstanceId instanceId) { events.emplace_back(instanceId, false); });
+
+    const auto global = std::make_unique<TestObject>(*networkEngine);
+    const auto near = std::make_unique<PositionedObject>(*networkEngine, Vector2F{50.f, 50.f});
+    const auto far = std::make_unique<PositionedObject>(*networkEngine, Vector2F{1000.f, 1000.f});
+
+    networkAdaptorMock->queueMessage({0, {}, MessageType::Connect});
+    networkEngine->update();
+    networkEngine->setPlayerView(0, {0.f, 0.f, 100.f, 100.f});
+    networkAdaptorMock->sentMessages.clear();
+    networkEngine->update();
+
+    std::vector<InstanceId> left;
+    ASSERT_EQ(getSnapshotInstanceIds(networkAdaptorMock->sentMessages.back().body, left),
+              (std::vector{global->getInstanceId(), near->getInstanceId()}));
+    ASSERT_TRUE(left.empty());
+    ASSERT_EQ(events.size(), 2);
+
+    events.clear();
+    near->position = {1000.f, 1000.f};
+    networkEngine->update();
+    ASSERT_EQ(getSnapshotInstanceIds(networkAdaptorMock->sentMessages.back().body, left),
+              std::vector{global->getInstanceId()});
+    ASSERT_EQ(left, std::vector{near->getInstanceId()});
+    ASSERT_EQ(events, (std::vector<std::pair<InstanceId, bool>>{{near->getInstanceId(), false}}));
+
+    // Clearing the view leaves the objects in it, the player is sent the full game state instead
+    events.clear();
+    networkEngine->clearPlayerView(0);
+    networkEngine->update();
+    ASSERT_EQ(events, (std::vector<std::pair<InstanceId, bool>>{{global->getInstanceId(), false}}));
+
+    events.clear();
+    networkEngine->setPlayerView(0, {0.f, 0.f, 100.f, 100.f});
+    networkEngine->update();
+    ASSERT_EQ(events, (std::vector<std::pair<InstanceId, bool>>{{global->getInstanceId(), true}}));
+}
+
+TEST_F(NetworkRecieveTest, BandwidthDefersObjectsToLaterUpdates) {
+    std::vector<std::unique_ptr<PositionedObject>> objects;
+    for (int i = 0; i < 3; i++) {
+        objects.push_back(std::make_unique<PositionedObject>(*networkEngine, Vector2F{0.f, 0.f}));
+    }
+
+    networkAdaptorMock->queueMessage({0, {}, MessageType::Connect});
+    networkEngine->update();
+    // Each object costs 12 bytes, so only one fits in each update
+    networkEngine->setPlayerBandwidth(0, 20);
+
+    std::vector<InstanceId> sent;
+    std::vector<InstanceId> left;
+    for (int i = 0; i < 6; i++) {
+        networkEngine->update(1.f);
+        const auto instanceIds = getSnapshotInstanceIds(networkAdaptorMock->sentMessages.back().body, left);
+        ASSERT_EQ(instanceIds.size(), 1);
+        sent.push_back(instanceIds.front());
+    }
+
+    // Every object is sent before any is sent again, and they keep taking turns
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(sent[i], objects[i]->getInstanceId());
+        ASSERT_EQ(sent[i + 3], sent[i]);
+    }
+}
+
+TEST(NetworkEngineSnapshotPoolTest, SnapshotsBuiltOnAPoolMatchThoseBuiltSerially) {
+    auto serialAdaptor = std::make_unique<MockNetworkAdaptor>();
+    auto parallelAdaptor = std::make_unique<MockNetworkAdaptor>();
+    MockNetworkAdaptor& serialSent = *serialAdaptor;
+    MockNetworkAdaptor& parallelSent = *parallelAdaptor;
+    NetworkEngine serialEngine(std::move(serialAdaptor));
+    NetworkEngine parallelEngine(std::move(parallelAdaptor));
+    WorkStealingPool pool(3);
+    parallelEngine.setSnapshotPool(&pool);
+
+    std::vector<std::unique_ptr<PositionedObject>> objects;
+    for (int i = 0; i < 64; i++) {
+        const Vector2F position{static_cast<float>(i % 8) * 100.f, static_cast<float>(i / 8) * 100.f};
+        objects.push_back(std::make_unique<PositionedObject>(serialEngine, position));
+        objects.push_back(std::make_unique<PositionedObject>(parallelEngine, position));
+    }
+    for (ClientId clientId = 0; clientId < 8; clientId++) {
+        serialSent.queueMessage({clientId, {}, MessageType::Connect});
+        parallelSent.queueMessage({clientId, {}, MessageType::Connect});
+    }
+    serialEngine.update();
+    parallelEngine.update();
+    for (ClientId clientId = 0; clientId < 8; clientId++) {
+        const Rectangle2F view{static_cast<float>(clientId) * 100.f, 0.f, 250.f, 250.f};
+        serialEngine.setPlayerView(clientId, view);
+        parallelEngine.setPlayerView(clientId, view);
+        // Some players are also limited by their bandwidth
+        if (clientId % 2 == 0) {
+            serialEngine.setPlayerBandwidth(clientId, 600);
+            parallelEngine.setPlayerBandwidth(clientId, 600);
+        }
+    }
+
+    for (int update = 0; update < 3; update++) {
+        serialSent.sentMessages.clear();
+        parallelSent.sentMessages.clear();
+        serialEngine.update(0.1f);
+        parallelEngine.update(0.1f);
+        ASSERT_EQ(parallelSent.sentMessages.size(), serialSent.sentMessages.size());
+        for (size_t index = 0; index < serialSent.sentMessages.size(); index++) {
+            const Message& serial = serialSent.sentMessages[index];
+            const Message& parallel = parallelSent.sentMessages[index];
+            ASSERT_EQ(parallel.clientId, serial.clientId);
+            ASSERT_TRUE(std::ranges::equal(parallel.body, serial.body));
+        }
+        for (auto& object: objects) {
+            object->position.x += 10.f;
+        }
+    }
+}
+
+TEST_F(NetworkRecieveTest, PipelinedReplicationSendsTheStateAtTheEndOfEachUpdate) {
+    auto serialAdaptor = std::make_unique<MockNetworkAdaptor>();
+    MockNetworkAdaptor& serialSent = *serialAdaptor;
+    NetworkEngine serialEngine(std::move(serialAdaptor));
+    networkEngine->setPipelinedReplication(true);
+
+    const auto pipelinedObject = std::make_unique<PositionedObject>(*networkEngine, Vector2F{0.f, 0.f});
+    const auto serialObject = std::make_unique<PositionedObject>(serialEngine, Vector2F{0.f, 0.f});
+    networkAdaptorMock->queueMessage({0, {}, MessageType::Connect});
+    serialSent.queueMessage({0, {}, MessageType::Connect});
+    networkEngine->update();
+    networkEngine->setPlayerView(0, {-100.f, -100.f, 200.f, 200.f});
+    serialEngine.update();
+    serialEngine.setPlayerView(0, {-100.f, -100.f, 200.f, 200.f});
+
+    for (int update = 0; update < 3; update++) {
+        networkEngine->update(0.1f);
+        serialEngine.update(0.1f);
+        // Objects changing while their snapshots are sent do not change the snapshots
+        pipelinedObject->position.x += 10.f;
+        networkEngine->finishReplication();
+        serialObject->position.x += 10.f;
+
+        ASSERT_EQ(networkAdaptorMock->sentMessages.size(), serialSent.sentMessages.size());
+        ASSERT_TRUE(std::ranges::equal(networkAdaptorMock->sentMessages.back().body,
+                                       serialSent.sentMessages.back().body));
+    }
+}
+
+TEST_F(NetworkRecieveTest, MessagesHeldPastTheBufferCapAreNotOverwritten) {
+    const auto object = std::make_unique<PositionedObject>(*networkEngine, Vector2F{0.f, 0.f});
+    networkAdaptorMock->queueMessage({0, {}, MessageType::Connect});
+    networkAdaptorMock->queueMessage({1, {}, MessageType::Connect});
+    networkEngine->update();
+    // Player 0 is sent their own snapshots and player 1 the full game state
+    networkEngine->setPlayerView(0, {-100.f, -100.f, 10000.f, 10000.f});
+    networkAdaptorMock->sentMessages.clear();
+
+    // The adaptor holds every message, like a client that never keeps up
+    std::vector<std::vector<uint8_t>> sentBytes;
+    for (size_t update = 0; update < 2 * NetworkEngine::maxPooledSerializationBuffers; update++) {
+        networkEngine->update();
+        for (size_t index = sentBytes.size(); index < networkAdaptorMock->sentMessages.size(); index++) {
+            const MessageBuffer& body = networkAdaptorMock->sentMessages[index].body;
+            sentBytes.emplace_back(body.begin(), body.end());
+        }
+        object->position.x += 10.f;
+    }
+    ASSERT_EQ(sentBytes.size(), 4 * NetworkEngine::maxPooledSerializationBuffers);
+    for (size_t index = 0; index < sentBytes.size(); index++) {
+        ASSERT_TRUE(std::ranges::equal(networkAdaptorMock->sentMessages[index].body, sentBytes[index]));
+    }
+
+    // Once released, the kept buffers are reused
+    std::vector<const uint8_t*> pooledData;
+    for (size_t index = 0; index < 2 * NetworkEngine::maxPooledSerializationBuffers; index++) {
+        pooledData.push_back(networkAdaptorMock->sentMessages[index].body.data());
+    }
+    networkAdaptorMock->sentMessages.clear();
+    networkEngine->update();
+    ASSERT_EQ(networkAdaptorMock->sentMessages.size(), 2);
+    for (const Message& message: networkAdaptorMock->sentMessages) {
+        ASSERT_NE(std::ranges::find(pooledData, message.body.data()), pooledData.end());
+    }
+}
@@ -0,0 +1,124 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "PhysicsWorld.h"
+
+TEST(PhysicsWorldTest, BodiesFallAndComeToRestOnStaticBodies) {
+    PhysicsWorld world;
+    world.setGravity({0.f, 1000.f});
+    const BodyHandle ground = world.createBody({.position = {0.f, 100.f}, .halfExtents = {500.f, 10.f}, .mass = 0.f});
+    const BodyHandle ball = world.createBody({.shape = BodyShape::Circle, .position = {-50.f, 0.f}, .radius = 5.f});
+    const BodyHandle crate = world.createBody({.position = {50.f, 0.f}, .halfExtents = {5.f, 5.f}, .mass = 2.f});
+
+    bool ballTouchedGround = false;
+    for (int step = 0; step < 120; step++) {
+        world.step(1.f / 60.f);
+        for (const Contact& contact: world.getContacts()) {
+            if ((contact.first == ground && contact.second == ball)
+                || (contact.first == ball && contact.second == ground)) {
+                ballTouchedGround = true;
+            }
+        }
+    }
+
+    EXPECT_TRUE(ballTouchedGround);
+    // Resting on top of the ground, which starts at y = 90, to within the overlap the solver leaves
+    EXPECT_NEAR(world.getPosition(ball).y, 85.f, 0.5f);
+    EXPECT_NEAR(world.getPosition(crate).y, 85.f, 0.5f);
+    EXPECT_NEAR(world.getVelocity(crate).y, 0.f, 20.f);
+    EXPECT_FLOAT_EQ(world.getPosition(ground).y, 100.f);
+
+    // Static bodies stay where they are even when given a velocity
+    world.setVelocity(ground, {10.f, 10.f});
+    world.step(1.f / 60.f);
+    EXPECT_EQ(world.getPosition(ground), Vector2F(0.f, 100.f));
+
+    world.destroyBody(ball);
+    EXPECT_FALSE(world.isValid(ball));
+    EXPECT_THROW((void)world.getPosition(ball), std::invalid_argument);
+    EXPECT_EQ(world.getBodyCount(), 2);
+    EXPECT_NEAR(world.getPosition(crate).x, 50.f, 0.01f);
+}
+
+TEST(PhysicsWorldTest, QueryAreaFindsBodiesOverlappingTheArea) {
+    PhysicsWorld world;
+    const BodyHandle box = world.createBody({.position = {10.f, 10.f}, .halfExtents = {5.f, 5.f}, .mass = 0.f});
+    world.step(1.f / 60.f);
+    const auto countBodies = [&](const Rectangle2F& area) {
+        size_t found = 0;
+        world.queryArea(area, [&](const BodyHandle body) {
+            EXPECT_EQ(body, box);
+            found++;
+        });
+        return found;
+    };
+
+    EXPECT_EQ(countBodies({0.f, 0.f, 6.f, 6.f}), 1);
+    EXPECT_EQ(countBodies({14.f, 14.f, 10.f, 10.f}), 1);
+    // Bodies touching the area's edges do not overlap it, as with Rectangle2F::intersects()
+    EXPECT_EQ(countBodies({15.f, 0.f, 10.f, 20.f}), 0);
+    EXPECT_EQ(countBodies({0.f, 0.f, 5.f, 20.f}), 0);
+    EXPECT_EQ(countBodies({0.f, 15.f, 20.f, 5.f}), 0);
+    EXPECT_EQ(countBodies({10.f, 10.f, 0.f, 0.f}), 0);
+}
+
+TEST(PhysicsWorldTest, BroadphaseFindsTheSameCollisionsAsTestingEveryPair) {
+    PhysicsWorld world;
+    std::mt19937 random(7);
+    std::uniform_real_distribution position(0.f, 200.f);
+    std::uniform_real_distribution size(1.f, 8.f);
+
+    std::vector<BodyHandle> bodies;
+    const auto createBody = [&] {
+        bodies.push_back(world.createBody({.position = {position(random), position(random)},
+                                           .halfExtents = {size(random), size(random)}}));
+    };
+    for (int body = 0; body < 300; body++) createBody();
+
+    for (int step = 0; step < 5; step++) {
+        // Destroy and recreate bodies so that slots are reused, and move others so that the sort order changes
+        for (int change = 0; change < 30; change++) {
+            const size_t body = random() % bodies.size();
+            world.destroyBody(bodies[body]);
+            bodies.erase(bodies.begin() + static_cast<std::ptrdiff_t>(body));
+            createBody();
+            world.setPosition(bodies[random() % bodies.size()], {position(random), position(random)});
+        }
+
+        std::set<std::pair<uint32_t, uint32_t>> expected;
+        for (size_t first = 0; first < bodies.size(); first++) {
+            for (size_t second = first + 1; second < bodies.size(); second++) {
+                const Rectangle2F a = world.getBounds(bodies[first]);
+                const Rectangle2F b = world.getBounds(bodies[second]);
+                if (a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h) {
+                    expected.emplace(std::min(bodies[first].slot, bodies[second].slot),
+                                     std::max(bodies[first].slot, bodies[second].slot));
+                }
+            }
+        }
+
+        // Without gravity or velocity the bodies do not move until after their collisions are found
+        world.step(1.f / 60.f);
+        std::set<std::pair<uint32_t, uint32_t>> found;
+        for (const Contact& contact: world.getContacts()) {
+            ASSERT_TRUE(world.isValid(contact.first));
+            ASSERT_TRUE(world.isValid(contact.second));
+            found.emplace(std::min(contact.first.slot, contact.second.slot),
+                          std::max(contact.first.slot, contact.second.slot));
+        }
+        EXPECT_EQ(found, expected);
+        EXPECT_FALSE(expected.empty());
+    }
+}
@@ -0,0 +1,100 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include <array>
+#include <gtest/gtest.h>
+
+#include "Quantization.h"
+
+namespace {
+constexpr QuantizedFloat positionCodec = QuantizedFloat::withResolution(-1024.f, 1024.f, 1.f / 64);
+
+/**
+ * A ship's state as stored by each codec, written one after another as a replicated object's fields would be.
+ */
+struct Ship {
+    Vector2F position;
+    float rotation{};
+    bool thrusting{};
+    int32_t health{};
+
+    static constexpr QuantizedVector2F positionCodec{::positionCodec};
+    static constexpr QuantizedAngle rotationCodec{10};
+    static constexpr QuantizedBool thrustingCodec{};
+    static constexpr QuantizedInt<int32_t> healthCodec{0, 100};
+
+    static constexpr uint32_t bits = positionCodec.getBits() + rotationCodec.getBits() + thrustingCodec.getBits()
+        + healthCodec.getBits();
+
+    [[nodiscard]] std::array<uint8_t, (bits + 7) / 8> write() const {
+        std::array<uint8_t, (bits + 7) / 8> bytes{};
+        BitWriter writer(bytes);
+        positionCodec.write(writer, position);
+        rotationCodec.write(writer, rotation);
+        thrustingCodec.write(writer, thrusting);
+        healthCodec.write(writer, health);
+        return bytes;
+    }
+
+    [[nodiscard]] static Ship read(const std::span<const uint8_t> bytes) {
+        Ship ship;
+        BitReader reader(bytes);
+        positionCodec.read(reader, ship.position);
+        rotationCodec.read(reader, ship.rotation);
+        thrustingCodec.read(reader, ship.thrusting);
+        healthCodec.read(reader, ship.health);
+        return ship;
+    }
+};
+}
+
+TEST(BitStreamTest, ValuesOfAnyWidthRoundTrip) {
+    std::array<uint8_t, 16> buffer{};
+    BitWriter writer(buffer);
+    writer.write(5, 3);
+    writer.writeBool(true);
+    writer.write(0xFFFFFFFF, 32);
+    writer.write(0x1234, 13);
+    ASSERT_EQ(writer.getBitCount(), 49);
+    ASSERT_EQ(writer.getByteCount(), 7);
+
+    BitReader reader{std::span<const uint8_t>(buffer).first(writer.getByteCount())};
+    ASSERT_EQ(reader.read(3), 5);
+    ASSERT_TRUE(reader.readBool());
+    ASSERT_EQ(reader.read(32), 0xFFFFFFFF);
+    ASSERT_EQ(reader.read(13), 0x1234 & 0x1FFF);
+    ASSERT_THROW(reader.read(8), std::out_of_range);
+}
+
+TEST(QuantizationTest, CodecsRoundTripWithinResolution) {
+    static_assert(positionCodec.getBits() == 18);
+    // 18 + 18 + 10 + 1 + 7 bits fit in 7 bytes
+    static_assert(Ship::bits == 54);
+
+    const Ship ship{{123.456f, -987.654f}, 4.f, true, 73};
+    const Ship read = Ship::read(ship.write());
+
+    ASSERT_NEAR(read.position.x, ship.position.x, 1.f / 128);
+    ASSERT_NEAR(read.position.y, ship.position.y, 1.f / 128);
+    ASSERT_NEAR(read.rotation, ship.rotation, std::numbers::pi / 1024);
+    ASSERT_EQ(read.thrusting, ship.thrusting);
+    ASSERT_EQ(read.health, ship.health);
+}
+
+TEST(QuantizationTest, OutOfRangeValuesAreClampedAndWrapped) {
+    const Ship ship{{5000.f, -5000.f}, -std::numbers::pi_v<float> / 2, false, 150};
+    const Ship read = Ship::read(ship.write());
+
+    ASSERT_FLOAT_EQ(read.position.x, 1024.f);
+    ASSERT_FLOAT_EQ(read.position.y, -1024.f);
+    ASSERT_NEAR(read.rotation, 3 * std::numbers::pi / 2, std::numbers::pi / 1024);
+    ASSERT_EQ(read.health, 100);
+
+    ASSERT_THROW(QuantizedFloat(1.f, 1.f, 8), std::invalid_argument);
+    ASSERT_THROW(QuantizedAngle(33), std::invalid_argument);
+    ASSERT_THROW(QuantizedInt<int32_t>(5, 4), std::invalid_argument);
+}
@@ -0,0 +1,78 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include <array>
+#include <gtest/gtest.h>
+#include <limits>
+#include <vector>
+
+#include "utils/GameMath.h"
+#include "utils/Random.h"
+
+TEST(RandomTest, GeneratorsWithTheSameSeedProduceTheSameValues) {
+    Random first(Random::deriveSeed(42, 1));
+    Random second(Random::deriveSeed(42, 1));
+    Random otherStream(Random::deriveSeed(42, 2));
+
+    std::vector<int> firstInts(100), secondInts(100);
+    first.fillInts(firstInts, -5, 5);
+    second.fillInts(secondInts, -5, 5);
+    EXPECT_EQ(firstInts, secondInts);
+
+    std::vector<float> firstFloats(101), secondFloats(101);
+    first.fillFloats(firstFloats, 2.f, 3.f);
+    second.fillFloats(secondFloats, 2.f, 3.f);
+    EXPECT_EQ(firstFloats, secondFloats);
+    for (const float value: firstFloats) {
+        EXPECT_GE(value, 2.f);
+        EXPECT_LT(value, 3.f);
+    }
+    EXPECT_NE(first(), otherStream());
+
+    // The full range of int, and a range of one value
+    EXPECT_NO_THROW(first.nextInt(std::numeric_limits<int>::min(), std::numeric_limits<int>::max()));
+    EXPECT_EQ(first.nextInt(7, 7), 7);
+    EXPECT_THROW(first.nextInt(1, 0), std::invalid_argument);
+}
+
+TEST(RandomTest, IntegersCoverTheirWholeRangeEvenly) {
+    Random random(7);
+    std::array<int, 6> counts{};
+    constexpr int draws = 60000;
+    for (int draw = 0; draw < draws; draw++) {
+        counts[random.nextInt(1, 6) - 1]++;
+    }
+    // Each count is within 5 standard deviations of the expected 10000
+    for (const int count: counts) {
+        EXPECT_NEAR(count, draws / 6, 460);
+    }
+
+    // getRandom includes its maximum
+    seedThreadRandom(3);
+    bool sawMax = false;
+    for (int draw = 0; draw < 100 && !sawMax; draw++) {
+        const int value = getRandom(0, 1);
+        ASSERT_TRUE(value == 0 || value == 1);
+        sawMax = value == 1;
+    }
+    EXPECT_TRUE(sawMax);
+}
+
+TEST(RandomTest, FloatsAreAlwaysBelowTheirMaximum) {
+    // The largest unit value, 1 - 2^-24, times the width of [2, 3) rounds up to 3
+    ASSERT_LT(Random::toFloat(std::numeric_limits<uint32_t>::max(), 2.f, 3.f), 3.f);
+    ASSERT_FLOAT_EQ(Random::toFloat(0, 2.f, 3.f), 2.f);
+    ASSERT_LT(Random::toFloat(std::numeric_limits<uint32_t>::max(), -1.f, 0.f), 0.f);
+
+    Random random(11);
+    std::vector<float> values(1001);
+    random.fillFloats(values, 2.f, 3.f);
+    for (const float value: values) {
+        ASSERT_GE(value, 2.f);
+        ASSERT_LT(value, 3.f);
+    }
+}
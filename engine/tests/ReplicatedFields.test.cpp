@@ -0,0 +1,148 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>
+#include <msgpack.hpp>
+
+#include "EmptyNetworkProtocol.h"
+#include "Replicated.h"
+
+namespace {
+struct Unit {
+    std::string name;
+    int32_t health{};
+    bool selected{};
+
+    MSGPACK_DEFINE(name, health, selected);
+};
+
+class ReflectedUnit final : public Replicated<ReflectedUnit> {
+public:
+    explicit ReflectedUnit(NetworkEngine& networkEngine) : Replicated(networkEngine) {}
+
+    static constexpr TypeId typeId{"ReflectedUnit"};
+    REPLICATED_FIELDS(
+        field("name", &ReflectedUnit::name),
+        field("health", &ReflectedUnit::health),
+        field("selected", &ReflectedUnit::selected));
+
+    std::string name;
+    int32_t health{};
+    bool selected{};
+};
+
+struct Ship {
+    Vector2F position;
+    float rotation{};
+    bool thrusting{};
+    int32_t health{};
+
+    MSGPACK_DEFINE(position.x, position.y, rotation, thrusting, health);
+};
+
+struct QuantizedShip {
+    Vector2F position;
+    float rotation{};
+    bool thrusting{};
+    int32_t health{};
+
+    REPLICATED_FIELDS(
+        field("position", &QuantizedShip::position,
+              QuantizedVector2F(QuantizedFloat::withResolution(-1024.f, 1024.f, 1.f / 64))),
+        field("rotation", &QuantizedShip::rotation, QuantizedAngle(10)),
+        field("thrusting", &QuantizedShip::thrusting, QuantizedBool{}),
+        field("health", &QuantizedShip::health, QuantizedInt<int32_t>(0, 100)));
+};
+
+class MixedUnit final : public Replicated<MixedUnit> {
+public:
+    explicit MixedUnit(NetworkEngine& networkEngine) : Replicated(networkEngine) {}
+
+    static constexpr TypeId typeId{"MixedUnit"};
+    REPLICATED_FIELDS(
+        field("name", &MixedUnit::name),
+        field("position", &MixedUnit::position, QuantizedVector2F(QuantizedFloat(0.f, 100.f, 10))),
+        field("selected", &MixedUnit::selected, QuantizedBool{}));
+
+    std::string name;
+    Vector2F position;
+    bool selected{};
+};
+}
+
+TEST(ReplicatedFieldsTest, MsgpackFieldsMatchMsgpackDefine) {
+    using Serializer = FieldSerializer<ReflectedUnit>;
+    static_assert(Serializer::fieldCount == 3 && Serializer::bitPackedFieldCount == 0);
+    static_assert(Serializer::fieldNames[1] == "health");
+
+    NetworkEngine networkEngine(std::make_unique<EmptyNetworkProtocol>());
+    ReflectedUnit reflectedUnit(networkEngine);
+    reflectedUnit.name = "Scout";
+    reflectedUnit.health = -5;
+    reflectedUnit.selected = true;
+
+    msgpack::sbuffer reflectedBuffer;
+    msgpack::pack(reflectedBuffer, reflectedUnit);
+    msgpack::sbuffer buffer;
+    msgpack::pack(buffer, Unit{"Scout", -5, true});
+    ASSERT_EQ(std::string_view(reflectedBuffer.data(), reflectedBuffer.size()),
+              std::string_view(buffer.data(), buffer.size()));
+
+    msgpack::zone zone;
+    const msgpack::object object(reflectedUnit, zone);
+    const auto unit = object.as<Unit>();
+    ASSERT_EQ(unit.name, "Scout");
+    ASSERT_EQ(unit.health, -5);
+}
+
+TEST(ReplicatedFieldsTest, DiffAndHashUseReplicatedValues) {
+    NetworkEngine networkEngine(std::make_unique<EmptyNetworkProtocol>());
+    MixedUnit a(networkEngine);
+    MixedUnit b(networkEngine);
+    a.name = b.name = "Tank";
+    a.position = {50.f, 50.f};
+    // Less than the 0.1 unit resolution of the position codec away, so replicated identically
+    b.position = {50.01f, 50.f};
+
+    ASSERT_EQ(a.getChangedFields(b), 0);
+    ASSERT_EQ(a.getReplicationHash(), b.getReplicationHash());
+
+    b.name = "Jeep";
+    b.selected = true;
+    ASSERT_EQ(a.getChangedFields(b), 0b101);
+    ASSERT_NE(a.getReplicationHash(), b.getReplicationHash());
+
+    msgpack::sbuffer buffer;
+    msgpack::pack(buffer, b);
+    a.msgpack_unpack(msgpack::unpack(buffer.data(), buffer.size()).get());
+    ASSERT_EQ(a.getChangedFields(b), 0);
+}
+
+TEST(ReplicatedFieldsTest, BitPackedFieldsArePackedIntoOneBin) {
+    const Ship ship{{123.456f, -987.654f}, 4.f, true, 73};
+    const QuantizedShip quantizedShip{ship.position, ship.rotation, ship.thrusting, ship.health};
+
+    // The bit-packed fields read back as the msgpack fields do, to within each codec's resolution
+    msgpack::sbuffer shipBuffer;
+    msgpack::pack(shipBuffer, ship);
+    msgpack::sbuffer quantizedBuffer;
+    msgpack::pack(quantizedBuffer, quantizedShip);
+    const auto unpacked = msgpack::unpack(quantizedBuffer.data(), quantizedBuffer.size())->as<QuantizedShip>();
+    ASSERT_NEAR(unpacked.position.x, ship.position.x, 1.f / 128);
+    ASSERT_NEAR(unpacked.position.y, ship.position.y, 1.f / 128);
+    ASSERT_NEAR(unpacked.rotation, ship.rotation, std::numbers::pi / 1024);
+    ASSERT_EQ(unpacked.thrusting, ship.thrusting);
+    ASSERT_EQ(unpacked.health, ship.health);
+
+    // 18 + 18 + 10 + 1 + 7 bits fit in 7 bytes, plus the 2 byte bin header
+    ASSERT_EQ(quantizedBuffer.size(), 9);
+    ASSERT_LT(quantizedBuffer.size(), shipBuffer.size());
+
+    msgpack::sbuffer wrongSize;
+    msgpack::pack(wrongSize, std::vector<uint8_t>{1, 2, 3});
+    ASSERT_THROW(msgpack::unpack(wrongSize.data(), wrongSize.size())->as<QuantizedShip>(), msgpack::type_error);
+}
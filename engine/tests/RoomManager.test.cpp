@@ -0,0 +1,271 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <msgpack.hpp>
+
+#include "LoopbackNetworkProtocol.h"
+#include "Replicated.h"
+#include "RoomManager.h"
+
+namespace {
+class Marker final : public Replicated<Marker> {
+public:
+    explicit Marker(NetworkEngine& networkEngine, const int room)
+        : Replicated(networkEngine)
+        , room(room) {
+    }
+
+    static constexpr TypeId typeId{"Marker"};
+    MSGPACK_DEFINE(room);
+
+    int room;
+};
+
+// Gets the room of the only marker in the last full state snapshot sent to a client
+int getLastSnapshotRoom(LoopbackNetworkProtocol& loopback, const ClientId clientId) {
+    loopback.advanceTime(0.0);
+    std::optional<Message> last;
+    while (auto message = loopback.clientRecieve(clientId)) {
+        last = std::move(message);
+    }
+    if (!last) {
+        return -1;
+    }
+    const msgpack::object_handle handle = msgpack::unpack(reinterpret_cast<const char*>(last->body.data()),
+                                                          last->body.size());
+    const msgpack::object& markers = handle.get().via.map.ptr[0].val;
+    return markers.via.map.ptr[0].val.via.array.ptr[0].as<int>();
+}
+
+// Transport whose messages are queued by the test, and which keeps them when a client is disconnected
+class QueueTransport final : public INetworkProtocol {
+public:
+    std::optional<Message> recieve() override {
+        if (messages.empty()) {
+            return std::nullopt;
+        }
+        Message message = std::move(messages.front());
+        messages.erase(messages.begin());
+        return message;
+    }
+
+    void send(Message) override {}
+    void disconnect(ClientId) override {}
+
+    std::vector<Message> messages;
+};
+
+class RoomManagerTest : public testing::Test {
+protected:
+    void SetUp() override {
+        auto protocol = std::make_unique<LoopbackNetworkProtocol>();
+        loopback = protocol.get();
+        rooms = std::make_unique<RoomManager>(std::move(protocol));
+    }
+
+    LoopbackNetworkProtocol* loopback{nullptr};
+    std::unique_ptr<RoomManager> rooms;
+};
+}
+
+TEST_F(RoomManagerTest, ClientsOnlyReceiveTheirRoomsObjects) {
+    Room& lobby = rooms->createRoom();
+    Room& match = rooms->createRoom();
+    rooms->setDefaultRoom(lobby.getId());
+    Marker lobbyMarker(lobby.getNetworkEngine(), 0);
+    Marker matchMarker(match.getNetworkEngine(), 1);
+
+    int matchUpdates = 0;
+    match.setUpdateHandler([&](float) { matchUpdates++; });
+
+    const ClientId player0 = loopback->connectClient();
+    const ClientId player1 = loopback->connectClient();
+    loopback->advanceTime(0.0);
+    rooms->tick(0.016f);
+    ASSERT_EQ(lobby.getNetworkEngine().getPlayers().size(), 2);
+    ASSERT_EQ(getLastSnapshotRoom(*loopback, player1), 0);
+
+    rooms->assignClient(player1, match.getId());
+    rooms->tick(0.016f);
+    ASSERT_EQ(lobby.getNetworkEngine().getPlayers(), std::vector<ClientId>{player0});
+    ASSERT_EQ(match.getNetworkEngine().getPlayers(), std::vector<ClientId>{player1});
+    ASSERT_EQ(rooms->getClientRoom(player1), &match);
+    ASSERT_EQ(getLastSnapshotRoom(*loopback, player0), 0);
+    ASSERT_EQ(getLastSnapshotRoom(*loopback, player1), 1);
+    ASSERT_EQ(matchUpdates, 2);
+}
+
+TEST_F(RoomManagerTest, DestroyingARoomReturnsItsClientsToTheDefaultRoom) {
+    Room& lobby = rooms->createRoom();
+    rooms->setDefaultRoom(lobby.getId());
+    Room& match = rooms->createRoom();
+    const RoomId matchId = match.getId();
+
+    const ClientId player = loopback->connectClient();
+    loopback->advanceTime(0.0);
+    rooms->tick(0.016f);
+    rooms->assignClient(player, matchId);
+
+    // Rooms destroyed by their own update are destroyed once every room has ticked
+    match.setUpdateHandler([&](float) { rooms->destroyRoom(matchId); });
+    rooms->tick(0.016f);
+    ASSERT_EQ(rooms->findRoom(matchId), nullptr);
+    ASSERT_EQ(rooms->getRoomCount(), 1);
+
+    rooms->tick(0.016f);
+    ASSERT_EQ(lobby.getNetworkEngine().getPlayers(), std::vector<ClientId>{player});
+    ASSERT_THROW(rooms->assignClient(player, matchId), std::invalid_argument);
+}
+
+TEST(NetworkRouterTest, ClientsDisconnectedByARoomDoNotRejoin) {
+    auto newTransport = std::make_unique<QueueTransport>();
+    QueueTransport& transport = *newTransport;
+    NetworkRouter router(std::move(newTransport));
+    NetworkEngine room(router.createEndpoint(0));
+    router.setDefaultRoom(0);
+
+    transport.messages.push_back({0, {}, MessageType::Connect});
+    transport.messages.push_back({1, {}, MessageType::Connect});
+    router.route();
+    room.update();
+    ASSERT_TRUE(room.hasPlayer(0));
+    ASSERT_TRUE(room.hasPlayer(1));
+
+    // Client 0's data has been routed to the room and client 1's is still in the transport when they are kicked
+    transport.messages.push_back({0, {1}});
+    router.route();
+    transport.messages.push_back({1, {1}});
+    room.disconnectPlayer(0);
+    room.disconnectPlayer(1);
+
+    router.route();
+    room.update();
+    ASSERT_TRUE(room.getPlayers().empty());
+    ASSERT_FALSE(router.getClientRoom(0).has_value());
+    ASSERT_FALSE(router.getClientRoom(1).has_value());
+
+    // A transport reusing a disconnected client's ID connects the new client
+    transport.messages.push_back({2, {}, MessageType::Connect});
+    router.route();
+    room.update();
+    transport.messages.push_back({2, {1}});
+    transport.messages.push_back({2, {}, MessageType::Connect});
+    room.disconnectPlayer(2);
+    router.route();
+    room.update();
+    ASSERT_EQ(room.getPlayers(), std::vector<ClientId>{2});
+}
+
+TEST_F(RoomManagerTest, RoomsTickOnWorkerThreadsAndCountMissedDeadlines) {
+    rooms->setWorkerCount(2);
+    Room& lobby = rooms->createRoom();
+    rooms->setDefaultRoom(lobby.getId());
+    Room& slowRoom = rooms->createRoom();
+    slowRoom.setUpdateHandler([](float) { std::this_thread::sleep_for(std::chrono::milliseconds(5)); });
+    std::vector<Room*> matches;
+    std::atomic<int> updates{0};
+    for (int index = 0; index < 8; index++) {
+        matches.push_back(&rooms->createRoom());
+        matches.back()->setUpdateHandler([&](float) { updates++; });
+    }
+
+    const ClientId player = loopback->connectClient();
+    loopback->advanceTime(0.0);
+    rooms->tick(1.0f);
+    rooms->assignClient(player, matches.back()->getId());
+    // The slow room cannot finish within a 1ms tick
+    rooms->tick(0.001f);
+    ASSERT_EQ(updates.load(), 16);
+    ASSERT_EQ(matches.back()->getNetworkEngine().getPlayers(), std::vector<ClientId>{player});
+    ASSERT_EQ(slowRoom.getMissedDeadlineCount(), 1);
+    ASSERT_EQ(slowRoom.getCurrentTick(), 2);
+    ASSERT_TRUE(slowRoom.getLastTickStats().missedDeadline);
+    ASSERT_GE(slowRoom.getLastTickStats().duration, std::chrono::milliseconds(5));
+}
+
+TEST_F(RoomManagerTest, PipelinedReplicationOnlyBuildsSnapshotsWhileWaitingForThePool) {
+    constexpr size_t workerCount = 2;
+    rooms->setWorkerCount(workerCount);
+    Room& lobby = rooms->createRoom();
+    rooms->setDefaultRoom(lobby.getId());
+
+    // Room ticks may only run on the pool's workers and the thread calling tick(), never on a room's replication
+    // thread while it waits for its snapshots to be built on the pool
+    std::mutex tickThreadsMutex;
+    std::set<std::thread::id> tickThreads;
+    std::vector<Room*> matches;
+    std::vector<std::unique_ptr<Marker>> markers;
+    for (int index = 0; index < 6; index++) {
+        Room& match = rooms->createRoom();
+        match.getNetworkEngine().setPipelinedReplication(true);
+        match.setUpdateHandler([&](float) {
+            {
+                std::lock_guard lock(tickThreadsMutex);
+                tickThreads.insert(std::this_thread::get_id());
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        });
+        markers.push_back(std::make_unique<Marker>(match.getNetworkEngine(), index));
+        matches.push_back(&match);
+    }
+
+    std::vector<ClientId> players;
+    for (int index = 0; index < 24; index++) {
+        players.push_back(loopback->connectClient());
+    }
+    loopback->advanceTime(0.0);
+    rooms->tick(0.016f);
+    for (size_t index = 0; index < players.size(); index++) {
+        rooms->assignClient(players[index], matches[index % matches.size()]->getId());
+    }
+    rooms->tick(0.016f);
+    // Several players with views in each room, so each room's snapshots are built by a parallelFor on the pool
+    for (size_t index = 0; index < players.size(); index++) {
+        matches[index % matches.size()]->getNetworkEngine().setPlayerView(players[index], {-50.f, -50.f, 100.f, 100.f});
+    }
+
+    for (int tick = 0; tick < 50; tick++) {
+        rooms->tick(0.016f);
+    }
+    for (Room* match: matches) {
+        match->getNetworkEngine().finishReplication();
+        ASSERT_EQ(match->getCurrentTick(), 52);
+    }
+    ASSERT_LE(tickThreads.size(), workerCount + 1);
+}
+
+TEST_F(RoomManagerTest, TicksDoNotWaitForOtherWorkOnThePool) {
+    rooms->setWorkerCount(1);
+    Room& lobby = rooms->createRoom();
+    rooms->setDefaultRoom(lobby.getId());
+    std::atomic<int> updates{0};
+    lobby.setUpdateHandler([&](float) { updates++; });
+
+    // Work on the pool that is not part of the tick, such as a room's snapshots still building in the background
+    std::atomic<bool> released{false};
+    std::atomic<bool> finished{false};
+    rooms->getWorkerPool()->submit([&] {
+        const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (!released && std::chrono::steady_clock::now() < timeout) {
+            std::this_thread::yield();
+        }
+        finished = true;
+    });
+
+    rooms->tick(0.016f);
+    ASSERT_EQ(updates.load(), 1);
+    ASSERT_FALSE(finished.load());
+    released = true;
+    rooms->getWorkerPool()->wait();
+}
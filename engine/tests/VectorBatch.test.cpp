@@ -0,0 +1,98 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "utils/VectorBatch.h"
+
+// Every length up to 70 covers empty arrays, arrays shorter than a vector, remainders and masks over several words
+
+TEST(VectorBatchTest, KernelsMatchTheVector2FOperators) {
+    std::mt19937 random(3);
+    std::uniform_real_distribution value(-100.f, 100.f);
+    for (size_t count = 0; count <= 70; count++) {
+        std::vector<float> positionsX(count), positionsY(count), velocitiesX(count), velocitiesY(count);
+        std::vector<Vector2F> positions(count), velocities(count);
+        for (size_t index = 0; index < count; index++) {
+            positions[index] = {value(random), value(random)};
+            velocities[index] = {value(random), value(random)};
+            positionsX[index] = positions[index].x;
+            positionsY[index] = positions[index].y;
+            velocitiesX[index] = velocities[index].x;
+            velocitiesY[index] = velocities[index].y;
+        }
+
+        integratePositions(positionsX, positionsY, velocitiesX, velocitiesY, 0.25f);
+        scaleValues(velocitiesX, 0.5f);
+        addScaledValues(velocitiesY, positionsY, 2.f);
+        const Vector2F point(10.f, -20.f);
+        std::vector<float> distancesSquared(count);
+        getDistancesSquared(positionsX, positionsY, point, distancesSquared);
+
+        for (size_t index = 0; index < count; index++) {
+            positions[index] += velocities[index] * 0.25f;
+            EXPECT_FLOAT_EQ(positionsX[index], positions[index].x);
+            EXPECT_FLOAT_EQ(positionsY[index], positions[index].y);
+            EXPECT_FLOAT_EQ(velocitiesX[index], velocities[index].x * 0.5f);
+            EXPECT_FLOAT_EQ(velocitiesY[index], velocities[index].y + positions[index].y * 2.f);
+            const Vector2F delta = positions[index] - point;
+            EXPECT_FLOAT_EQ(distancesSquared[index], delta.dot(delta));
+        }
+    }
+
+    // Positions with a time scale of 0 stay where they are
+    std::vector<float> positionsX(19, 1.f), positionsY(19, 2.f), timeScales(19);
+    const std::vector<float> velocitiesX(19, 3.f), velocitiesY(19, -4.f);
+    for (size_t index = 0; index < timeScales.size(); index++) {
+        timeScales[index] = static_cast<float>(index % 3) * 0.5f;
+    }
+    integratePositions(positionsX, positionsY, velocitiesX, velocitiesY, timeScales, 2.f);
+    for (size_t index = 0; index < timeScales.size(); index++) {
+        EXPECT_FLOAT_EQ(positionsX[index], 1.f + 6.f * timeScales[index]);
+        EXPECT_FLOAT_EQ(positionsY[index], 2.f - 8.f * timeScales[index]);
+    }
+
+    std::vector<float> values(4), addends(5);
+    EXPECT_THROW(addScaledValues(values, addends, 1.f), std::invalid_argument);
+}
+
+TEST(VectorBatchTest, OverlapMaskSetsTheBitOfEachOverlappingBox) {
+    std::mt19937 random(5);
+    std::uniform_real_distribution position(0.f, 100.f);
+    std::uniform_real_distribution size(0.f, 10.f);
+    const Rectangle2F area(30.f, 40.f, 25.f, 20.f);
+    for (size_t count = 0; count <= 70; count++) {
+        std::vector<float> minX(count), minY(count), maxX(count), maxY(count);
+        for (size_t index = 0; index < count; index++) {
+            minX[index] = position(random);
+            minY[index] = position(random);
+            maxX[index] = minX[index] + size(random);
+            maxY[index] = minY[index] + size(random);
+        }
+        // A box touching the area's edge counts as overlapping it
+        if (count > 0) {
+            minX[count - 1] = area.x + area.w;
+            maxX[count - 1] = minX[count - 1] + 1.f;
+            minY[count - 1] = area.y;
+            maxY[count - 1] = area.y + 1.f;
+        }
+
+        std::vector<uint64_t> mask(2, ~0ull);
+        getOverlapMask(minX, minY, maxX, maxY, area, mask);
+        // Bits after the last box are cleared up to the end of its word, later words are left alone
+        for (size_t index = 0; index < (count + 63) / 64 * 64; index++) {
+            const bool expected = index < count && minX[index] <= area.x + area.w && maxX[index] >= area.x
+                && minY[index] <= area.y + area.h && maxY[index] >= area.y;
+            EXPECT_EQ((mask[index / 64] >> (index % 64)) & 1, expected) << count << " boxes, box " << index;
+        }
+        if (count <= 64) {
+            EXPECT_EQ(mask[1], ~0ull);
+        }
+    }
+}
@@ -0,0 +1,77 @@
+// This file is part of multiplayer-game_server <https://github.com/harryjduke/multiplayer-game_server>.
+// Copyright (c) 2025 Harry Duke <harryjduke@gmail.com>
+//
+// This program is distributed under the terms of the GNU General Public License version 2.
+// You should have received a copy of the GNU General Public License along with this program.
+// If not, see <https://github.com/harryjduke/multiplayer-game_server/blob/main/LICENSE> or <https://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <atomic>
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+#include "WorkStealingPool.h"
+
+TEST(WorkStealingPoolTest, RunsEveryTaskIncludingTasksSubmittedByTasks) {
+    WorkStealingPool pool(3);
+    std::atomic<int> runCount{0};
+    for (int round = 0; round < 10; round++) {
+        for (int task = 0; task < 20; task++) {
+            pool.submit([&] {
+                runCount++;
+                pool.submit([&] { runCount++; });
+            });
+        }
+        pool.wait();
+        ASSERT_EQ(runCount.load(), (round + 1) * 40);
+    }
+}
+
+TEST(WorkStealingPoolTest, WaitRethrowsTheFirstExceptionOnceEveryTaskHasFinished) {
+    WorkStealingPool pool(2);
+    std::atomic<int> runCount{0};
+    for (int task = 0; task < 10; task++) {
+        pool.submit([&, task] {
+            runCount++;
+            if (task == 3) {
+                throw std::runtime_error("Task failed");
+            }
+        });
+    }
+    ASSERT_THROW(pool.wait(), std::runtime_error);
+    ASSERT_EQ(runCount.load(), 10);
+
+    // The exception is only rethrown once
+    pool.submit([&] { runCount++; });
+    pool.wait();
+    ASSERT_EQ(runCount.load(), 11);
+}
+
+TEST(WorkStealingPoolTest, ParallelForOnlyRunsItsOwnChunksWhileWaiting) {
+    // Without workers every task runs on the calling thread, so which tasks run while waiting is deterministic
+    WorkStealingPool pool(0);
+    bool unrelatedRan = false;
+    pool.submit([&] { unrelatedRan = true; });
+    size_t chunkCount = 0;
+    pool.parallelFor(8, 1, [&](size_t, size_t) {
+        EXPECT_FALSE(unrelatedRan);
+        chunkCount++;
+    });
+    EXPECT_EQ(chunkCount, 8);
+    EXPECT_FALSE(unrelatedRan);
+    pool.wait();
+    EXPECT_TRUE(unrelatedRan);
+
+    // Tasks splitting their work up, as rooms' ticks do, never run one another while waiting for their chunks
+    int running = 0;
+    int mostRunning = 0;
+    for (int task = 0; task < 4; task++) {
+        pool.submit([&] {
+            mostRunning = std::max(mostRunning, ++running);
+            pool.parallelFor(8, 1, [](size_t, size_t) {});
+            running--;
+        });
+    }
+    pool.wait();
+    EXPECT_EQ(mostRunning, 1);
+}